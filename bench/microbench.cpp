@@ -0,0 +1,296 @@
+/* Microbenchmarks for the helpers elysia-welcome runs per access point,
+ * per NM event or per theme switch.
+ *
+ *   make bench && bench/microbench [FILTER]
+ *
+ * Each case runs for about BENCH_TARGET_MS after a warm-up and prints
+ * ns/op and heap allocations/op (counted by wrapping malloc, calloc and
+ * realloc in this binary). Inputs are synthetic and grow in size, so the
+ * scaling is visible: SSIDs up to the 32-byte limit, and saved profile
+ * lists up to 1000 entries.
+ *
+ * The NM cases that need objects only libnm can create (access points,
+ * devices) use a real NMClient. For repeatable sizes, start tools/mock-nm
+ * (e.g. --aps 500 --saved 50 --ethernet) on a private bus the way
+ * tools/run-with-mock-nm.sh does and point DBUS_SYSTEM_BUS_ADDRESS at it.
+ * Without a reachable NetworkManager those cases are skipped. The CSS
+ * cases need a display and are skipped without one.
+ */
+
+#include <gtk/gtk.h>
+#include <NetworkManager.h>
+#include <cstring>
+#include "../translations.h"
+#include "../wifi_helpers.h"
+#include "../theme_css.h"
+
+#define BENCH_TARGET_MS 200
+#define BENCH_WARMUP_MS 20
+
+/* ---------- Allocation counting ---------- */
+
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t n, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+
+static gboolean bench_counting = FALSE;
+static guint64 bench_allocations = 0;
+
+void *malloc(size_t size) {
+    if (bench_counting) bench_allocations++;
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t n, size_t size) {
+    if (bench_counting) bench_allocations++;
+    return __libc_calloc(n, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+    if (bench_counting && !ptr) bench_allocations++;
+    return __libc_realloc(ptr, size);
+}
+}
+
+/* ---------- Harness ---------- */
+
+typedef void (*BenchFunc)(gpointer data);
+
+static const char *bench_filter = NULL;
+
+static guint64 bench_loop(BenchFunc func, gpointer data, guint64 iterations) {
+    for (guint64 i = 0; i < iterations; i++) func(data);
+    return iterations;
+}
+
+/* Run func until BENCH_TARGET_MS have passed, doubling the batch size so
+   the clock is read rarely, then print ns/op and allocations/op */
+static void bench_run(const char *name, guint size, BenchFunc func, gpointer data) {
+    if (bench_filter && !strstr(name, bench_filter)) return;
+
+    gint64 start = g_get_monotonic_time();
+    while (g_get_monotonic_time() - start < BENCH_WARMUP_MS * 1000) bench_loop(func, data, 64);
+
+    guint64 done = 0, batch = 16;
+    bench_allocations = 0;
+    bench_counting = TRUE;
+    start = g_get_monotonic_time();
+    gint64 elapsed_us;
+    do {
+        done += bench_loop(func, data, batch);
+        batch *= 2;
+        elapsed_us = g_get_monotonic_time() - start;
+    } while (elapsed_us < BENCH_TARGET_MS * 1000);
+    bench_counting = FALSE;
+
+    g_print("%-34s %6u  %12.1f ns/op  %8.2f allocs/op\n", name, size,
+            elapsed_us * 1000.0 / done, (double) bench_allocations / done);
+}
+
+static void bench_section(const char *title) {
+    if (!bench_filter) g_print("\n%s\n", title);
+}
+
+/* ---------- Translations ---------- */
+
+static void bench_get_translations(gpointer data) {
+    (void)data;
+    const Translations *tr = get_translations();
+    g_assert(tr != NULL);
+}
+
+static void bench_translations(void) {
+    bench_section("translations");
+    const char *langs[] = { "en_US.UTF-8", "zh_CN.UTF-8" };
+    for (guint i = 0; i < G_N_ELEMENTS(langs); i++) {
+        g_setenv("LANG", langs[i], TRUE);
+        gchar *name = g_strdup_printf("get_translations %.5s", langs[i]);
+        bench_run(name, 1, bench_get_translations, NULL);
+        g_free(name);
+    }
+}
+
+/* ---------- SSIDs ---------- */
+
+typedef struct {
+    GBytes *bytes;
+    gchar  *a;
+    gchar  *b;
+} SsidCase;
+
+static void bench_ssid_from_bytes(gpointer data) {
+    g_free(ssid_from_bytes(((SsidCase*) data)->bytes));
+}
+
+static void bench_ssid_equal(gpointer data) {
+    SsidCase *c = (SsidCase*) data;
+    volatile gboolean equal = ssid_equal(c->a, c->b);
+    (void)equal;
+}
+
+static void bench_ssids(void) {
+    bench_section("ssid (size = SSID bytes)");
+    const guint lengths[] = { 1, 8, 16, 32 };
+    for (guint i = 0; i < G_N_ELEMENTS(lengths); i++) {
+        gchar *ssid = g_strnfill(lengths[i], 'x');
+        SsidCase c = { g_bytes_new(ssid, lengths[i]), g_strdup(ssid), g_strdup(ssid) };
+        c.b[lengths[i] - 1] = 'y';  // differs in the last byte: worst case
+        bench_run("ssid_from_bytes", lengths[i], bench_ssid_from_bytes, &c);
+        bench_run("ssid_equal (mismatch at end)", lengths[i], bench_ssid_equal, &c);
+        g_bytes_unref(c.bytes);
+        g_free(c.a);
+        g_free(c.b);
+        g_free(ssid);
+    }
+}
+
+/* ---------- Saved profiles ---------- */
+
+typedef struct {
+    GPtrArray *connections;
+    gchar     *ssid;
+} ProfileCase;
+
+static NMConnection* make_wifi_profile(const gchar *ssid) {
+    NMConnection *c = nm_simple_connection_new();
+    NMSetting *s_con = nm_setting_connection_new();
+    g_object_set(s_con, NM_SETTING_CONNECTION_ID, ssid, NM_SETTING_CONNECTION_TYPE, NM_SETTING_WIRELESS_SETTING_NAME, NULL);
+    nm_connection_add_setting(c, s_con);
+
+    NMSetting *s_wifi = nm_setting_wireless_new();
+    GBytes *bytes = g_bytes_new(ssid, strlen(ssid));
+    g_object_set(s_wifi, NM_SETTING_WIRELESS_SSID, bytes, NULL);
+    g_bytes_unref(bytes);
+    nm_connection_add_setting(c, s_wifi);
+    return c;
+}
+
+static void bench_find_connection(gpointer data) {
+    ProfileCase *c = (ProfileCase*) data;
+    volatile NMConnection *found = find_connection_for_ssid(c->connections, c->ssid);
+    (void)found;
+}
+
+static void bench_profiles(void) {
+    bench_section("saved profiles (size = profiles, SSID not found: full scan)");
+    const guint sizes[] = { 1, 10, 100, 1000 };
+    for (guint i = 0; i < G_N_ELEMENTS(sizes); i++) {
+        ProfileCase c = { g_ptr_array_new_with_free_func(g_object_unref), g_strdup("not-saved") };
+        for (guint j = 0; j < sizes[i]; j++) {
+            gchar *ssid = g_strdup_printf("profile-%04u", j);
+            g_ptr_array_add(c.connections, make_wifi_profile(ssid));
+            g_free(ssid);
+        }
+        bench_run("find_connection_for_ssid", sizes[i], bench_find_connection, &c);
+        g_ptr_array_unref(c.connections);
+        g_free(c.ssid);
+    }
+}
+
+/* ---------- Live NMClient ---------- */
+
+typedef struct {
+    NMClient        *client;
+    const GPtrArray *aps;
+    gchar           *ssid;
+} ClientCase;
+
+static void bench_ap_is_secured_all(gpointer data) {
+    const GPtrArray *aps = ((ClientCase*) data)->aps;
+    volatile guint secured = 0;
+    for (guint i = 0; i < aps->len; i++) secured += ap_is_secured(NM_ACCESS_POINT(g_ptr_array_index(aps, i)));
+}
+
+static void bench_ssids_of_all_aps(gpointer data) {
+    const GPtrArray *aps = ((ClientCase*) data)->aps;
+    for (guint i = 0; i < aps->len; i++) {
+        g_free(ssid_from_bytes(nm_access_point_get_ssid(NM_ACCESS_POINT(g_ptr_array_index(aps, i)))));
+    }
+}
+
+static void bench_find_saved(gpointer data) {
+    ClientCase *c = (ClientCase*) data;
+    NMRemoteConnection *found = find_saved_connection_for_ssid(c->client, c->ssid);
+    if (found) g_object_unref(found);
+}
+
+static void bench_check_ethernet(gpointer data) {
+    volatile gboolean up = check_ethernet_connection(((ClientCase*) data)->client);
+    (void)up;
+}
+
+static void bench_client(void) {
+    GError *error = NULL;
+    NMClient *client = nm_client_new(NULL, &error);
+    if (!client || !nm_client_get_nm_running(client)) {
+        g_print("\nNMClient: skipped (%s)\n", error ? error->message : "NetworkManager not running");
+        g_clear_error(&error);
+        g_clear_object(&client);
+        return;
+    }
+
+    ClientCase c = { client, NULL, g_strdup("not-saved") };
+    const GPtrArray *devices = nm_client_get_devices(client);
+    for (guint i = 0; devices && i < devices->len; i++) {
+        NMDevice *dev = NM_DEVICE(g_ptr_array_index(devices, i));
+        if (NM_IS_DEVICE_WIFI(dev)) {
+            c.aps = nm_device_wifi_get_access_points(NM_DEVICE_WIFI(dev));
+            break;
+        }
+    }
+    guint n_connections = nm_client_get_connections(client)->len;
+
+    bench_section("NMClient (size = APs on the first Wi-Fi device, or profiles, or devices)");
+    if (c.aps) {
+        bench_run("ap_is_secured, every AP", c.aps->len, bench_ap_is_secured_all, &c);
+        bench_run("ssid_from_bytes, every AP", c.aps->len, bench_ssids_of_all_aps, &c);
+    }
+    bench_run("find_saved_connection_for_ssid", n_connections, bench_find_saved, &c);
+    bench_run("check_ethernet_connection", devices ? devices->len : 0, bench_check_ethernet, &c);
+
+    g_free(c.ssid);
+    g_object_unref(client);
+}
+
+/* ---------- CSS ---------- */
+
+typedef struct {
+    GtkCssProvider *provider;
+    const char     *css;
+} CssCase;
+
+static void bench_css_load(gpointer data) {
+    CssCase *c = (CssCase*) data;
+    gtk_css_provider_load_from_string(c->provider, c->css);
+}
+
+static void bench_css(void) {
+    if (!gtk_init_check()) {
+        g_print("\nCSS: skipped (no display)\n");
+        return;
+    }
+    bench_section("CSS (size = bytes; parse only, no provider installed)");
+    CssCase cases[] = {
+        { gtk_css_provider_new(), theme_css },
+    };
+    const char *names[] = { "css load theme" };
+    for (guint i = 0; i < G_N_ELEMENTS(cases); i++) {
+        bench_run(names[i], (guint) strlen(cases[i].css), bench_css_load, &cases[i]);
+        g_object_unref(cases[i].provider);
+    }
+}
+
+/* ---------- main ---------- */
+
+int main(int argc, char *argv[]) {
+    bench_filter = argc > 1 ? argv[1] : NULL;
+    g_print("%-34s %6s  %18s  %18s\n", "case", "size", "time", "heap");
+
+    bench_translations();
+    bench_ssids();
+    bench_profiles();
+    bench_client();
+    bench_css();
+    return 0;
+}
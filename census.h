@@ -0,0 +1,89 @@
+#ifndef CENSUS_H
+#define CENSUS_H
+
+#include <glib-object.h>
+#include "logging.h"
+
+// GObject lifetime census, enabled with WELCOME_CENSUS=1 (or --census-rescans).
+//
+// Objects handed to census_track() get a weak ref and are counted per GType
+// until they finalize. census_checkpoint() logs the per-type deltas since
+// the previous checkpoint, so objects that accumulate across page changes
+// or list rebuilds show up as a steadily positive delta.
+
+static gboolean    census_enabled = FALSE;
+static GHashTable *census_live = NULL;      // GType -> live count
+static GHashTable *census_previous = NULL;  // counts at the last checkpoint
+
+static inline void census_init(gboolean force) {
+    const gchar *env = g_getenv("WELCOME_CENSUS");
+    census_enabled = force || (env && *env && g_strcmp0(env, "0") != 0);
+    if (!census_enabled) return;
+    census_live = g_hash_table_new(NULL, NULL);
+    census_previous = g_hash_table_new(NULL, NULL);
+}
+
+static inline void census_adjust(GType type, gint delta) {
+    guint count = GPOINTER_TO_UINT(g_hash_table_lookup(census_live, GSIZE_TO_POINTER(type)));
+    g_hash_table_insert(census_live, GSIZE_TO_POINTER(type), GUINT_TO_POINTER(count + delta));
+}
+
+static inline void census_on_finalized(gpointer data, GObject *where_the_object_was) {
+    (void)where_the_object_was;
+    census_adjust((GType) GPOINTER_TO_SIZE(data), -1);
+}
+
+// Count object until it finalizes; tracking the same object twice is a no-op
+static inline void census_track(gpointer object) {
+    if (!census_enabled || !object) return;
+    if (g_object_get_data(G_OBJECT(object), "welcome-census")) return;
+    g_object_set_data(G_OBJECT(object), "welcome-census", GINT_TO_POINTER(1));
+
+    GType type = G_OBJECT_TYPE(object);
+    census_adjust(type, +1);
+    g_object_weak_ref(G_OBJECT(object), census_on_finalized, GSIZE_TO_POINTER(type));
+}
+
+static inline guint census_count(GType type) {
+    if (!census_enabled) return 0;
+    return GPOINTER_TO_UINT(g_hash_table_lookup(census_live, GSIZE_TO_POINTER(type)));
+}
+
+// Copy of the current counts, for comparing across a longer run
+static inline GHashTable* census_snapshot(void) {
+    GHashTable *copy = g_hash_table_new(NULL, NULL);
+    GHashTableIter iter;
+    gpointer type, count;
+    g_hash_table_iter_init(&iter, census_live);
+    while (g_hash_table_iter_next(&iter, &type, &count)) g_hash_table_insert(copy, type, count);
+    return copy;
+}
+
+// Log "type +delta (live)" for every type that changed since before;
+// returns the number of types that grew
+static inline guint census_diff(GHashTable *before, const char *label, GLogLevelFlags level) {
+    guint grown = 0;
+    GString *line = g_string_new(NULL);
+    GHashTableIter iter;
+    gpointer type, count;
+    g_hash_table_iter_init(&iter, census_live);
+    while (g_hash_table_iter_next(&iter, &type, &count)) {
+        gint delta = (gint) GPOINTER_TO_UINT(count) - (gint) GPOINTER_TO_UINT(g_hash_table_lookup(before, type));
+        if (delta == 0) continue;
+        if (delta > 0) grown++;
+        g_string_append_printf(line, " %s %+d (%u)", g_type_name((GType) GPOINTER_TO_SIZE(type)),
+                               delta, GPOINTER_TO_UINT(count));
+    }
+    if (line->len > 0) log_emit(LOG_PERF, level, "census %s:%s", label, line->str);
+    g_string_free(line, TRUE);
+    return grown;
+}
+
+static inline void census_checkpoint(const char *label) {
+    if (!census_enabled) return;
+    census_diff(census_previous, label, G_LOG_LEVEL_MESSAGE);
+    g_hash_table_unref(census_previous);
+    census_previous = census_snapshot();
+}
+
+#endif // CENSUS_H
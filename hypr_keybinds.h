@@ -0,0 +1,420 @@
+#ifndef HYPR_KEYBINDS_H
+#define HYPR_KEYBINDS_H
+
+#include <glib.h>
+#include <errno.h>
+#include <glob.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "logging.h"
+
+// Keybinds from the user's Hyprland config.
+//
+// hypr_keybinds_load() reads $XDG_CONFIG_HOME/hypr/hyprland.conf and every
+// file it pulls in with source= (globs and ~ included). Files are mmap'd and
+// scanned in place: lines, keys and fields are (pointer, length) slices into
+// the mapping, and only the fields of bind lines are copied out, with $vars
+// expanded.
+//
+// The binds are cached in $XDG_CACHE_HOME/elysia-welcome/keybinds.gvariant
+// with the mtime of every file read and of every directory a source glob
+// was expanded in. While none of them has changed, hypr_keybinds_load()
+// maps the cache and does not parse at all.
+
+#define HYPR_CACHE_VERSION    1
+#define HYPR_CACHE_TYPE       "(ua(sx)a(sssss))"
+#define HYPR_MAX_SOURCE_DEPTH 8
+
+typedef struct {
+    gchar *mods;         // normalised, e.g. "SUPER + SHIFT"; "" for none
+    gchar *key;          // as written, letters upper-cased: "Q", "XF86AudioMute"
+    gchar *dispatcher;   // "exec", "killactive", ...
+    gchar *params;       // dispatcher argument, variables expanded
+    gchar *description;  // bindd description, "" if none
+} HyprBind;
+
+typedef struct {
+    const char *p;
+    gsize       len;
+} HyprSlice;
+
+typedef struct {
+    GArray     *binds;     // HyprBind
+    GPtrArray  *stamped;   // paths whose mtime keys the cache
+    GArray     *mtimes;    // gint64 ns, parallel to stamped
+    GHashTable *variables; // name without '$' -> expanded value
+    GHashTable *visited;   // canonical paths parsed or being parsed
+} HyprParser;
+
+static inline void hypr_bind_clear(gpointer data) {
+    HyprBind *bind = (HyprBind*) data;
+    g_free(bind->mods);
+    g_free(bind->key);
+    g_free(bind->dispatcher);
+    g_free(bind->params);
+    g_free(bind->description);
+}
+
+static inline GArray* hypr_binds_new(void) {
+    GArray *binds = g_array_new(FALSE, TRUE, sizeof(HyprBind));
+    g_array_set_clear_func(binds, hypr_bind_clear);
+    return binds;
+}
+
+// mtime in ns, or -1 if the path is gone
+static inline gint64 hypr_mtime(const char *path) {
+    struct stat st;
+    if (stat(path, &st) != 0) return -1;
+    return (gint64) st.st_mtim.tv_sec * G_GINT64_CONSTANT(1000000000) + st.st_mtim.tv_nsec;
+}
+
+static inline void hypr_stamp(HyprParser *parser, const char *path) {
+    gint64 mtime = hypr_mtime(path);
+    g_ptr_array_add(parser->stamped, g_strdup(path));
+    g_array_append_val(parser->mtimes, mtime);
+}
+
+/* ---------- Slices ---------- */
+
+static inline HyprSlice hypr_trim(HyprSlice s) {
+    while (s.len > 0 && g_ascii_isspace(s.p[0])) { s.p++; s.len--; }
+    while (s.len > 0 && g_ascii_isspace(s.p[s.len - 1])) s.len--;
+    return s;
+}
+
+static inline gboolean hypr_slice_equal(HyprSlice s, const char *literal) {
+    return s.len == strlen(literal) && memcmp(s.p, literal, s.len) == 0;
+}
+
+// Split off the text before the first sep; the rest stays in *s
+static inline HyprSlice hypr_next_field(HyprSlice *s, char sep) {
+    const char *at = (const char*) memchr(s->p, sep, s->len);
+    HyprSlice field = { s->p, at ? (gsize) (at - s->p) : s->len };
+    s->p += at ? field.len + 1 : field.len;
+    s->len -= at ? field.len + 1 : field.len;
+    return hypr_trim(field);
+}
+
+// Copy s, replacing $name with its value (unknown variables are kept)
+static inline gchar* hypr_expand(HyprParser *parser, HyprSlice s) {
+    if (!memchr(s.p, '$', s.len)) return g_strndup(s.p, s.len);
+    GString *out = g_string_sized_new(s.len + 16);
+    for (gsize i = 0; i < s.len; i++) {
+        gsize end = i + 1;
+        while (s.p[i] == '$' && end < s.len && (g_ascii_isalnum(s.p[end]) || s.p[end] == '_')) end++;
+        if (end > i + 1) {
+            gchar *name = g_strndup(s.p + i + 1, end - i - 1);
+            const gchar *value = (const gchar*) g_hash_table_lookup(parser->variables, name);
+            g_free(name);
+            if (value) {
+                g_string_append(out, value);
+                i = end - 1;
+                continue;
+            }
+        }
+        g_string_append_c(out, s.p[i]);
+    }
+    return g_string_free(out, FALSE);
+}
+
+/* ---------- Binds ---------- */
+
+// "$mainMod SHIFT", "SUPER_SHIFT", "ctrl alt" -> "SUPER + SHIFT", "CTRL + ALT"
+static inline gchar* hypr_normalise_mods(const char *mods) {
+    static const struct { const char *alias, *name; } aliases[] = {
+        { "SUPER", "SUPER" }, { "WIN", "SUPER" }, { "LOGO", "SUPER" }, { "MOD4", "SUPER" }, { "META", "SUPER" },
+        { "CTRL", "CTRL" }, { "CONTROL", "CTRL" }, { "ALT", "ALT" }, { "MOD1", "ALT" }, { "SHIFT", "SHIFT" },
+    };
+    GString *out = g_string_new(NULL);
+    gchar **parts = g_strsplit_set(mods, " _+\t", -1);
+    for (gchar **part = parts; *part; part++) {
+        if (**part == '\0') continue;
+        gchar *upper = g_ascii_strup(*part, -1);
+        const char *name = upper;
+        for (guint i = 0; i < G_N_ELEMENTS(aliases); i++) {
+            if (strcmp(upper, aliases[i].alias) == 0) name = aliases[i].name;
+        }
+        g_string_append_printf(out, "%s%s", out->len ? " + " : "", name);
+        g_free(upper);
+    }
+    g_strfreev(parts);
+    return g_string_free(out, FALSE);
+}
+
+// Letters and names upper-cased like the old table ("q" -> "Q", "space" ->
+// "SPACE"); XF86 keysyms keep their case
+static inline gchar* hypr_normalise_key(const char *key) {
+    if (g_str_has_prefix(key, "XF86")) return g_strdup(key);
+    return g_ascii_strup(key, -1);
+}
+
+// bind[flags] = MODS, key, dispatcher, params
+// bindd[flags] = MODS, key, description, dispatcher, params
+static inline void hypr_parse_bind(HyprParser *parser, HyprSlice flags, HyprSlice value) {
+    gboolean described = FALSE;
+    for (gsize i = 0; i < flags.len; i++) {
+        if (!strchr("lrenmtisdpoc", flags.p[i])) return;   // not a bind keyword
+        if (flags.p[i] == 'm') return;                      // mouse binds
+        if (flags.p[i] == 'd') described = TRUE;
+    }
+    gchar *value_str = hypr_expand(parser, value);          // variables may hold commas
+    HyprSlice rest = { value_str, strlen(value_str) };
+    HyprSlice mods = hypr_next_field(&rest, ',');
+    HyprSlice key = hypr_next_field(&rest, ',');
+    HyprSlice description = { "", 0 };
+    if (described) description = hypr_next_field(&rest, ',');
+    HyprSlice dispatcher = hypr_next_field(&rest, ',');
+    HyprSlice params = hypr_trim(rest);
+    if (key.len == 0 || dispatcher.len == 0) {
+        g_free(value_str);
+        return;
+    }
+
+    gchar *mods_str = g_strndup(mods.p, mods.len);
+    gchar *key_str = g_strndup(key.p, key.len);
+    HyprBind bind = {
+        hypr_normalise_mods(mods_str), hypr_normalise_key(key_str),
+        g_strndup(dispatcher.p, dispatcher.len), g_strndup(params.p, params.len),
+        g_strndup(description.p, description.len),
+    };
+    g_free(mods_str);
+    g_free(key_str);
+    g_free(value_str);
+    g_array_append_val(parser->binds, bind);
+}
+
+// unbind = MODS, key
+static inline void hypr_parse_unbind(HyprParser *parser, HyprSlice value) {
+    gchar *value_str = hypr_expand(parser, value);
+    HyprSlice rest = { value_str, strlen(value_str) };
+    HyprSlice mods_field = hypr_next_field(&rest, ',');
+    HyprSlice key_field = hypr_trim(rest);
+    gchar *mods_raw = g_strndup(mods_field.p, mods_field.len);
+    gchar *key_raw = g_strndup(key_field.p, key_field.len);
+    gchar *mods = hypr_normalise_mods(mods_raw);
+    gchar *key = hypr_normalise_key(key_raw);
+    for (guint i = parser->binds->len; i > 0; i--) {
+        HyprBind *bind = &g_array_index(parser->binds, HyprBind, i - 1);
+        if (strcmp(bind->mods, mods) == 0 && strcmp(bind->key, key) == 0) g_array_remove_index(parser->binds, i - 1);
+    }
+    g_free(mods_raw);
+    g_free(key_raw);
+    g_free(mods);
+    g_free(key);
+    g_free(value_str);
+}
+
+/* ---------- Files ---------- */
+
+static inline void hypr_parse_file(HyprParser *parser, const char *path, guint depth);
+
+// source = path; relative to the including file, ~ and globs allowed
+static inline void hypr_parse_source(HyprParser *parser, const char *from, HyprSlice value, guint depth) {
+    gchar *pattern = hypr_expand(parser, value);
+    gchar *path;
+    if (pattern[0] == '~' && (pattern[1] == '/' || pattern[1] == '\0')) {
+        path = g_build_filename(g_get_home_dir(), pattern + 1, NULL);
+    } else if (!g_path_is_absolute(pattern)) {
+        gchar *dir = g_path_get_dirname(from);
+        path = g_build_filename(dir, pattern, NULL);
+        g_free(dir);
+    } else {
+        path = g_strdup(pattern);
+    }
+
+    if (strpbrk(path, "*?[")) {
+        // a new file matching the glob shows up as a directory mtime change
+        gchar *dir = g_path_get_dirname(path);
+        hypr_stamp(parser, dir);
+        g_free(dir);
+        glob_t matches;
+        if (glob(path, 0, NULL, &matches) == 0) {
+            for (size_t i = 0; i < matches.gl_pathc; i++) hypr_parse_file(parser, matches.gl_pathv[i], depth + 1);
+        }
+        globfree(&matches);
+    } else {
+        hypr_parse_file(parser, path, depth + 1);
+    }
+    g_free(path);
+    g_free(pattern);
+}
+
+static inline void hypr_parse_line(HyprParser *parser, const char *path, HyprSlice line, guint depth) {
+    // comments start at a '#' that is not doubled ("##" is a literal '#')
+    for (gsize i = 0; i < line.len; i++) {
+        if (line.p[i] != '#') continue;
+        if (i + 1 < line.len && line.p[i + 1] == '#') { i++; continue; }
+        line.len = i;
+        break;
+    }
+    line = hypr_trim(line);
+    if (line.len == 0) return;
+
+    if (!memchr(line.p, '=', line.len)) return;   // section braces and the like
+    HyprSlice value = line;
+    HyprSlice name = hypr_next_field(&value, '=');
+    value = hypr_trim(value);
+
+    if (name.p[0] == '$' && name.len > 1) {
+        g_hash_table_insert(parser->variables, g_strndup(name.p + 1, name.len - 1), hypr_expand(parser, value));
+    } else if (hypr_slice_equal(name, "source")) {
+        hypr_parse_source(parser, path, value, depth);
+    } else if (hypr_slice_equal(name, "unbind")) {
+        hypr_parse_unbind(parser, value);
+    } else if (name.len >= 4 && memcmp(name.p, "bind", 4) == 0) {
+        HyprSlice flags = { name.p + 4, name.len - 4 };
+        hypr_parse_bind(parser, flags, value);
+    }
+}
+
+static inline void hypr_parse_file(HyprParser *parser, const char *path, guint depth) {
+    if (depth > HYPR_MAX_SOURCE_DEPTH) {
+        log_warning(LOG_UI, "Hyprland config: source= nested too deep at %s", path);
+        return;
+    }
+    // each file once: a glob can match the file it is in, and files can
+    // source each other
+    char *resolved = realpath(path, NULL);
+    gchar *canonical = resolved ? g_strdup(resolved) : g_canonicalize_filename(path, NULL);
+    free(resolved);
+    if (!g_hash_table_add(parser->visited, canonical)) {
+        log_debug(LOG_UI, "Hyprland config: %s already read, skipping", path);
+        return;
+    }
+    hypr_stamp(parser, path);
+    GError *error = NULL;
+    GMappedFile *mapped = g_mapped_file_new(path, FALSE, &error);
+    if (!mapped) {
+        log_debug(LOG_UI, "Hyprland config: %s", error->message);
+        g_error_free(error);
+        return;
+    }
+    HyprSlice rest = { g_mapped_file_get_contents(mapped), g_mapped_file_get_length(mapped) };
+    while (rest.len > 0) {
+        const char *eol = (const char*) memchr(rest.p, '\n', rest.len);
+        HyprSlice line = { rest.p, eol ? (gsize) (eol - rest.p) : rest.len };
+        hypr_parse_line(parser, path, line, depth);
+        rest.p += eol ? line.len + 1 : line.len;
+        rest.len -= eol ? line.len + 1 : line.len;
+    }
+    g_mapped_file_unref(mapped);
+}
+
+/* ---------- Cache ---------- */
+
+static inline gchar* hypr_cache_path(void) {
+    return g_build_filename(g_get_user_cache_dir(), "elysia-welcome", "keybinds.gvariant", NULL);
+}
+
+static inline gchar* hypr_config_path(void) {
+    return g_build_filename(g_get_user_config_dir(), "hypr", "hyprland.conf", NULL);
+}
+
+// Binds from the cache if it was written for config and no stamped path
+// has changed since, else NULL
+static inline GArray* hypr_cache_load(const char *config) {
+    gchar *cache_path = hypr_cache_path();
+    GMappedFile *mapped = g_mapped_file_new(cache_path, FALSE, NULL);
+    g_free(cache_path);
+    if (!mapped) return NULL;
+
+    GBytes *bytes = g_mapped_file_get_bytes(mapped);
+    g_mapped_file_unref(mapped);
+    GVariant *cache = g_variant_ref_sink(g_variant_new_from_bytes(G_VARIANT_TYPE(HYPR_CACHE_TYPE), bytes, FALSE));
+    g_bytes_unref(bytes);
+
+    guint32 version;
+    GVariant *stamps, *entries;
+    g_variant_get(cache, "(u@a(sx)@a(sssss))", &version, &stamps, &entries);
+    gboolean valid = version == HYPR_CACHE_VERSION && g_variant_n_children(stamps) > 0;
+
+    for (gsize i = 0; valid && i < g_variant_n_children(stamps); i++) {
+        const gchar *path;
+        gint64 mtime;
+        g_variant_get_child(stamps, i, "(&sx)", &path, &mtime);
+        if (i == 0 && strcmp(path, config) != 0) valid = FALSE;
+        if (hypr_mtime(path) != mtime) valid = FALSE;
+    }
+
+    GArray *binds = NULL;
+    if (valid) {
+        binds = hypr_binds_new();
+        GVariantIter iter;
+        const gchar *mods, *key, *dispatcher, *params, *description;
+        g_variant_iter_init(&iter, entries);
+        while (g_variant_iter_next(&iter, "(&s&s&s&s&s)", &mods, &key, &dispatcher, &params, &description)) {
+            HyprBind bind = { g_strdup(mods), g_strdup(key), g_strdup(dispatcher), g_strdup(params), g_strdup(description) };
+            g_array_append_val(binds, bind);
+        }
+    }
+    g_variant_unref(stamps);
+    g_variant_unref(entries);
+    g_variant_unref(cache);
+    return binds;
+}
+
+static inline void hypr_cache_save(HyprParser *parser) {
+    GVariantBuilder stamps, entries;
+    g_variant_builder_init(&stamps, G_VARIANT_TYPE("a(sx)"));
+    for (guint i = 0; i < parser->stamped->len; i++) {
+        g_variant_builder_add(&stamps, "(sx)", (const gchar*) g_ptr_array_index(parser->stamped, i),
+                              g_array_index(parser->mtimes, gint64, i));
+    }
+    g_variant_builder_init(&entries, G_VARIANT_TYPE("a(sssss)"));
+    for (guint i = 0; i < parser->binds->len; i++) {
+        HyprBind *bind = &g_array_index(parser->binds, HyprBind, i);
+        g_variant_builder_add(&entries, "(sssss)", bind->mods, bind->key, bind->dispatcher, bind->params, bind->description);
+    }
+    GVariant *cache = g_variant_ref_sink(g_variant_new("(ua(sx)a(sssss))", (guint32) HYPR_CACHE_VERSION, &stamps, &entries));
+
+    gchar *cache_path = hypr_cache_path();
+    gchar *dir = g_path_get_dirname(cache_path);
+    GError *error = NULL;
+    if (g_mkdir_with_parents(dir, 0700) != 0 ||
+        !g_file_set_contents(cache_path, (const gchar*) g_variant_get_data(cache), g_variant_get_size(cache), &error)) {
+        log_debug(LOG_UI, "Keybind cache not written: %s", error ? error->message : g_strerror(errno));
+        g_clear_error(&error);
+    }
+    g_free(dir);
+    g_free(cache_path);
+    g_variant_unref(cache);
+}
+
+/* ---------- Entry point ---------- */
+
+// The user's binds in config order, or NULL when there is no Hyprland config
+static inline GArray* hypr_keybinds_load(void) {
+    gchar *config = hypr_config_path();
+    if (!g_file_test(config, G_FILE_TEST_IS_REGULAR)) {
+        g_free(config);
+        return NULL;
+    }
+
+    GArray *binds = hypr_cache_load(config);
+    if (binds) {
+        log_debug(LOG_UI, "Keybinds: %u from cache", binds->len);
+        g_free(config);
+        return binds;
+    }
+
+    HyprParser parser = {
+        hypr_binds_new(),
+        g_ptr_array_new_with_free_func(g_free),
+        g_array_new(FALSE, FALSE, sizeof(gint64)),
+        g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free),
+        g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL),
+    };
+    hypr_parse_file(&parser, config, 0);
+    log_debug(LOG_UI, "Keybinds: parsed %u from %s and its sources", parser.binds->len, config);
+    hypr_cache_save(&parser);
+
+    g_ptr_array_unref(parser.stamped);
+    g_array_unref(parser.mtimes);
+    g_hash_table_unref(parser.variables);
+    g_hash_table_unref(parser.visited);
+    g_free(config);
+    return parser.binds;
+}
+
+#endif // HYPR_KEYBINDS_H
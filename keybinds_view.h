@@ -0,0 +1,249 @@
+#ifndef KEYBINDS_VIEW_H
+#define KEYBINDS_VIEW_H
+
+#include <gtk/gtk.h>
+
+// ElysiaKeybindsView: the keybinds table as one widget.
+//
+// Every shortcut/description pair is a cached PangoLayout, and the keycap
+// backgrounds are drawn straight into the widget's snapshot. The table
+// costs one CSS node however many binds it shows, where the old grid of
+// labels had two styled nodes per bind to restyle, measure and snapshot on
+// every theme switch. Colours follow the light/dark palettes of the old
+// .keybind-shortcut / .keybind-description rules; switching themes is
+// elysia_keybinds_view_set_dark(), which only redraws. Screen readers get
+// the whole table as the widget's label, one "shortcut: description"
+// line per bind.
+
+#define KEYBINDS_FONT_SHORTCUT    "ElysiaOSNew12 Semi-Bold 11px"
+#define KEYBINDS_FONT_DESCRIPTION "ElysiaOSNew12 11px"
+#define KEYBINDS_PAD_X            8   // keycap padding
+#define KEYBINDS_PAD_Y            4
+#define KEYBINDS_BORDER           1
+#define KEYBINDS_RADIUS           4
+#define KEYBINDS_MARGIN_Y         2   // above and below each cell
+#define KEYBINDS_MARGIN_X         8   // between a cell and the column gap
+#define KEYBINDS_ROW_SPACING      4
+#define KEYBINDS_COLUMN_SPACING   12
+
+typedef struct {
+    const char *shortcut;
+    const char *description;
+} KeybindEntry;
+
+typedef struct {
+    GdkRGBA shortcut_text;
+    GdkRGBA keycap_start;   // gradient, left to right
+    GdkRGBA keycap_end;
+    GdkRGBA keycap_border;
+    GdkRGBA description_text;
+} KeybindsPalette;
+
+static const KeybindsPalette keybinds_palette_light = {
+    { 0x1d / 255.0f, 0x1d / 255.0f, 0x1f / 255.0f, 1.0f },
+    { 229 / 255.0f, 167 / 255.0f, 198 / 255.0f, 0.2f },
+    { 237 / 255.0f, 206 / 255.0f, 227 / 255.0f, 0.3f },
+    { 229 / 255.0f, 167 / 255.0f, 198 / 255.0f, 0.4f },
+    { 0x6d / 255.0f, 0x6d / 255.0f, 0x70 / 255.0f, 1.0f },
+};
+
+static const KeybindsPalette keybinds_palette_dark = {
+    { 1.0f, 1.0f, 1.0f, 1.0f },
+    { 112 / 255.0f, 119 / 255.0f, 189 / 255.0f, 0.2f },
+    { 177 / 255.0f, 201 / 255.0f, 236 / 255.0f, 0.3f },
+    { 112 / 255.0f, 119 / 255.0f, 189 / 255.0f, 0.4f },
+    { 0xcc / 255.0f, 0xcc / 255.0f, 0xcc / 255.0f, 1.0f },
+};
+
+typedef struct {
+    gchar       *shortcut;
+    gchar       *description;
+    PangoLayout *shortcut_layout;      // NULL until measured
+    PangoLayout *description_layout;
+} KeybindsRow;
+
+#define ELYSIA_TYPE_KEYBINDS_VIEW (elysia_keybinds_view_get_type())
+G_DECLARE_FINAL_TYPE(ElysiaKeybindsView, elysia_keybinds_view, ELYSIA, KEYBINDS_VIEW, GtkWidget)
+
+struct _ElysiaKeybindsView {
+    GtkWidget              parent_instance;
+    GArray                *rows;         // KeybindsRow
+    const KeybindsPalette *palette;
+
+    // Geometry from the last layout pass; valid while layouts_valid
+    gboolean layouts_valid;
+    int      keycap_column_width;   // widest keycap
+    int      description_width;     // widest description
+    int      row_height;
+};
+
+G_DEFINE_TYPE(ElysiaKeybindsView, elysia_keybinds_view, GTK_TYPE_WIDGET)
+
+static inline void keybinds_row_clear(gpointer data) {
+    KeybindsRow *row = (KeybindsRow*) data;
+    g_free(row->shortcut);
+    g_free(row->description);
+    g_clear_object(&row->shortcut_layout);
+    g_clear_object(&row->description_layout);
+}
+
+static inline PangoLayout* keybinds_make_layout(GtkWidget *widget, const char *text, const char *font) {
+    PangoLayout *layout = gtk_widget_create_pango_layout(widget, text);
+    PangoFontDescription *desc = pango_font_description_from_string(font);
+    pango_layout_set_font_description(layout, desc);
+    pango_font_description_free(desc);
+    return layout;
+}
+
+// Build any missing layouts and recompute the column widths
+static inline void keybinds_view_ensure_layouts(ElysiaKeybindsView *self) {
+    if (self->layouts_valid) return;
+    int keycap_w = 0, description_w = 0, text_h = 0;
+    for (guint i = 0; i < self->rows->len; i++) {
+        KeybindsRow *row = &g_array_index(self->rows, KeybindsRow, i);
+        if (!row->shortcut_layout) {
+            row->shortcut_layout = keybinds_make_layout(GTK_WIDGET(self), row->shortcut, KEYBINDS_FONT_SHORTCUT);
+            row->description_layout = keybinds_make_layout(GTK_WIDGET(self), row->description, KEYBINDS_FONT_DESCRIPTION);
+        }
+        int w, h;
+        pango_layout_get_pixel_size(row->shortcut_layout, &w, &h);
+        keycap_w = MAX(keycap_w, w);
+        text_h = MAX(text_h, h);
+        pango_layout_get_pixel_size(row->description_layout, &w, &h);
+        description_w = MAX(description_w, w);
+        text_h = MAX(text_h, h);
+    }
+    self->keycap_column_width = keycap_w + 2 * (KEYBINDS_PAD_X + KEYBINDS_BORDER);
+    self->description_width = description_w;
+    self->row_height = text_h + 2 * (KEYBINDS_PAD_Y + KEYBINDS_BORDER + KEYBINDS_MARGIN_Y);
+    self->layouts_valid = TRUE;
+}
+
+static inline int keybinds_view_description_x(ElysiaKeybindsView *self) {
+    return self->keycap_column_width + KEYBINDS_MARGIN_X + KEYBINDS_COLUMN_SPACING + KEYBINDS_MARGIN_X;
+}
+
+static inline void keybinds_view_measure(GtkWidget *widget, GtkOrientation orientation, int for_size,
+                                         int *minimum, int *natural, int *minimum_baseline, int *natural_baseline) {
+    (void)for_size; (void)minimum_baseline; (void)natural_baseline;
+    ElysiaKeybindsView *self = ELYSIA_KEYBINDS_VIEW(widget);
+    keybinds_view_ensure_layouts(self);
+    int n = (int) self->rows->len;
+    if (orientation == GTK_ORIENTATION_HORIZONTAL) {
+        *minimum = *natural = n > 0 ? keybinds_view_description_x(self) + self->description_width : 0;
+    } else {
+        *minimum = *natural = n > 0 ? n * self->row_height + (n - 1) * KEYBINDS_ROW_SPACING : 0;
+    }
+}
+
+static inline void keybinds_view_snapshot(GtkWidget *widget, GtkSnapshot *snapshot) {
+    ElysiaKeybindsView *self = ELYSIA_KEYBINDS_VIEW(widget);
+    const KeybindsPalette *p = self->palette;
+    keybinds_view_ensure_layouts(self);
+    int description_x = keybinds_view_description_x(self);
+
+    for (guint i = 0; i < self->rows->len; i++) {
+        KeybindsRow *row = &g_array_index(self->rows, KeybindsRow, i);
+        int row_y = (int) i * (self->row_height + KEYBINDS_ROW_SPACING);
+        int w, h;
+
+        // keycap, right-aligned in the first column and centred in the row
+        pango_layout_get_pixel_size(row->shortcut_layout, &w, &h);
+        int cap_w = w + 2 * (KEYBINDS_PAD_X + KEYBINDS_BORDER);
+        int cap_h = h + 2 * (KEYBINDS_PAD_Y + KEYBINDS_BORDER);
+        graphene_rect_t cap = GRAPHENE_RECT_INIT((float) (self->keycap_column_width - cap_w),
+                                                 (float) (row_y + (self->row_height - cap_h) / 2),
+                                                 (float) cap_w, (float) cap_h);
+        GskRoundedRect rounded;
+        gsk_rounded_rect_init_from_rect(&rounded, &cap, KEYBINDS_RADIUS);
+        GskColorStop stops[] = { { 0.0f, p->keycap_start }, { 1.0f, p->keycap_end } };
+        graphene_point_t start, end, text_origin;
+        graphene_point_init(&start, cap.origin.x, 0);
+        graphene_point_init(&end, cap.origin.x + cap.size.width, 0);
+        gtk_snapshot_push_rounded_clip(snapshot, &rounded);
+        gtk_snapshot_append_linear_gradient(snapshot, &cap, &start, &end, stops, G_N_ELEMENTS(stops));
+        gtk_snapshot_pop(snapshot);
+        const float border_widths[4] = { KEYBINDS_BORDER, KEYBINDS_BORDER, KEYBINDS_BORDER, KEYBINDS_BORDER };
+        const GdkRGBA border_colors[4] = { p->keycap_border, p->keycap_border, p->keycap_border, p->keycap_border };
+        gtk_snapshot_append_border(snapshot, &rounded, border_widths, border_colors);
+
+        gtk_snapshot_save(snapshot);
+        graphene_point_init(&text_origin, cap.origin.x + KEYBINDS_PAD_X + KEYBINDS_BORDER,
+                            cap.origin.y + KEYBINDS_PAD_Y + KEYBINDS_BORDER);
+        gtk_snapshot_translate(snapshot, &text_origin);
+        gtk_snapshot_append_layout(snapshot, row->shortcut_layout, &p->shortcut_text);
+        gtk_snapshot_restore(snapshot);
+
+        // description, left-aligned in the second column
+        pango_layout_get_pixel_size(row->description_layout, &w, &h);
+        gtk_snapshot_save(snapshot);
+        graphene_point_init(&text_origin, (float) description_x, (float) (row_y + (self->row_height - h) / 2));
+        gtk_snapshot_translate(snapshot, &text_origin);
+        gtk_snapshot_append_layout(snapshot, row->description_layout, &p->description_text);
+        gtk_snapshot_restore(snapshot);
+    }
+}
+
+// Font settings or DPI changed; each layout was made with its own context
+// from gtk_widget_create_pango_layout(), so rebuild them
+static inline void keybinds_view_system_setting_changed(GtkWidget *widget, GtkSystemSetting setting) {
+    GTK_WIDGET_CLASS(elysia_keybinds_view_parent_class)->system_setting_changed(widget, setting);
+    ElysiaKeybindsView *self = ELYSIA_KEYBINDS_VIEW(widget);
+    for (guint i = 0; i < self->rows->len; i++) {
+        KeybindsRow *row = &g_array_index(self->rows, KeybindsRow, i);
+        g_clear_object(&row->shortcut_layout);
+        g_clear_object(&row->description_layout);
+    }
+    self->layouts_valid = FALSE;
+    gtk_widget_queue_resize(widget);
+}
+
+static inline void keybinds_view_finalize(GObject *object) {
+    g_array_unref(ELYSIA_KEYBINDS_VIEW(object)->rows);
+    G_OBJECT_CLASS(elysia_keybinds_view_parent_class)->finalize(object);
+}
+
+static void elysia_keybinds_view_class_init(ElysiaKeybindsViewClass *klass) {
+    GObjectClass *object_class = G_OBJECT_CLASS(klass);
+    GtkWidgetClass *widget_class = GTK_WIDGET_CLASS(klass);
+    object_class->finalize = keybinds_view_finalize;
+    widget_class->measure = keybinds_view_measure;
+    widget_class->snapshot = keybinds_view_snapshot;
+    widget_class->system_setting_changed = keybinds_view_system_setting_changed;
+    gtk_widget_class_set_css_name(widget_class, "keybinds");
+    gtk_widget_class_set_accessible_role(widget_class, GTK_ACCESSIBLE_ROLE_LABEL);
+}
+
+static void elysia_keybinds_view_init(ElysiaKeybindsView *self) {
+    self->rows = g_array_new(FALSE, TRUE, sizeof(KeybindsRow));
+    g_array_set_clear_func(self->rows, keybinds_row_clear);
+    self->palette = &keybinds_palette_light;
+}
+
+static inline GtkWidget* elysia_keybinds_view_new(void) {
+    return GTK_WIDGET(g_object_new(ELYSIA_TYPE_KEYBINDS_VIEW, NULL));
+}
+
+// Replace the table; the strings are copied
+static inline void elysia_keybinds_view_set_keybinds(ElysiaKeybindsView *self, const KeybindEntry *entries, guint n) {
+    g_array_set_size(self->rows, 0);
+    GString *accessible = g_string_new(NULL);
+    for (guint i = 0; i < n; i++) {
+        KeybindsRow row = { g_strdup(entries[i].shortcut), g_strdup(entries[i].description), NULL, NULL };
+        g_array_append_val(self->rows, row);
+        g_string_append_printf(accessible, "%s%s: %s", i > 0 ? "\n" : "", entries[i].shortcut, entries[i].description);
+    }
+    gtk_accessible_update_property(GTK_ACCESSIBLE(self), GTK_ACCESSIBLE_PROPERTY_LABEL, accessible->str, -1);
+    g_string_free(accessible, TRUE);
+    self->layouts_valid = FALSE;
+    gtk_widget_queue_resize(GTK_WIDGET(self));
+}
+
+static inline void elysia_keybinds_view_set_dark(ElysiaKeybindsView *self, gboolean dark) {
+    const KeybindsPalette *palette = dark ? &keybinds_palette_dark : &keybinds_palette_light;
+    if (self->palette == palette) return;
+    self->palette = palette;
+    gtk_widget_queue_draw(GTK_WIDGET(self));
+}
+
+#endif // KEYBINDS_VIEW_H
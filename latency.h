@@ -0,0 +1,195 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <gtk/gtk.h>
+#include "logging.h"
+
+// Input-to-present latency per user action.
+//
+// A capture-phase controller on the window timestamps every click, tap
+// and key press from the GDK event. A handler that reacts to that input
+// calls latency_mark("action"); the sample is then bound to the next frame
+// the frame clock paints and resolved to that frame's presentation time
+// (or its paint time when the compositor gives no presentation feedback).
+// Per-action p50/p95/p99 are logged at exit and with the memory report
+// (SIGUSR1). Only one window is measured at a time: the first one attached,
+// until it is detached.
+//
+// There is no signal of its own: SIGUSR2 already dumps the log ring
+// (logging.h), and one signal should trigger one report.
+
+// Input older than this is not what triggered the handler (e.g. a timer)
+#define LATENCY_INPUT_MAX_AGE_US (500 * 1000)
+// Frames to wait for presentation feedback before using the paint time
+#define LATENCY_MAX_FEEDBACK_FRAMES 8
+
+typedef struct {
+    const char *action;
+    gint64      input_us;
+    gint64      frame;     // -1 until painted
+    gint64      paint_us;
+    guint       waited;
+} LatencySample;
+
+static GtkWidget     *latency_window = NULL;
+static GdkFrameClock *latency_clock = NULL;
+static gulong         latency_paint_id = 0;
+static gint64         latency_last_input_us = 0;
+static GArray        *latency_pending = NULL;   // LatencySample
+static GHashTable    *latency_samples = NULL;   // action -> GArray of gint64 us
+
+static inline void latency_record(const LatencySample *s, gint64 shown_us) {
+    GArray *values = (GArray*) g_hash_table_lookup(latency_samples, s->action);
+    if (!values) {
+        values = g_array_new(FALSE, FALSE, sizeof(gint64));
+        g_hash_table_insert(latency_samples, (gpointer) s->action, values);
+    }
+    gint64 latency_us = MAX(shown_us - s->input_us, 0);
+    g_array_append_val(values, latency_us);
+    log_debug(LOG_PERF, "%s: %.1f ms input to present", s->action, latency_us / 1000.0);
+}
+
+static inline void latency_stop_watching(void) {
+    if (latency_paint_id) {
+        g_signal_handler_disconnect(latency_clock, latency_paint_id);
+        latency_paint_id = 0;
+    }
+    g_clear_object(&latency_clock);
+}
+
+static inline void latency_on_after_paint(GdkFrameClock *clock, gpointer user_data) {
+    (void)user_data;
+    gint64 frame = gdk_frame_clock_get_frame_counter(clock);
+    gint64 now = g_get_monotonic_time();
+
+    for (guint i = 0; i < latency_pending->len; ) {
+        LatencySample *s = &g_array_index(latency_pending, LatencySample, i);
+        if (s->frame < 0) {
+            s->frame = frame;
+            s->paint_us = now;
+            i++;
+            continue;
+        }
+
+        GdkFrameTimings *timings = gdk_frame_clock_get_timings(clock, s->frame);
+        if (timings && gdk_frame_timings_get_complete(timings)) {
+            gint64 presented = gdk_frame_timings_get_presentation_time(timings);
+            latency_record(s, presented ? presented : s->paint_us);
+        } else if (!timings || ++s->waited >= LATENCY_MAX_FEEDBACK_FRAMES) {
+            latency_record(s, s->paint_us);
+        } else {
+            i++;
+            continue;
+        }
+        g_array_remove_index_fast(latency_pending, i);
+    }
+
+    if (latency_pending->len > 0) {
+        // keep frames coming until the compositor reports back
+        gdk_frame_clock_request_phase(clock, GDK_FRAME_CLOCK_PHASE_AFTER_PAINT);
+    } else {
+        latency_stop_watching();
+    }
+}
+
+// Call from a handler reacting to user input; ignored when no input is recent
+static inline void latency_mark(const char *action) {
+    if (!latency_window) return;
+    gint64 input_us = latency_last_input_us;
+    if (input_us == 0 || g_get_monotonic_time() - input_us > LATENCY_INPUT_MAX_AGE_US) return;
+
+    GdkFrameClock *clock = gtk_widget_get_frame_clock(latency_window);
+    if (!clock) return;
+
+    LatencySample s = { action, input_us, -1, 0, 0 };
+    g_array_append_val(latency_pending, s);
+
+    if (!latency_paint_id) {
+        latency_clock = GDK_FRAME_CLOCK(g_object_ref(clock));
+        latency_paint_id = g_signal_connect(clock, "after-paint", G_CALLBACK(latency_on_after_paint), NULL);
+    }
+    gdk_frame_clock_request_phase(clock, GDK_FRAME_CLOCK_PHASE_AFTER_PAINT);
+}
+
+static inline gboolean latency_on_input(GtkEventControllerLegacy *controller, GdkEvent *event, gpointer user_data) {
+    (void)controller;
+    (void)user_data;
+    switch (gdk_event_get_event_type(event)) {
+    case GDK_BUTTON_RELEASE:
+    case GDK_KEY_PRESS:
+    case GDK_TOUCH_END: {
+        // Event times are in milliseconds; on Wayland and X11 they share the
+        // monotonic clock, so the queueing delay before dispatch is counted.
+        // Fall back to the dispatch time if the clocks clearly differ.
+        gint64 now = g_get_monotonic_time();
+        gint64 age_ms = now / 1000 - (gint64) gdk_event_get_time(event);
+        latency_last_input_us = (age_ms >= 0 && age_ms < 1000) ? now - age_ms * 1000 : now;
+        break;
+    }
+    default:
+        break;
+    }
+    return GDK_EVENT_PROPAGATE;
+}
+
+static inline gint latency_compare(gconstpointer a, gconstpointer b) {
+    gint64 x = *(const gint64*) a, y = *(const gint64*) b;
+    return (x > y) - (x < y);
+}
+
+// Nearest-rank percentile of sorted values
+static inline gint64 latency_percentile(const GArray *sorted, guint pct) {
+    guint rank = (sorted->len * pct + 99) / 100;
+    return g_array_index(sorted, gint64, MAX(rank, 1) - 1);
+}
+
+static inline void latency_report(void) {
+    if (!latency_samples || g_hash_table_size(latency_samples) == 0) return;
+
+    GList *actions = g_list_sort(g_hash_table_get_keys(latency_samples), (GCompareFunc) g_strcmp0);
+    for (GList *l = actions; l; l = l->next) {
+        GArray *values = (GArray*) g_hash_table_lookup(latency_samples, l->data);
+        GArray *sorted = g_array_sized_new(FALSE, FALSE, sizeof(gint64), values->len);
+        g_array_append_vals(sorted, values->data, values->len);
+        g_array_sort(sorted, latency_compare);
+        log_message(LOG_PERF, "latency %-12s n=%-4u p50 %.1f ms  p95 %.1f ms  p99 %.1f ms",
+                    (const char*) l->data, sorted->len,
+                    latency_percentile(sorted, 50) / 1000.0,
+                    latency_percentile(sorted, 95) / 1000.0,
+                    latency_percentile(sorted, 99) / 1000.0);
+        g_array_free(sorted, TRUE);
+    }
+    g_list_free(actions);
+}
+
+// Whether window is the one being measured
+static inline gboolean latency_attached_to(GtkWidget *window) {
+    return latency_window && latency_window == window;
+}
+
+static inline void latency_attach(GtkWidget *window) {
+    if (latency_window) return;
+    latency_window = window;
+    latency_pending = g_array_new(FALSE, FALSE, sizeof(LatencySample));
+    latency_samples = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, (GDestroyNotify) g_array_unref);
+
+    GtkEventController *input = gtk_event_controller_legacy_new();
+    gtk_event_controller_set_propagation_phase(input, GTK_PHASE_CAPTURE);
+    g_signal_connect(input, "event", G_CALLBACK(latency_on_input), NULL);
+    gtk_widget_add_controller(window, input);
+}
+
+// Report and drop everything if window is the one measured; samples still
+// waiting for a frame are lost
+static inline void latency_detach(GtkWidget *window) {
+    if (!latency_attached_to(window)) return;
+    latency_report();
+    latency_stop_watching();
+    latency_window = NULL;
+    g_array_unref(latency_pending);
+    g_hash_table_unref(latency_samples);
+    latency_pending = NULL;
+    latency_samples = NULL;
+}
+
+#endif // LATENCY_H
@@ -0,0 +1,215 @@
+#ifndef LOGGING_H
+#define LOGGING_H
+
+#include <glib.h>
+#include <glib-unix.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+// Log domains; each maps to a g_log domain "elysia-welcome-<name>"
+typedef enum {
+    LOG_THEME   = 1 << 0,
+    LOG_NETWORK = 1 << 1,
+    LOG_WIFI    = 1 << 2,
+    LOG_UI      = 1 << 3,
+    LOG_PERF    = 1 << 4
+} LogDomain;
+
+static const GDebugKey log_domain_keys[] = {
+    { "theme",   LOG_THEME },
+    { "network", LOG_NETWORK },
+    { "wifi",    LOG_WIFI },
+    { "ui",      LOG_UI },
+    { "perf",    LOG_PERF },
+};
+
+// Domains whose debug/info output goes to stderr (WELCOME_DEBUG=theme,wifi / all)
+static guint log_enabled_domains = 0;
+
+// Ring buffer of recent events: info and above always, debug only when its
+// domain is enabled. Slots are claimed atomically so any thread may log, and
+// the dump only reads, so it can run from a crash handler. The counter is
+// unsigned and LOG_RING_SIZE a power of two, so slots stay in order when it
+// wraps.
+#define LOG_RING_SIZE 256
+#define LOG_RING_MESSAGE 160
+
+typedef struct {
+    gint64         time_us;
+    guint          domain;
+    GLogLevelFlags level;
+    char           message[LOG_RING_MESSAGE];
+} LogRingEntry;
+
+static LogRingEntry log_ring[LOG_RING_SIZE];
+static guint log_ring_next = 0;
+
+static inline const char* log_domain_name(guint domain) {
+    for (guint i = 0; i < G_N_ELEMENTS(log_domain_keys); i++) {
+        if (log_domain_keys[i].value == domain) return log_domain_keys[i].key;
+    }
+    return "app";
+}
+
+static inline const char* log_level_name(GLogLevelFlags level) {
+    if (level & G_LOG_LEVEL_ERROR)    return "ERROR";
+    if (level & G_LOG_LEVEL_CRITICAL) return "CRITICAL";
+    if (level & G_LOG_LEVEL_WARNING)  return "WARNING";
+    if (level & G_LOG_LEVEL_MESSAGE)  return "MESSAGE";
+    if (level & G_LOG_LEVEL_INFO)     return "INFO";
+    return "DEBUG";
+}
+
+static inline gboolean log_enabled(guint domain) {
+    return (log_enabled_domains & domain) != 0;
+}
+
+static inline void log_emit(guint domain, GLogLevelFlags level, const char *format, ...) G_GNUC_PRINTF(3, 4);
+
+static inline void log_emit(guint domain, GLogLevelFlags level, const char *format, ...) {
+    guint slot = (guint) g_atomic_int_add(&log_ring_next, 1) % LOG_RING_SIZE;
+    LogRingEntry *entry = &log_ring[slot];
+
+    va_list args;
+    va_start(args, format);
+    g_vsnprintf(entry->message, sizeof(entry->message), format, args);
+    va_end(args);
+    entry->time_us = g_get_monotonic_time();
+    entry->domain = domain;
+    entry->level = level;
+
+    gchar *log_domain = g_strconcat("elysia-welcome-", log_domain_name(domain), NULL);
+    if (level & (G_LOG_LEVEL_DEBUG | G_LOG_LEVEL_INFO)) {
+        // GLib's default handler would drop these unless G_MESSAGES_DEBUG is
+        // set; our own gate already decided they should be shown
+        if (log_enabled(domain)) {
+            fprintf(stderr, "%s-%s: %s\n", log_domain, log_level_name(level), entry->message);
+        }
+    } else {
+        g_log(log_domain, level, "%s", entry->message);
+    }
+    g_free(log_domain);
+}
+
+// Hot-path logging: the arguments are not even evaluated unless the domain
+// is enabled; with WELCOME_NO_DEBUG_LOG the calls compile away entirely.
+#ifdef WELCOME_NO_DEBUG_LOG
+#define log_debug(domain, ...) G_STMT_START { } G_STMT_END
+#else
+#define log_debug(domain, ...) \
+    G_STMT_START { \
+        if (G_UNLIKELY(log_enabled(domain))) log_emit((domain), G_LOG_LEVEL_DEBUG, __VA_ARGS__); \
+    } G_STMT_END
+#endif
+
+#define log_info(domain, ...)    log_emit((domain), G_LOG_LEVEL_INFO, __VA_ARGS__)
+#define log_message(domain, ...) log_emit((domain), G_LOG_LEVEL_MESSAGE, __VA_ARGS__)
+#define log_warning(domain, ...) log_emit((domain), G_LOG_LEVEL_WARNING, __VA_ARGS__)
+
+G_STATIC_ASSERT((LOG_RING_SIZE & (LOG_RING_SIZE - 1)) == 0);
+
+// log_dump() runs in a fatal signal handler, where stdio is off limits
+// (snprintf may lock or allocate, %f consults the locale): its lines are
+// put together with these and written with write(2)
+static inline char* log_dump_append(char *out, const char *end, const char *s) {
+    while (*s && out < end) *out++ = *s++;
+    return out;
+}
+
+static inline char* log_dump_append_uint(char *out, const char *end, guint64 value, int min_digits) {
+    char digits[20];
+    int n = 0;
+    do {
+        digits[n++] = (char) ('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+    while (n < min_digits) digits[n++] = '0';
+    while (n > 0 && out < end) *out++ = digits[--n];
+    return out;
+}
+
+// s left-aligned in width columns, like %-*s
+static inline char* log_dump_append_padded(char *out, const char *end, const char *s, int width) {
+    char *start = out;
+    out = log_dump_append(out, end, s);
+    while (out - start < width && out < end) *out++ = ' ';
+    return out;
+}
+
+// Seconds relative to now, right-aligned in 9 columns with millisecond
+// precision, like %+9.3f
+static inline char* log_dump_append_offset(char *out, const char *end, gint64 delta_us) {
+    char stamp[32];
+    guint64 ms = (guint64) (delta_us < 0 ? -delta_us : delta_us) / 1000;
+    char *p = stamp;
+    *p++ = delta_us < 0 ? '-' : '+';
+    p = log_dump_append_uint(p, stamp + sizeof(stamp) - 1, ms / 1000, 1);
+    *p++ = '.';
+    p = log_dump_append_uint(p, stamp + sizeof(stamp) - 1, ms % 1000, 3);
+    *p = '\0';
+    for (int pad = 9 - (int) (p - stamp); pad > 0 && out < end; pad--) *out++ = ' ';
+    return log_dump_append(out, end, stamp);
+}
+
+// Write the ring, oldest first, to fd. No stdio or allocation, only
+// write(2), so it can be used from a fatal signal handler.
+static inline void log_dump(int fd) {
+    char line[LOG_RING_MESSAGE + 64];
+    const char *end = line + sizeof(line) - 1;  // room for the newline
+    guint next = (guint) g_atomic_int_get(&log_ring_next);
+    guint count = MIN(next, LOG_RING_SIZE);
+    gint64 now = g_get_monotonic_time();
+
+    char *out = log_dump_append(line, end, "--- elysia-welcome: last ");
+    out = log_dump_append_uint(out, end, count, 1);
+    out = log_dump_append(out, end, " events ---");
+    *out++ = '\n';
+    if (write(fd, line, out - line) < 0) return;
+
+    for (guint i = next - count; i != next; i++) {
+        const LogRingEntry *entry = &log_ring[i % LOG_RING_SIZE];
+        out = log_dump_append_offset(line, end, entry->time_us - now);
+        out = log_dump_append(out, end, "s ");
+        out = log_dump_append_padded(out, end, log_domain_name(entry->domain), 7);
+        out = log_dump_append(out, end, " ");
+        out = log_dump_append_padded(out, end, log_level_name(entry->level), 8);
+        out = log_dump_append(out, end, " ");
+        out = log_dump_append(out, end, entry->message);
+        *out++ = '\n';
+        if (write(fd, line, out - line) < 0) return;
+    }
+}
+
+static inline gboolean log_dump_on_signal(gpointer user_data) {
+    (void)user_data;
+    log_dump(STDERR_FILENO);
+    return G_SOURCE_CONTINUE;
+}
+
+static inline void log_crash_handler(int sig) {
+    log_dump(STDERR_FILENO);
+    // SA_RESETHAND restored the default action; let it run
+    raise(sig);
+}
+
+// Parse WELCOME_DEBUG, dump the ring on SIGUSR2 and on fatal signals
+static inline void log_init(void) {
+    log_enabled_domains = g_parse_debug_string(g_getenv("WELCOME_DEBUG"),
+                                               log_domain_keys, G_N_ELEMENTS(log_domain_keys));
+
+    g_unix_signal_add(SIGUSR2, log_dump_on_signal, NULL);
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = log_crash_handler;
+    sa.sa_flags = SA_RESETHAND;
+    sigemptyset(&sa.sa_mask);
+    const int fatal_signals[] = { SIGSEGV, SIGABRT, SIGBUS, SIGFPE, SIGILL };
+    for (guint i = 0; i < G_N_ELEMENTS(fatal_signals); i++) {
+        sigaction(fatal_signals[i], &sa, NULL);
+    }
+}
+
+#endif // LOGGING_H
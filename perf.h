@@ -0,0 +1,171 @@
+#ifndef PERF_H
+#define PERF_H
+
+#include <glib.h>
+#include <stdarg.h>
+#include "logging.h"
+
+// Main-loop stall watchdog, enabled with WELCOME_WATCHDOG=<budget ms>
+// (an empty or non-numeric value means 16 ms, one frame at 60 Hz).
+//
+// The default context's poll function is wrapped so we know when the main
+// thread is busy (between two polls) and when it sleeps. A watchdog thread
+// reports iterations still running past the budget, naming the innermost
+// open span; when the iteration finally ends the main thread reports its
+// total length and the slowest span it contained. Spans that exceed the
+// budget on their own are reported with their detail string.
+
+#define PERF_DEFAULT_BUDGET_MS 16
+
+// 0 disables the watchdog; every span call is then a single branch
+static gint64 perf_budget_us = 0;
+
+static GMutex       perf_lock;
+static gint64       perf_iteration_start_us = 0;  // 0 while sleeping in poll
+static gboolean     perf_stall_reported = FALSE;
+static const char  *perf_current_span = NULL;     // innermost open span, main thread only
+static GPollFunc    perf_default_poll = NULL;
+
+// Slowest span of the running iteration, main thread only
+static const char  *perf_slowest_span = NULL;
+static gint64       perf_slowest_span_us = 0;
+
+typedef struct {
+    const char *name;
+    const char *parent;
+    gint64      start_us;
+} PerfSpan;
+
+static inline gboolean perf_enabled(void) {
+    return perf_budget_us > 0;
+}
+
+// Open a span; name must be a string that outlives the process (a literal)
+static inline PerfSpan perf_span_begin(const char *name) {
+    PerfSpan span = { name, NULL, 0 };
+    if (!perf_enabled()) return span;
+
+    g_mutex_lock(&perf_lock);
+    span.parent = perf_current_span;
+    perf_current_span = name;
+    g_mutex_unlock(&perf_lock);
+    span.start_us = g_get_monotonic_time();
+    return span;
+}
+
+static inline void perf_span_close(PerfSpan *span, const char *detail) {
+    if (span->start_us == 0) return;
+    gint64 elapsed_us = g_get_monotonic_time() - span->start_us;
+
+    g_mutex_lock(&perf_lock);
+    perf_current_span = span->parent;
+    g_mutex_unlock(&perf_lock);
+
+    if (elapsed_us > perf_slowest_span_us) {
+        perf_slowest_span = span->name;
+        perf_slowest_span_us = elapsed_us;
+    }
+    if (elapsed_us > perf_budget_us) {
+        log_message(LOG_PERF, "%s took %.1f ms%s%s", span->name, elapsed_us / 1000.0,
+                    detail ? " " : "", detail ? detail : "");
+    }
+    span->start_us = 0;
+}
+
+static inline void perf_span_end(PerfSpan *span) {
+    perf_span_close(span, NULL);
+}
+
+// Close a span with a detail shown in the report, e.g. "with %u APs".
+// The detail is only formatted when the span went over budget.
+static inline void perf_span_end_with(PerfSpan *span, const char *format, ...) G_GNUC_PRINTF(2, 3);
+
+static inline void perf_span_end_with(PerfSpan *span, const char *format, ...) {
+    if (span->start_us == 0) return;
+    if (g_get_monotonic_time() - span->start_us <= perf_budget_us) {
+        perf_span_close(span, NULL);
+        return;
+    }
+    va_list args;
+    va_start(args, format);
+    gchar *detail = g_strdup_vprintf(format, args);
+    va_end(args);
+    perf_span_close(span, detail);
+    g_free(detail);
+}
+
+static inline void perf_iteration_begin(void) {
+    g_mutex_lock(&perf_lock);
+    perf_iteration_start_us = g_get_monotonic_time();
+    perf_stall_reported = FALSE;
+    g_mutex_unlock(&perf_lock);
+    perf_slowest_span = NULL;
+    perf_slowest_span_us = 0;
+}
+
+static inline void perf_iteration_end(void) {
+    g_mutex_lock(&perf_lock);
+    gint64 start_us = perf_iteration_start_us;
+    perf_iteration_start_us = 0;
+    g_mutex_unlock(&perf_lock);
+
+    if (start_us == 0) return;
+    gint64 elapsed_us = g_get_monotonic_time() - start_us;
+    if (elapsed_us <= perf_budget_us) return;
+
+    if (perf_slowest_span) {
+        log_message(LOG_PERF, "main loop iteration took %.1f ms, slowest span %s (%.1f ms)",
+                    elapsed_us / 1000.0, perf_slowest_span, perf_slowest_span_us / 1000.0);
+    } else {
+        log_message(LOG_PERF, "main loop iteration took %.1f ms in uninstrumented code",
+                    elapsed_us / 1000.0);
+    }
+}
+
+static inline gint perf_poll(GPollFD *fds, guint nfds, gint timeout) {
+    perf_iteration_end();
+    gint ret = perf_default_poll(fds, nfds, timeout);
+    perf_iteration_begin();
+    return ret;
+}
+
+static inline gpointer perf_watchdog_thread(gpointer user_data) {
+    (void)user_data;
+    for (;;) {
+        g_usleep(perf_budget_us / 2);
+
+        g_mutex_lock(&perf_lock);
+        gint64 start_us = perf_iteration_start_us;
+        const char *span = perf_current_span;
+        gboolean report = start_us != 0 && !perf_stall_reported &&
+                          g_get_monotonic_time() - start_us > perf_budget_us;
+        if (report) perf_stall_reported = TRUE;
+        g_mutex_unlock(&perf_lock);
+
+        if (report) {
+            log_message(LOG_PERF, "main loop blocked for %.1f ms so far in %s",
+                        (g_get_monotonic_time() - start_us) / 1000.0,
+                        span ? span : "an uninstrumented callback");
+        }
+    }
+    return NULL;
+}
+
+// Install the poll wrapper and start the watchdog if WELCOME_WATCHDOG is set
+static inline void perf_init(void) {
+    const gchar *budget = g_getenv("WELCOME_WATCHDOG");
+    if (!budget) return;
+
+    gint64 budget_ms = g_ascii_strtoll(budget, NULL, 10);
+    if (budget_ms <= 0) budget_ms = PERF_DEFAULT_BUDGET_MS;
+    perf_budget_us = budget_ms * 1000;
+
+    perf_default_poll = g_main_context_get_poll_func(NULL);
+    g_main_context_set_poll_func(NULL, perf_poll);
+    perf_iteration_begin();
+
+    g_thread_unref(g_thread_new("welcome-watchdog", perf_watchdog_thread, NULL));
+    log_info(LOG_PERF, "Main-loop watchdog enabled, budget %" G_GINT64_FORMAT " ms", budget_ms);
+}
+
+#endif // PERF_H
@@ -0,0 +1,259 @@
+#ifndef RENDER_QUALITY_H
+#define RENDER_QUALITY_H
+
+#include <gtk/gtk.h>
+#include <string.h>
+#include "logging.h"
+
+// Render quality that adapts to how fast this machine paints.
+//
+// The wizard starts with 200 ms slides between pages. The first
+// RENDER_QUALITY_SAMPLE_TRANSITIONS stack transitions are timed on the
+// frame clock. Each one that misses its budget drops the quality by a
+// level:
+//
+//   full     slide, full-size textures
+//   reduced  150 ms crossfade, large textures box-filtered to half size or less
+//   minimal  no transition, reduced textures
+//
+// It only ever steps down. WELCOME_RENDER_QUALITY=full|reduced|minimal
+// pins a level and turns the measurement off. The decision and its reason
+// are logged and available from render_quality_describe().
+
+#define RENDER_QUALITY_SAMPLE_TRANSITIONS 3
+// A transition is over budget if more than a quarter of its frames were
+// missed, or if one frame took longer than this many refresh intervals
+#define RENDER_QUALITY_MAX_DROPPED_PCT    25
+#define RENDER_QUALITY_MAX_HITCH_FRAMES   4
+// Reduced textures are at least this wide: a GtkPicture's natural size is
+// its texture's, and this keeps them laid out as before in the 900 px window
+#define RENDER_QUALITY_REDUCED_WIDTH      960
+
+typedef enum {
+    RENDER_QUALITY_FULL,
+    RENDER_QUALITY_REDUCED,
+    RENDER_QUALITY_MINIMAL
+} RenderQualityLevel;
+
+typedef void (*RenderQualityChanged)(RenderQualityLevel level, gpointer user_data);
+
+static const char *render_quality_names[] = { "full", "reduced", "minimal" };
+
+static RenderQualityLevel    render_quality_level = RENDER_QUALITY_FULL;
+static gboolean              render_quality_pinned = FALSE;
+static gchar                *render_quality_reason = NULL;
+static GtkStack             *render_quality_stack = NULL;
+static gulong                render_quality_running_id = 0;
+static GdkFrameClock        *render_quality_clock = NULL;
+static gulong                render_quality_paint_id = 0;
+static RenderQualityChanged  render_quality_changed = NULL;
+static gpointer              render_quality_user_data = NULL;
+
+// The transition being timed
+static guint  render_quality_sampled = 0;
+static guint  render_quality_frames = 0;
+static guint  render_quality_dropped = 0;
+static gint64 render_quality_worst_us = 0;
+static gint64 render_quality_refresh_us = 0;
+static gint64 render_quality_last_frame = -1;
+static gint64 render_quality_last_paint_us = 0;
+
+static inline gboolean render_quality_reduced_textures(void) {
+    return render_quality_level >= RENDER_QUALITY_REDUCED;
+}
+
+// e.g. "reduced (transition 1: 9 of 14 frames missed, worst 83.2 ms)"
+static inline const char* render_quality_describe(void) {
+    static gchar *description = NULL;
+    g_free(description);
+    description = g_strdup_printf("%s (%s)", render_quality_names[render_quality_level],
+                                  render_quality_reason ? render_quality_reason : "default");
+    return description;
+}
+
+static inline void render_quality_apply_transition(GtkStack *stack) {
+    switch (render_quality_level) {
+    case RENDER_QUALITY_FULL:
+        gtk_stack_set_transition_type(stack, GTK_STACK_TRANSITION_TYPE_SLIDE_LEFT_RIGHT);
+        gtk_stack_set_transition_duration(stack, 200);
+        break;
+    case RENDER_QUALITY_REDUCED:
+        gtk_stack_set_transition_type(stack, GTK_STACK_TRANSITION_TYPE_CROSSFADE);
+        gtk_stack_set_transition_duration(stack, 150);
+        break;
+    case RENDER_QUALITY_MINIMAL:
+        gtk_stack_set_transition_type(stack, GTK_STACK_TRANSITION_TYPE_NONE);
+        break;
+    }
+}
+
+static inline void render_quality_set(RenderQualityLevel level, gchar *reason) {
+    g_free(render_quality_reason);
+    render_quality_reason = reason;
+    if (level == render_quality_level) return;
+    render_quality_level = level;
+    log_message(LOG_PERF, "Render quality: %s", render_quality_describe());
+    if (render_quality_stack) render_quality_apply_transition(render_quality_stack);
+    if (render_quality_changed) render_quality_changed(level, render_quality_user_data);
+}
+
+// Reads WELCOME_RENDER_QUALITY; call before anything loads textures
+static inline void render_quality_init(void) {
+    const gchar *env = g_getenv("WELCOME_RENDER_QUALITY");
+    if (!env || !*env || g_ascii_strcasecmp(env, "auto") == 0) return;
+    for (guint i = 0; i < G_N_ELEMENTS(render_quality_names); i++) {
+        if (g_ascii_strcasecmp(env, render_quality_names[i]) == 0) {
+            render_quality_pinned = TRUE;
+            render_quality_set((RenderQualityLevel) i, g_strdup("WELCOME_RENDER_QUALITY"));
+            return;
+        }
+    }
+    log_warning(LOG_PERF, "WELCOME_RENDER_QUALITY=%s: expected auto, full, reduced or minimal", env);
+}
+
+// Keep the current level and stop measuring (benchmarks, tests)
+static inline void render_quality_pin(RenderQualityLevel level, const char *why) {
+    render_quality_pinned = TRUE;
+    render_quality_set(level, g_strdup(why));
+}
+
+/* ---------- Measurement ---------- */
+
+static inline void render_quality_stop_timing(void) {
+    if (render_quality_paint_id) {
+        g_signal_handler_disconnect(render_quality_clock, render_quality_paint_id);
+        render_quality_paint_id = 0;
+    }
+    g_clear_object(&render_quality_clock);
+}
+
+static inline void render_quality_on_after_paint(GdkFrameClock *clock, gpointer user_data) {
+    (void)user_data;
+    gint64 now = g_get_monotonic_time();
+    gint64 frame = gdk_frame_clock_get_frame_counter(clock);
+
+    gint64 refresh_us = 0;
+    gdk_frame_clock_get_refresh_info(clock, 0, &refresh_us, NULL);
+    render_quality_refresh_us = refresh_us > 0 ? refresh_us : 16667;
+
+    // like the HUD: only back-to-back frames count, an idle gap is not a drop
+    if (render_quality_last_frame + 1 == frame) {
+        gint64 interval_us = now - render_quality_last_paint_us;
+        gint64 missed = (interval_us + render_quality_refresh_us / 2) / render_quality_refresh_us - 1;
+        if (missed > 0) render_quality_dropped += (guint) missed;
+        render_quality_worst_us = MAX(render_quality_worst_us, interval_us);
+    }
+    render_quality_frames++;
+    render_quality_last_frame = frame;
+    render_quality_last_paint_us = now;
+}
+
+static inline void render_quality_evaluate(void) {
+    render_quality_sampled++;
+    guint expected = render_quality_frames + render_quality_dropped;
+    gboolean dropping = expected > 0 && render_quality_dropped * 100 > expected * RENDER_QUALITY_MAX_DROPPED_PCT;
+    gboolean hitching = render_quality_worst_us > render_quality_refresh_us * RENDER_QUALITY_MAX_HITCH_FRAMES;
+    log_debug(LOG_PERF, "Render quality: transition %u at %s, %u of %u frames missed, worst %.1f ms",
+              render_quality_sampled, render_quality_names[render_quality_level],
+              render_quality_dropped, expected, render_quality_worst_us / 1000.0);
+
+    if ((dropping || hitching) && render_quality_level < RENDER_QUALITY_MINIMAL) {
+        render_quality_set((RenderQualityLevel) (render_quality_level + 1),
+                           g_strdup_printf("transition %u: %u of %u frames missed, worst %.1f ms",
+                                           render_quality_sampled, render_quality_dropped, expected,
+                                           render_quality_worst_us / 1000.0));
+    } else if (render_quality_level == RENDER_QUALITY_FULL) {
+        // a step down keeps the reason it was taken for
+        g_free(render_quality_reason);
+        render_quality_reason = g_strdup_printf("%u transition%s within budget", render_quality_sampled,
+                                                render_quality_sampled == 1 ? "" : "s");
+    }
+}
+
+static inline gboolean render_quality_measuring(void) {
+    return !render_quality_pinned && render_quality_sampled < RENDER_QUALITY_SAMPLE_TRANSITIONS &&
+           render_quality_level < RENDER_QUALITY_MINIMAL;
+}
+
+static inline void render_quality_on_transition_running(GObject *object, GParamSpec *pspec, gpointer user_data) {
+    (void)pspec; (void)user_data;
+    GtkStack *stack = GTK_STACK(object);
+
+    if (gtk_stack_get_transition_running(stack)) {
+        if (!render_quality_measuring() || render_quality_paint_id) return;
+        GdkFrameClock *clock = gtk_widget_get_frame_clock(GTK_WIDGET(stack));
+        if (!clock) return;
+        render_quality_frames = render_quality_dropped = 0;
+        render_quality_worst_us = 0;
+        render_quality_last_frame = -1;
+        render_quality_clock = GDK_FRAME_CLOCK(g_object_ref(clock));
+        render_quality_paint_id = g_signal_connect(clock, "after-paint", G_CALLBACK(render_quality_on_after_paint), NULL);
+        return;
+    }
+
+    if (!render_quality_paint_id) return;
+    render_quality_stop_timing();
+    render_quality_evaluate();
+}
+
+// Apply the level to stack and time its first transitions; changed runs on
+// the main thread whenever the level drops
+static inline void render_quality_attach(GtkStack *stack, RenderQualityChanged changed, gpointer user_data) {
+    render_quality_stack = stack;
+    render_quality_changed = changed;
+    render_quality_user_data = user_data;
+    render_quality_apply_transition(stack);
+    render_quality_running_id = g_signal_connect(stack, "notify::transition-running",
+                                                 G_CALLBACK(render_quality_on_transition_running), NULL);
+}
+
+static inline void render_quality_detach(void) {
+    if (!render_quality_stack) return;
+    render_quality_stop_timing();
+    g_signal_handler_disconnect(render_quality_stack, render_quality_running_id);
+    render_quality_running_id = 0;
+    render_quality_stack = NULL;
+    render_quality_changed = NULL;
+    render_quality_user_data = NULL;
+}
+
+/* ---------- Reduced textures ---------- */
+
+// Box-filtered copy of texture at 1/n size, with n chosen so the result
+// stays at least RENDER_QUALITY_REDUCED_WIDTH wide; a new reference to
+// texture itself if it is already small. Safe on any thread.
+static inline GdkTexture* render_quality_reduce_texture(GdkTexture *texture) {
+    int width = gdk_texture_get_width(texture);
+    int height = gdk_texture_get_height(texture);
+    int factor = width / RENDER_QUALITY_REDUCED_WIDTH;
+    if (factor < 2) return GDK_TEXTURE(g_object_ref(texture));
+
+    // premultiplied, so plain averaging is correct at transparent edges
+    gsize stride = (gsize) width * 4;
+    guchar *pixels = (guchar*) g_malloc(stride * height);
+    gdk_texture_download(texture, pixels, stride);
+
+    int out_width = width / factor, out_height = height / factor;
+    gsize out_stride = (gsize) out_width * 4;
+    guchar *out = (guchar*) g_malloc(out_stride * out_height);
+    guint area = (guint) (factor * factor);
+    for (int y = 0; y < out_height; y++) {
+        for (int x = 0; x < out_width; x++) {
+            guint sum[4] = { 0, 0, 0, 0 };
+            for (int dy = 0; dy < factor; dy++) {
+                const guchar *src = pixels + (gsize) (y * factor + dy) * stride + (gsize) x * factor * 4;
+                for (int i = 0; i < factor * 4; i++) sum[i & 3] += src[i];
+            }
+            guchar *dst = out + (gsize) y * out_stride + (gsize) x * 4;
+            for (int c = 0; c < 4; c++) dst[c] = (guchar) ((sum[c] + area / 2) / area);
+        }
+    }
+    g_free(pixels);
+
+    GBytes *bytes = g_bytes_new_take(out, out_stride * out_height);
+    GdkTexture *reduced = gdk_memory_texture_new(out_width, out_height, GDK_MEMORY_DEFAULT, bytes, out_stride);
+    g_bytes_unref(bytes);
+    return reduced;
+}
+
+#endif // RENDER_QUALITY_H
@@ -0,0 +1,79 @@
+#ifndef STARTUP_H
+#define STARTUP_H
+
+#include <gtk/gtk.h>
+#include <unistd.h>
+#include "logging.h"
+
+// Startup milestones for tools/coldstart. With WELCOME_STARTUP_FD=<fd> set
+// the app writes "<milestone> <CLOCK_MONOTONIC us>\n" lines to that fd:
+//
+//   first-frame  the window's first frame has been painted
+//   interactive  after the first frame, every startup_hold() has been
+//                released and the main loop has gone idle
+//
+// The harness compares them with its own timestamp taken before exec.
+// Without the variable nothing is hooked up.
+
+static int    startup_fd = -1;
+static gulong startup_paint_id = 0;
+static guint  startup_holds = 0;
+static gboolean startup_painted = FALSE;
+static gboolean startup_done = FALSE;
+
+static inline void startup_write(const char *milestone) {
+    char line[64];
+    int len = g_snprintf(line, sizeof(line), "%s %" G_GINT64_FORMAT "\n", milestone, g_get_monotonic_time());
+    if (write(startup_fd, line, len) < 0) startup_fd = -1;
+    log_debug(LOG_PERF, "startup milestone: %s", milestone);
+}
+
+static inline gboolean startup_on_idle(gpointer user_data) {
+    (void)user_data;
+    // another hold may have started while we were queued
+    if (startup_holds == 0 && !startup_done) {
+        startup_done = TRUE;
+        startup_write("interactive");
+    }
+    return G_SOURCE_REMOVE;
+}
+
+static inline void startup_maybe_interactive(void) {
+    if (startup_fd < 0 || startup_done || !startup_painted || startup_holds > 0) return;
+    g_idle_add_full(G_PRIORITY_LOW, startup_on_idle, NULL, NULL);
+}
+
+static inline void startup_on_after_paint(GdkFrameClock *clock, gpointer user_data) {
+    (void)user_data;
+    g_signal_handler_disconnect(clock, startup_paint_id);
+    startup_paint_id = 0;
+    startup_painted = TRUE;
+    startup_write("first-frame");
+    startup_maybe_interactive();
+}
+
+// Work that must finish before the app counts as interactive
+static inline void startup_hold(void) {
+    startup_holds++;
+}
+
+static inline void startup_release(void) {
+    g_return_if_fail(startup_holds > 0);
+    startup_holds--;
+    startup_maybe_interactive();
+}
+
+static inline void startup_on_realize(GtkWidget *window, gpointer user_data) {
+    (void)user_data;
+    GdkFrameClock *clock = gtk_widget_get_frame_clock(window);
+    if (clock) startup_paint_id = g_signal_connect(clock, "after-paint", G_CALLBACK(startup_on_after_paint), NULL);
+}
+
+static inline void startup_attach(GtkWidget *window) {
+    const gchar *fd = g_getenv("WELCOME_STARTUP_FD");
+    if (!fd || !*fd) return;
+    startup_fd = (int) g_ascii_strtoll(fd, NULL, 10);
+    g_signal_connect(window, "realize", G_CALLBACK(startup_on_realize), NULL);
+}
+
+#endif // STARTUP_H
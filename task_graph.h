@@ -0,0 +1,310 @@
+#ifndef TASK_GRAPH_H
+#define TASK_GRAPH_H
+
+#include <glib.h>
+#include <gio/gio.h>
+#include <stdarg.h>
+#include <string.h>
+#include "logging.h"
+
+// Dependency graph for startup work.
+//
+// Each task names the tasks it depends on and starts as soon as all of them
+// are done: TASK_ON_THREAD tasks on a worker thread of their own,
+// TASK_ON_MAIN tasks inline on the main thread, and TASK_ASYNC tasks start
+// on the main thread and finish later through task_graph_complete(). An
+// ASYNC task without a func is a milestone that other code completes, e.g.
+// "pages" once the widget tree exists.
+//
+// Nothing ever waits for a task. Code that needs a result is itself a task
+// depending on it (a TASK_ON_MAIN one for main-thread work) and reads it
+// with task_graph_result() or task_graph_take(); code outside the graph
+// checks the state and falls back when the task is not done yet.
+//
+// The graph and its tasks belong to the main thread. Worker threads only run
+// func and hand the result back through an idle. The finished callback runs
+// from inside whatever completed the last task, so it must not drop the last
+// reference there; release the graph from an idle instead.
+
+typedef enum {
+    TASK_ON_MAIN,
+    TASK_ON_THREAD,
+    TASK_ASYNC
+} TaskKind;
+
+typedef enum {
+    TASK_PENDING,
+    TASK_RUNNING,
+    TASK_DONE
+} TaskState;
+
+#define TASK_MAX_DEPS 4
+
+typedef struct TaskGraph TaskGraph;
+typedef struct TaskNode TaskNode;
+
+// ON_MAIN and ON_THREAD funcs return the result; ASYNC funcs return NULL and
+// pass their result to task_graph_complete() later
+typedef gpointer (*TaskFunc)(TaskNode *task, gpointer user_data);
+typedef void (*TaskGraphFinished)(TaskGraph *graph, gpointer user_data);
+
+struct TaskNode {
+    const char    *name;        // a literal
+    TaskKind       kind;
+    TaskFunc       func;
+    gpointer       user_data;
+    GDestroyNotify result_free;
+    const char    *deps[TASK_MAX_DEPS];
+    gpointer       inputs[TASK_MAX_DEPS];       // results of deps[], copied when the task starts
+    TaskState      state;
+    gpointer       result;
+    gpointer       thread_result;   // written by the worker, read in the idle
+    TaskGraph     *graph;
+    gint64         start_us;
+    gint64         end_us;
+};
+
+struct TaskGraph {
+    GPtrArray        *tasks;         // TaskNode*
+    GCancellable     *cancellable;   // for ASYNC funcs to pass on
+    gint              ref_count;
+    gint64            start_us;
+    gboolean          started;
+    gboolean          finished;
+    TaskGraphFinished on_finished;
+    gpointer          finished_data;
+};
+
+static inline void task_graph_schedule(TaskGraph *graph);
+
+static inline TaskGraph* task_graph_new(TaskGraphFinished on_finished, gpointer user_data) {
+    TaskGraph *graph = g_new0(TaskGraph, 1);
+    graph->tasks = g_ptr_array_new_with_free_func(g_free);
+    graph->cancellable = g_cancellable_new();
+    graph->ref_count = 1;
+    graph->on_finished = on_finished;
+    graph->finished_data = user_data;
+    return graph;
+}
+
+static inline TaskGraph* task_graph_ref(TaskGraph *graph) {
+    graph->ref_count++;
+    return graph;
+}
+
+static inline void task_graph_unref(TaskGraph *graph) {
+    if (--graph->ref_count > 0) return;
+    for (guint i = 0; i < graph->tasks->len; i++) {
+        TaskNode *task = (TaskNode*) g_ptr_array_index(graph->tasks, i);
+        if (task->result && task->result_free) task->result_free(task->result);
+    }
+    g_ptr_array_unref(graph->tasks);
+    g_object_unref(graph->cancellable);
+    g_free(graph);
+}
+
+static inline TaskNode* task_graph_find(TaskGraph *graph, const char *name) {
+    for (guint i = 0; i < graph->tasks->len; i++) {
+        TaskNode *task = (TaskNode*) g_ptr_array_index(graph->tasks, i);
+        if (g_strcmp0(task->name, name) == 0) return task;
+    }
+    return NULL;
+}
+
+// Add a task depending on a NULL-terminated list of task names (at most
+// TASK_MAX_DEPS). Tasks may be added after task_graph_start(); dependencies added later
+// than their dependents are fine as long as they exist before they are needed.
+static inline TaskNode* task_graph_add(TaskGraph *graph, const char *name, TaskKind kind, TaskFunc func,
+                                       gpointer user_data, GDestroyNotify result_free, ...) G_GNUC_NULL_TERMINATED;
+
+static inline TaskNode* task_graph_add(TaskGraph *graph, const char *name, TaskKind kind, TaskFunc func,
+                                       gpointer user_data, GDestroyNotify result_free, ...) {
+    const char *deps[TASK_MAX_DEPS] = { NULL };
+    guint n = 0;
+    gboolean too_many = FALSE;
+    va_list args;
+    va_start(args, result_free);
+    const char *dep;
+    while ((dep = va_arg(args, const char*)) != NULL) {
+        if (n < G_N_ELEMENTS(deps)) deps[n++] = dep;
+        else too_many = TRUE;
+    }
+    va_end(args);
+
+    g_return_val_if_fail(!too_many, NULL);
+    g_return_val_if_fail(task_graph_find(graph, name) == NULL, NULL);
+    TaskNode *task = g_new0(TaskNode, 1);
+    task->name = name;
+    task->kind = kind;
+    task->func = func;
+    task->user_data = user_data;
+    task->result_free = result_free;
+    task->graph = graph;
+    memcpy(task->deps, deps, sizeof(deps));
+
+    g_ptr_array_add(graph->tasks, task);
+    if (graph->started) task_graph_schedule(graph);
+    return task;
+}
+
+static inline gboolean task_graph_deps_done(TaskGraph *graph, TaskNode *task) {
+    for (guint i = 0; i < G_N_ELEMENTS(task->deps) && task->deps[i]; i++) {
+        TaskNode *dep = task_graph_find(graph, task->deps[i]);
+        if (!dep || dep->state != TASK_DONE) return FALSE;
+    }
+    return TRUE;
+}
+
+static inline void task_graph_log_summary(TaskGraph *graph) {
+    if (!log_enabled(LOG_PERF)) return;
+    static const char *kind_names[] = { "main", "thread", "async" };
+    gint64 busy_us = 0, end_us = graph->start_us;
+    for (guint i = 0; i < graph->tasks->len; i++) {
+        TaskNode *task = (TaskNode*) g_ptr_array_index(graph->tasks, i);
+        if (task->start_us == 0) {
+            log_debug(LOG_PERF, "task %-12s skipped", task->name);
+            continue;
+        }
+        if (task->func) busy_us += task->end_us - task->start_us;
+        end_us = MAX(end_us, task->end_us);
+        log_debug(LOG_PERF, "task %-12s %-6s start +%.1f ms, took %.1f ms",
+                  task->name, kind_names[task->kind], (task->start_us - graph->start_us) / 1000.0,
+                  (task->end_us - task->start_us) / 1000.0);
+    }
+    log_debug(LOG_PERF, "task graph: %.1f ms wall for %.1f ms of task time",
+              (end_us - graph->start_us) / 1000.0, busy_us / 1000.0);
+}
+
+static inline void task_graph_check_finished(TaskGraph *graph) {
+    if (graph->finished) return;
+    for (guint i = 0; i < graph->tasks->len; i++) {
+        if (((TaskNode*) g_ptr_array_index(graph->tasks, i))->state != TASK_DONE) return;
+    }
+    graph->finished = TRUE;
+    task_graph_log_summary(graph);
+    if (graph->on_finished) graph->on_finished(graph, graph->finished_data);
+}
+
+static inline void task_node_finish(TaskNode *task, gpointer result) {
+    TaskGraph *graph = task->graph;
+    task->end_us = g_get_monotonic_time();
+    task->state = TASK_DONE;
+    // a cancelled graph has nobody left to hand results to
+    if (g_cancellable_is_cancelled(graph->cancellable)) {
+        if (result && task->result_free) task->result_free(result);
+    } else {
+        task->result = result;
+    }
+    task_graph_schedule(graph);
+    task_graph_check_finished(graph);
+}
+
+static inline gboolean task_node_on_thread_done(gpointer data) {
+    TaskNode *task = (TaskNode*) data;
+    TaskGraph *graph = task->graph;
+    task_node_finish(task, task->thread_result);
+    task->thread_result = NULL;
+    task_graph_unref(graph);
+    return G_SOURCE_REMOVE;
+}
+
+static inline gpointer task_node_thread(gpointer data) {
+    TaskNode *task = (TaskNode*) data;
+    task->thread_result = task->func(task, task->user_data);
+    // high priority: its dependents should not queue behind redraws
+    g_idle_add_full(G_PRIORITY_HIGH, task_node_on_thread_done, task, NULL);
+    return NULL;
+}
+
+static inline void task_node_start(TaskNode *task) {
+    for (guint i = 0; i < G_N_ELEMENTS(task->deps) && task->deps[i]; i++) {
+        task->inputs[i] = task_graph_find(task->graph, task->deps[i])->result;
+    }
+    task->state = TASK_RUNNING;
+    task->start_us = g_get_monotonic_time();
+    switch (task->kind) {
+    case TASK_ON_THREAD:
+        task_graph_ref(task->graph);
+        g_thread_unref(g_thread_new(task->name, task_node_thread, task));
+        break;
+    case TASK_ON_MAIN:
+        task_node_finish(task, task->func(task, task->user_data));
+        break;
+    case TASK_ASYNC:
+        if (task->func) task->func(task, task->user_data);
+        break;
+    }
+}
+
+// Start every pending task whose dependencies are done. Threads go first so
+// they overlap with main-thread tasks started in the same pass.
+static inline void task_graph_schedule(TaskGraph *graph) {
+    if (!graph->started) return;
+    gboolean cancelled = g_cancellable_is_cancelled(graph->cancellable);
+    for (guint i = 0; i < graph->tasks->len; i++) {
+        TaskNode *task = (TaskNode*) g_ptr_array_index(graph->tasks, i);
+        if (task->state == TASK_PENDING && task->kind == TASK_ON_THREAD && !cancelled &&
+            task_graph_deps_done(graph, task)) {
+            task_node_start(task);
+        }
+    }
+    // starting a main task can finish it and recurse into this function,
+    // so look each one up again rather than trusting the loop state
+    for (guint i = 0; i < graph->tasks->len; i++) {
+        TaskNode *task = (TaskNode*) g_ptr_array_index(graph->tasks, i);
+        if (task->state == TASK_PENDING && task->kind != TASK_ON_THREAD && !cancelled &&
+            task_graph_deps_done(graph, task)) {
+            task_node_start(task);
+        }
+    }
+}
+
+static inline void task_graph_start(TaskGraph *graph) {
+    graph->started = TRUE;
+    graph->start_us = g_get_monotonic_time();
+    task_graph_schedule(graph);
+    task_graph_check_finished(graph);
+}
+
+// Finish an ASYNC task (or milestone) with its result
+static inline void task_graph_complete(TaskGraph *graph, const char *name, gpointer result) {
+    TaskNode *task = task_graph_find(graph, name);
+    g_return_if_fail(task != NULL && task->kind == TASK_ASYNC);
+    if (task->state == TASK_DONE && g_cancellable_is_cancelled(graph->cancellable)) {
+        if (result && task->result_free) task->result_free(result);
+        return;
+    }
+    g_return_if_fail(task->state != TASK_DONE);
+    if (task->state == TASK_PENDING) task->start_us = g_get_monotonic_time();
+    task_node_finish(task, result);
+}
+
+// The result of a finished task, still owned by the graph; NULL for unknown
+// or unfinished tasks and once the graph is cancelled
+static inline gpointer task_graph_result(TaskGraph *graph, const char *name) {
+    TaskNode *task = task_graph_find(graph, name);
+    return task && task->state == TASK_DONE ? task->result : NULL;
+}
+
+// task_graph_result(), but the caller takes ownership of the result
+static inline gpointer task_graph_take(TaskGraph *graph, const char *name) {
+    gpointer result = task_graph_result(graph, name);
+    if (result) task_graph_find(graph, name)->result = NULL;
+    return result;
+}
+
+// Stop starting tasks and drop results as they arrive. Running threads and
+// ASYNC tasks still complete (ASYNC funcs should watch graph->cancellable);
+// the graph reports finished once they have.
+static inline void task_graph_cancel(TaskGraph *graph) {
+    g_cancellable_cancel(graph->cancellable);
+    for (guint i = 0; i < graph->tasks->len; i++) {
+        TaskNode *task = (TaskNode*) g_ptr_array_index(graph->tasks, i);
+        if (task->result && task->result_free) task->result_free(task->result);
+        task->result = NULL;
+        if (task->state == TASK_PENDING) task->state = TASK_DONE;
+    }
+    task_graph_check_finished(graph);
+}
+
+#endif // TASK_GRAPH_H
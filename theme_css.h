@@ -0,0 +1,82 @@
+#ifndef THEME_CSS_H
+#define THEME_CSS_H
+
+// Application CSS, installed once at startup and never reloaded.
+//
+// The rules are light by default. Dark overrides only match inside a
+// widget carrying THEME_DARK_CLASS. That class is set on scope roots: each
+// stack page and the page indicators. The window itself uses
+// THEME_DARK_WINDOW_CLASS, a different class, so that the dark page rules
+// do not match through it. A theme switch then only restyles the scopes
+// whose class actually changes (see apply_theme_scope() in welcome.cpp).
+// Page roots set their own text colour, so a hidden page does not follow
+// the window colour before its own scope is switched.
+
+#define THEME_SCOPE_CLASS       "theme-scope"
+#define THEME_DARK_CLASS        "theme-dark"
+#define THEME_DARK_WINDOW_CLASS "dark-window"
+
+static const char theme_css[] =
+    "window { background-color: #ffedfa; color: #333;}"
+    "window {font-family: ElysiaOSNew12;} "
+    "window.dark-window { background-color: #333; color: #ffffff;}"
+    ".theme-scope { color: #333; }"
+    ".theme-scope.theme-dark { color: #ffffff; }"
+    ".display-1 {font-size: 34px; }"
+    ".display-2 {font-size: 28px; font-weight: bold; }"
+    ".page-indicators { margin: 20px; }"
+    ".page-dot { min-width:12px; min-height:12px; border-radius:6px; margin:0 4px; }"
+    ".active-dot { background-color: #fc77d9; }"
+    ".inactive-dot { background-color: #c0c0c0; }"
+    ".theme-dark .inactive-dot { background-color: #666; }"
+    ".theme-card { border-radius:16px; border:2px solid #e0e0e0; background:#fafafa; padding:8px; color: #333; background-size: cover; background-position: center; width: 180px; height: 120px; }"  // Fixed size
+    ".theme-dark .theme-card { border-color: #555; background: #444; color: #ffffff; }"
+    ".theme-card:hover { border-color:#fc77d9; }"
+    ".theme-selected { border-color:#fc77d9 !important; background:#f0f7ff !important; }"
+    ".theme-dark .theme-selected { border-color:#fc77d9 !important; background:#555 !important; }"
+    ".theme-card image { -gtk-icon-style: regular; }"
+    ".theme-label { background: rgba(255, 255, 255, 0.7); color: black; padding: 4px 8px; border-radius: 6px; font-size: 14px; }"
+    ".theme-dark .theme-label { background: rgba(0, 0, 0, 0.7); color: white; }"
+    ".theme-card picture { min-width: 160px; min-height: 80px; max-width: 160px; max-height: 80px; }"
+    "#light-theme-button { background-image: url('/org/elysiaos/welcome/light.png'); }"
+    "#dark-theme-button { background-image: url('/org/elysiaos/welcome/dark.png'); }"
+    ".scrolled-window {"
+    "  background: transparent;"
+    "  border: none;"
+    "}"
+    ".scrolled-window scrollbar {"
+    "  background: transparent;"
+    "}"
+    ".scrolled-window scrollbar slider {"
+    "  background: rgba(0, 0, 0, 0.3);"
+    "  border-radius: 6px;"
+    "  min-width: 8px;"
+    "}"
+    ".scrolled-window scrollbar slider:hover {"
+    "  background: rgba(0, 0, 0, 0.5);"
+    "}"
+    ".theme-dark .scrolled-window scrollbar slider {"
+    "  background: rgba(255, 255, 255, 0.3);"
+    "}"
+    ".theme-dark .scrolled-window scrollbar slider:hover {"
+    "  background: rgba(255, 255, 255, 0.5);"
+    "}"
+    ".tip-label {"
+    "  font-family: ElysiaOSNew12;"
+    "  font-size: 10px;"
+    "  color: #8e8e93;"
+    "  margin: 8px 0px;"
+    "  font-style: italic;"
+    "}"
+    ".title-3 {"
+    "  font-size: 18px;"
+    "  font-weight: normal;"
+    "}"
+    ".dim-label {"
+    "  color: #666;"
+    "}"
+    ".theme-dark .dim-label {"
+    "  color: inherit;"
+    "}";
+
+#endif // THEME_CSS_H
@@ -0,0 +1,271 @@
+/* coldstart: launch elysia-welcome repeatedly and report startup percentiles
+ * for cold and warm page caches.
+ *
+ *   tools/coldstart [-n RUNS] [--binary PATH] [--evict PATH]... [-- APP ARGS]
+ *
+ * A cold run first drops every file the app touches from the page cache
+ * with posix_fadvise(POSIX_FADV_DONTNEED). That covers the binary (which
+ * embeds the gresource data), the shared libraries from ldd, and every
+ * file mapped by an earlier run, such as dlopened GIO/pixbuf modules,
+ * fonts and icon caches. A warm run follows each cold one directly.
+ * The app reports "first-frame" and "interactive" through
+ * WELCOME_STARTUP_FD (see startup.h). Both are measured from just before
+ * exec and summarised as p50/p95.
+ *
+ * DONTNEED can only drop clean pages that no process has mapped. Libraries
+ * a running desktop shares with the app (libc, GLib, GTK) stay cached, so
+ * a cold run here is the best case of a true first login. Run it from a
+ * console or a minimal session for numbers closer to live media. Files on
+ * squashfs are dropped the same way; its decompressed block cache is not.
+ */
+
+#include <gio/gio.h>
+#include <glib-unix.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <cstring>
+
+#define COLDSTART_TIMEOUT_US (30 * G_USEC_PER_SEC)
+
+static gint    opt_runs = 10;
+static gchar  *opt_binary = NULL;
+static gchar **opt_evict = NULL;
+
+static const GOptionEntry option_entries[] = {
+    { "runs", 'n', 0, G_OPTION_ARG_INT, &opt_runs, "Cold/warm launch pairs (default 10)", "N" },
+    { "binary", 0, 0, G_OPTION_ARG_FILENAME, &opt_binary, "App to launch (default ./elysia-welcome)", "PATH" },
+    { "evict", 0, 0, G_OPTION_ARG_FILENAME_ARRAY, &opt_evict, "Also evict this file before cold runs (repeatable)", "PATH" },
+    { NULL, 0, 0, G_OPTION_ARG_NONE, NULL, NULL, NULL }
+};
+
+typedef struct {
+    GArray *first_frame_us;   // gint64
+    GArray *interactive_us;   // gint64
+    guint   failures;
+} Series;
+
+/* ---------- Page cache ---------- */
+
+static GHashTable *evict_paths = NULL;   // set of file paths
+
+static void add_ldd_libraries(const gchar *binary) {
+    const gchar *argv[] = { "ldd", binary, NULL };
+    gchar *out = NULL;
+    if (!g_spawn_sync(NULL, (gchar**) argv, NULL, G_SPAWN_SEARCH_PATH | G_SPAWN_STDERR_TO_DEV_NULL,
+                      NULL, NULL, &out, NULL, NULL, NULL)) {
+        return;
+    }
+    gchar **lines = g_strsplit(out, "\n", -1);
+    for (gchar **l = lines; *l; l++) {
+        // "libfoo.so.1 => /usr/lib/libfoo.so.1 (0x...)" or "/lib64/ld-linux... (0x...)"
+        const gchar *path = strstr(*l, "=> ");
+        path = path ? path + 3 : g_strchug(*l);
+        if (*path != '/') continue;
+        const gchar *end = strchr(path, ' ');
+        g_hash_table_add(evict_paths, end ? g_strndup(path, end - path) : g_strdup(path));
+    }
+    g_strfreev(lines);
+    g_free(out);
+}
+
+/* Files the running app has mapped: picks up dlopened modules and fonts */
+static void add_mapped_files(GPid pid) {
+    gchar *maps_path = g_strdup_printf("/proc/%d/maps", (int) pid);
+    gchar *maps = NULL;
+    if (g_file_get_contents(maps_path, &maps, NULL, NULL)) {
+        gchar **lines = g_strsplit(maps, "\n", -1);
+        for (gchar **l = lines; *l; l++) {
+            const gchar *path = strchr(*l, '/');
+            if (path && !g_str_has_prefix(path, "/dev/") && !strstr(path, " (deleted)") &&
+                g_file_test(path, G_FILE_TEST_IS_REGULAR)) {
+                g_hash_table_add(evict_paths, g_strdup(path));
+            }
+        }
+        g_strfreev(lines);
+        g_free(maps);
+    }
+    g_free(maps_path);
+}
+
+static guint evict_page_cache(void) {
+    guint evicted = 0;
+    GHashTableIter iter;
+    gpointer path;
+    g_hash_table_iter_init(&iter, evict_paths);
+    while (g_hash_table_iter_next(&iter, &path, NULL)) {
+        int fd = open((const gchar*) path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) continue;
+        fdatasync(fd);
+        if (posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0) evicted++;
+        close(fd);
+    }
+    return evicted;
+}
+
+/* ---------- One launch ---------- */
+
+static gboolean parse_milestone(const gchar *line, const gchar *name, gint64 *value) {
+    gsize len = strlen(name);
+    if (strncmp(line, name, len) != 0 || line[len] != ' ') return FALSE;
+    *value = g_ascii_strtoll(line + len + 1, NULL, 10);
+    return TRUE;
+}
+
+/* Launch once; returns FALSE if the app exited or timed out before it
+   became interactive */
+static gboolean launch_once(gchar **app_argv, gboolean collect_maps, gint64 *first_frame_us, gint64 *interactive_us) {
+    int fds[2];
+    if (!g_unix_open_pipe(fds, FD_CLOEXEC, NULL)) return FALSE;
+
+    GSubprocessLauncher *launcher = g_subprocess_launcher_new(
+        (GSubprocessFlags) (G_SUBPROCESS_FLAGS_STDOUT_SILENCE | G_SUBPROCESS_FLAGS_STDERR_SILENCE));
+    g_subprocess_launcher_take_fd(launcher, fds[1], 3);
+    g_subprocess_launcher_setenv(launcher, "WELCOME_STARTUP_FD", "3", TRUE);
+
+    GError *error = NULL;
+    gint64 exec_us = g_get_monotonic_time();
+    GSubprocess *proc = g_subprocess_launcher_spawnv(launcher, (const gchar* const*) app_argv, &error);
+    g_object_unref(launcher);
+    if (!proc) {
+        g_printerr("coldstart: %s\n", error->message);
+        g_error_free(error);
+        close(fds[0]);
+        return FALSE;
+    }
+
+    /* The child inherited the write end; only it keeps the pipe open now,
+       so EOF means it exited */
+    gboolean interactive = FALSE;
+    *first_frame_us = *interactive_us = 0;
+    GString *buffer = g_string_new(NULL);
+    while (!interactive) {
+        gint64 remaining_ms = (COLDSTART_TIMEOUT_US - (g_get_monotonic_time() - exec_us)) / 1000;
+        struct pollfd pfd = { fds[0], POLLIN, 0 };
+        if (remaining_ms <= 0 || poll(&pfd, 1, (int) remaining_ms) <= 0) break;
+
+        char chunk[256];
+        ssize_t n = read(fds[0], chunk, sizeof(chunk));
+        if (n <= 0) break;
+        g_string_append_len(buffer, chunk, n);
+
+        gchar *newline;
+        while (!interactive && (newline = strchr(buffer->str, '\n'))) {
+            *newline = '\0';
+            gint64 at;
+            if (parse_milestone(buffer->str, "first-frame", &at)) *first_frame_us = at - exec_us;
+            if (parse_milestone(buffer->str, "interactive", &at)) {
+                *interactive_us = at - exec_us;
+                interactive = TRUE;
+            }
+            g_string_erase(buffer, 0, newline - buffer->str + 1);
+        }
+    }
+    g_string_free(buffer, TRUE);
+    close(fds[0]);
+
+    if (interactive && collect_maps) {
+        const gchar *pid = g_subprocess_get_identifier(proc);
+        if (pid) add_mapped_files((GPid) g_ascii_strtoll(pid, NULL, 10));
+    }
+
+    g_subprocess_send_signal(proc, SIGTERM);
+    g_subprocess_wait(proc, NULL, NULL);
+    g_object_unref(proc);
+    return interactive;
+}
+
+/* ---------- Reporting ---------- */
+
+static gint compare_gint64(gconstpointer a, gconstpointer b) {
+    gint64 x = *(const gint64*) a, y = *(const gint64*) b;
+    return (x > y) - (x < y);
+}
+
+static gint64 percentile(GArray *values, guint pct) {
+    g_array_sort(values, compare_gint64);
+    guint rank = (values->len * pct + 99) / 100;
+    return g_array_index(values, gint64, MAX(rank, 1) - 1);
+}
+
+static void report(const gchar *label, Series *s) {
+    if (s->first_frame_us->len == 0) {
+        g_print("%-6s no successful launches (%u failed)\n", label, s->failures);
+        return;
+    }
+    g_print("%-6s n=%-3u first frame p50 %7.1f ms  p95 %7.1f ms   interactive p50 %7.1f ms  p95 %7.1f ms%s\n",
+            label, s->first_frame_us->len,
+            percentile(s->first_frame_us, 50) / 1000.0, percentile(s->first_frame_us, 95) / 1000.0,
+            percentile(s->interactive_us, 50) / 1000.0, percentile(s->interactive_us, 95) / 1000.0,
+            s->failures ? "  (some launches failed)" : "");
+}
+
+static void record(Series *s, gboolean ok, gint64 first_frame_us, gint64 interactive_us) {
+    if (!ok) {
+        s->failures++;
+        return;
+    }
+    g_array_append_val(s->first_frame_us, first_frame_us);
+    g_array_append_val(s->interactive_us, interactive_us);
+}
+
+static Series series_new(void) {
+    Series s = { g_array_new(FALSE, FALSE, sizeof(gint64)), g_array_new(FALSE, FALSE, sizeof(gint64)), 0 };
+    return s;
+}
+
+/* ---------- main ---------- */
+
+int main(int argc, char *argv[]) {
+    GError *error = NULL;
+    GOptionContext *context = g_option_context_new("[-- APP ARGS] - cold and warm startup percentiles");
+    g_option_context_add_main_entries(context, option_entries, NULL);
+    if (!g_option_context_parse(context, &argc, &argv, &error)) {
+        g_printerr("coldstart: %s\n", error->message);
+        return 2;
+    }
+    g_option_context_free(context);
+
+    gchar *binary = g_canonicalize_filename(opt_binary ? opt_binary : "elysia-welcome", NULL);
+    if (!g_file_test(binary, G_FILE_TEST_IS_EXECUTABLE)) {
+        g_printerr("coldstart: %s is not executable\n", binary);
+        return 2;
+    }
+
+    /* app argv: the binary, then whatever followed "--" */
+    GPtrArray *app_argv = g_ptr_array_new();
+    g_ptr_array_add(app_argv, binary);
+    for (int i = 1; i < argc; i++) {
+        if (g_strcmp0(argv[i], "--") != 0) g_ptr_array_add(app_argv, argv[i]);
+    }
+    g_ptr_array_add(app_argv, NULL);
+
+    evict_paths = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    g_hash_table_add(evict_paths, g_strdup(binary));
+    add_ldd_libraries(binary);
+    for (gchar **p = opt_evict; p && *p; p++) g_hash_table_add(evict_paths, g_strdup(*p));
+
+    Series cold = series_new(), warm = series_new();
+    gint64 first_frame_us, interactive_us;
+
+    /* an untimed launch to learn which files the app maps at runtime */
+    launch_once((gchar**) app_argv->pdata, TRUE, &first_frame_us, &interactive_us);
+
+    for (gint run = 0; run < opt_runs; run++) {
+        guint evicted = evict_page_cache();
+        gboolean ok = launch_once((gchar**) app_argv->pdata, TRUE, &first_frame_us, &interactive_us);
+        record(&cold, ok, first_frame_us, interactive_us);
+        g_print("run %2d cold  %7.1f / %7.1f ms  (%u files evicted)\n", run + 1,
+                first_frame_us / 1000.0, interactive_us / 1000.0, evicted);
+
+        ok = launch_once((gchar**) app_argv->pdata, FALSE, &first_frame_us, &interactive_us);
+        record(&warm, ok, first_frame_us, interactive_us);
+        g_print("run %2d warm  %7.1f / %7.1f ms\n", run + 1, first_frame_us / 1000.0, interactive_us / 1000.0);
+    }
+
+    g_print("\n");
+    report("cold", &cold);
+    report("warm", &warm);
+    return cold.failures + warm.failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,1371 @@
+/* mock-nm: a stand-in NetworkManager for benchmarking the network page.
+ *
+ * Owns org.freedesktop.NetworkManager on whatever bus G_BUS_TYPE_SYSTEM
+ * resolves to, so pointing DBUS_SYSTEM_BUS_ADDRESS at a private
+ * dbus-daemon (see tools/run-with-mock-nm.sh) lets an unmodified NMClient
+ * talk to it. It exposes the parts of the NM D-Bus API libnm and the
+ * welcome app use: the manager, settings, Wi-Fi/ethernet devices, access
+ * points and active connections, published through
+ * org.freedesktop.DBus.ObjectManager like the real daemon.
+ *
+ * The initial state comes from the command line (--wifi-devices, --aps,
+ * --saved, ...). Afterwards it reads commands from stdin, one per line:
+ *
+ *   churn N               replace N access points on every Wi-Fi device
+ *   add-aps N             add N access points to every Wi-Fi device
+ *   remove-aps N          remove N access points from every Wi-Fi device
+ *   jitter                change the strength of every access point
+ *   burst N               flip every Wi-Fi device's state N times
+ *   wifi on|off           radio kill switch (WirelessEnabled)
+ *   networking on|off     NetworkingEnabled
+ *   sleep MS              wait before reading the next command
+ *   quit
+ *
+ * Everything random is drawn from a GRand seeded with --seed, so a given
+ * command line and command file always produce the same bus traffic.
+ */
+
+#include <gio/gio.h>
+#include <gio/gunixinputstream.h>
+#include <glib-unix.h>
+#include <signal.h>
+#include <unistd.h>
+#include <cstring>
+
+#define NM_DBUS_NAME      "org.freedesktop.NetworkManager"
+#define NM_DBUS_PATH      "/org/freedesktop/NetworkManager"
+#define NM_IFACE          "org.freedesktop.NetworkManager"
+#define SETTINGS_PATH     NM_DBUS_PATH "/Settings"
+#define SETTINGS_IFACE    NM_IFACE ".Settings"
+#define CONNECTION_IFACE  NM_IFACE ".Settings.Connection"
+#define DEVICE_IFACE      NM_IFACE ".Device"
+#define WIRELESS_IFACE    NM_IFACE ".Device.Wireless"
+#define WIRED_IFACE       NM_IFACE ".Device.Wired"
+#define AP_IFACE          NM_IFACE ".AccessPoint"
+#define ACTIVE_IFACE      NM_IFACE ".Connection.Active"
+#define OBJECT_MANAGER_PATH "/org/freedesktop"
+
+/* NM enum values, from nm-dbus-interface.h */
+enum {
+    NM_STATE_DISCONNECTED     = 20,
+    NM_STATE_CONNECTING       = 40,
+    NM_STATE_CONNECTED_GLOBAL = 70,
+
+    NM_DEVICE_TYPE_ETHERNET = 1,
+    NM_DEVICE_TYPE_WIFI     = 2,
+
+    NM_DEVICE_STATE_UNAVAILABLE  = 20,
+    NM_DEVICE_STATE_DISCONNECTED = 30,
+    NM_DEVICE_STATE_PREPARE      = 40,
+    NM_DEVICE_STATE_CONFIG       = 50,
+    NM_DEVICE_STATE_ACTIVATED    = 100,
+
+    NM_ACTIVE_STATE_ACTIVATING  = 1,
+    NM_ACTIVE_STATE_ACTIVATED   = 2,
+    NM_ACTIVE_STATE_DEACTIVATED = 4,
+
+    NM_ACTIVE_REASON_NONE              = 1,
+    NM_ACTIVE_REASON_USER_DISCONNECTED = 2,
+    NM_ACTIVE_REASON_NO_SECRETS        = 9,
+
+    NM_CONNECTIVITY_NONE = 1,
+    NM_CONNECTIVITY_FULL = 4,
+
+    NM_802_11_AP_FLAGS_PRIVACY     = 0x1,
+    NM_802_11_AP_SEC_KEY_MGMT_PSK  = 0x100,
+    NM_802_11_AP_SEC_PAIR_CCMP     = 0x8,
+    NM_802_11_AP_SEC_GROUP_CCMP    = 0x80,
+};
+
+/* ---------- Introspection ---------- */
+
+static const gchar introspection_xml[] = R"XML(
+<node>
+  <interface name="org.freedesktop.DBus.ObjectManager">
+    <method name="GetManagedObjects">
+      <arg name="objects" type="a{oa{sa{sv}}}" direction="out"/>
+    </method>
+    <signal name="InterfacesAdded">
+      <arg name="object_path" type="o"/>
+      <arg name="interfaces_and_properties" type="a{sa{sv}}"/>
+    </signal>
+    <signal name="InterfacesRemoved">
+      <arg name="object_path" type="o"/>
+      <arg name="interfaces" type="as"/>
+    </signal>
+  </interface>
+
+  <interface name="org.freedesktop.NetworkManager">
+    <method name="GetDevices"><arg name="devices" type="ao" direction="out"/></method>
+    <method name="GetAllDevices"><arg name="devices" type="ao" direction="out"/></method>
+    <method name="ActivateConnection">
+      <arg name="connection" type="o" direction="in"/>
+      <arg name="device" type="o" direction="in"/>
+      <arg name="specific_object" type="o" direction="in"/>
+      <arg name="active_connection" type="o" direction="out"/>
+    </method>
+    <method name="AddAndActivateConnection">
+      <arg name="connection" type="a{sa{sv}}" direction="in"/>
+      <arg name="device" type="o" direction="in"/>
+      <arg name="specific_object" type="o" direction="in"/>
+      <arg name="path" type="o" direction="out"/>
+      <arg name="active_connection" type="o" direction="out"/>
+    </method>
+    <method name="AddAndActivateConnection2">
+      <arg name="connection" type="a{sa{sv}}" direction="in"/>
+      <arg name="device" type="o" direction="in"/>
+      <arg name="specific_object" type="o" direction="in"/>
+      <arg name="options" type="a{sv}" direction="in"/>
+      <arg name="path" type="o" direction="out"/>
+      <arg name="active_connection" type="o" direction="out"/>
+      <arg name="result" type="a{sv}" direction="out"/>
+    </method>
+    <method name="DeactivateConnection"><arg name="active_connection" type="o" direction="in"/></method>
+    <method name="Enable"><arg name="enable" type="b" direction="in"/></method>
+    <method name="GetPermissions"><arg name="permissions" type="a{ss}" direction="out"/></method>
+    <method name="state"><arg name="state" type="u" direction="out"/></method>
+    <method name="CheckConnectivity"><arg name="connectivity" type="u" direction="out"/></method>
+    <signal name="CheckPermissions"/>
+    <signal name="StateChanged"><arg name="state" type="u"/></signal>
+    <signal name="DeviceAdded"><arg name="device_path" type="o"/></signal>
+    <signal name="DeviceRemoved"><arg name="device_path" type="o"/></signal>
+    <property name="Devices" type="ao" access="read"/>
+    <property name="AllDevices" type="ao" access="read"/>
+    <property name="Checkpoints" type="ao" access="read"/>
+    <property name="NetworkingEnabled" type="b" access="read"/>
+    <property name="WirelessEnabled" type="b" access="readwrite"/>
+    <property name="WirelessHardwareEnabled" type="b" access="read"/>
+    <property name="WwanEnabled" type="b" access="readwrite"/>
+    <property name="WwanHardwareEnabled" type="b" access="read"/>
+    <property name="ActiveConnections" type="ao" access="read"/>
+    <property name="PrimaryConnection" type="o" access="read"/>
+    <property name="PrimaryConnectionType" type="s" access="read"/>
+    <property name="Metered" type="u" access="read"/>
+    <property name="ActivatingConnection" type="o" access="read"/>
+    <property name="Startup" type="b" access="read"/>
+    <property name="Version" type="s" access="read"/>
+    <property name="Capabilities" type="au" access="read"/>
+    <property name="State" type="u" access="read"/>
+    <property name="Connectivity" type="u" access="read"/>
+    <property name="ConnectivityCheckAvailable" type="b" access="read"/>
+    <property name="ConnectivityCheckEnabled" type="b" access="readwrite"/>
+    <property name="GlobalDnsConfiguration" type="a{sv}" access="readwrite"/>
+  </interface>
+
+  <interface name="org.freedesktop.NetworkManager.Settings">
+    <method name="ListConnections"><arg name="connections" type="ao" direction="out"/></method>
+    <method name="GetConnectionByUuid">
+      <arg name="uuid" type="s" direction="in"/>
+      <arg name="connection" type="o" direction="out"/>
+    </method>
+    <method name="AddConnection">
+      <arg name="connection" type="a{sa{sv}}" direction="in"/>
+      <arg name="path" type="o" direction="out"/>
+    </method>
+    <method name="AddConnection2">
+      <arg name="settings" type="a{sa{sv}}" direction="in"/>
+      <arg name="flags" type="u" direction="in"/>
+      <arg name="args" type="a{sv}" direction="in"/>
+      <arg name="path" type="o" direction="out"/>
+      <arg name="result" type="a{sv}" direction="out"/>
+    </method>
+    <signal name="NewConnection"><arg name="connection" type="o"/></signal>
+    <signal name="ConnectionRemoved"><arg name="connection" type="o"/></signal>
+    <property name="Connections" type="ao" access="read"/>
+    <property name="Hostname" type="s" access="read"/>
+    <property name="CanModify" type="b" access="read"/>
+  </interface>
+
+  <interface name="org.freedesktop.NetworkManager.Settings.Connection">
+    <method name="GetSettings"><arg name="settings" type="a{sa{sv}}" direction="out"/></method>
+    <method name="GetSecrets">
+      <arg name="setting_name" type="s" direction="in"/>
+      <arg name="secrets" type="a{sa{sv}}" direction="out"/>
+    </method>
+    <method name="Update"><arg name="properties" type="a{sa{sv}}" direction="in"/></method>
+    <method name="Delete"/>
+    <signal name="Updated"/>
+    <signal name="Removed"/>
+    <property name="Unsaved" type="b" access="read"/>
+    <property name="Flags" type="u" access="read"/>
+    <property name="Filename" type="s" access="read"/>
+  </interface>
+
+  <interface name="org.freedesktop.NetworkManager.Device">
+    <method name="Disconnect"/>
+    <signal name="StateChanged">
+      <arg name="new_state" type="u"/>
+      <arg name="old_state" type="u"/>
+      <arg name="reason" type="u"/>
+    </signal>
+    <property name="Udi" type="s" access="read"/>
+    <property name="Path" type="s" access="read"/>
+    <property name="Interface" type="s" access="read"/>
+    <property name="IpInterface" type="s" access="read"/>
+    <property name="Driver" type="s" access="read"/>
+    <property name="DriverVersion" type="s" access="read"/>
+    <property name="FirmwareVersion" type="s" access="read"/>
+    <property name="Capabilities" type="u" access="read"/>
+    <property name="State" type="u" access="read"/>
+    <property name="StateReason" type="(uu)" access="read"/>
+    <property name="ActiveConnection" type="o" access="read"/>
+    <property name="Ip4Config" type="o" access="read"/>
+    <property name="Dhcp4Config" type="o" access="read"/>
+    <property name="Ip6Config" type="o" access="read"/>
+    <property name="Dhcp6Config" type="o" access="read"/>
+    <property name="Managed" type="b" access="read"/>
+    <property name="Autoconnect" type="b" access="read"/>
+    <property name="FirmwareMissing" type="b" access="read"/>
+    <property name="NmPluginMissing" type="b" access="read"/>
+    <property name="DeviceType" type="u" access="read"/>
+    <property name="AvailableConnections" type="ao" access="read"/>
+    <property name="PhysicalPortId" type="s" access="read"/>
+    <property name="Mtu" type="u" access="read"/>
+    <property name="Metered" type="u" access="read"/>
+    <property name="Real" type="b" access="read"/>
+    <property name="Ip4Connectivity" type="u" access="read"/>
+    <property name="Ip6Connectivity" type="u" access="read"/>
+    <property name="InterfaceFlags" type="u" access="read"/>
+    <property name="HwAddress" type="s" access="read"/>
+  </interface>
+
+  <interface name="org.freedesktop.NetworkManager.Device.Wireless">
+    <method name="GetAccessPoints"><arg name="access_points" type="ao" direction="out"/></method>
+    <method name="GetAllAccessPoints"><arg name="access_points" type="ao" direction="out"/></method>
+    <method name="RequestScan"><arg name="options" type="a{sv}" direction="in"/></method>
+    <signal name="AccessPointAdded"><arg name="access_point" type="o"/></signal>
+    <signal name="AccessPointRemoved"><arg name="access_point" type="o"/></signal>
+    <property name="HwAddress" type="s" access="read"/>
+    <property name="PermHwAddress" type="s" access="read"/>
+    <property name="Mode" type="u" access="read"/>
+    <property name="Bitrate" type="u" access="read"/>
+    <property name="AccessPoints" type="ao" access="read"/>
+    <property name="ActiveAccessPoint" type="o" access="read"/>
+    <property name="WirelessCapabilities" type="u" access="read"/>
+    <property name="LastScan" type="x" access="read"/>
+  </interface>
+
+  <interface name="org.freedesktop.NetworkManager.Device.Wired">
+    <property name="HwAddress" type="s" access="read"/>
+    <property name="PermHwAddress" type="s" access="read"/>
+    <property name="Speed" type="u" access="read"/>
+    <property name="S390Subchannels" type="as" access="read"/>
+    <property name="Carrier" type="b" access="read"/>
+  </interface>
+
+  <interface name="org.freedesktop.NetworkManager.AccessPoint">
+    <property name="Flags" type="u" access="read"/>
+    <property name="WpaFlags" type="u" access="read"/>
+    <property name="RsnFlags" type="u" access="read"/>
+    <property name="Ssid" type="ay" access="read"/>
+    <property name="Frequency" type="u" access="read"/>
+    <property name="HwAddress" type="s" access="read"/>
+    <property name="Mode" type="u" access="read"/>
+    <property name="MaxBitrate" type="u" access="read"/>
+    <property name="Bandwidth" type="u" access="read"/>
+    <property name="Strength" type="y" access="read"/>
+    <property name="LastSeen" type="i" access="read"/>
+  </interface>
+
+  <interface name="org.freedesktop.NetworkManager.Connection.Active">
+    <signal name="StateChanged">
+      <arg name="state" type="u"/>
+      <arg name="reason" type="u"/>
+    </signal>
+    <property name="Connection" type="o" access="read"/>
+    <property name="SpecificObject" type="o" access="read"/>
+    <property name="Id" type="s" access="read"/>
+    <property name="Uuid" type="s" access="read"/>
+    <property name="Type" type="s" access="read"/>
+    <property name="Devices" type="ao" access="read"/>
+    <property name="State" type="u" access="read"/>
+    <property name="StateFlags" type="u" access="read"/>
+    <property name="Default" type="b" access="read"/>
+    <property name="Ip4Config" type="o" access="read"/>
+    <property name="Dhcp4Config" type="o" access="read"/>
+    <property name="Default6" type="b" access="read"/>
+    <property name="Ip6Config" type="o" access="read"/>
+    <property name="Dhcp6Config" type="o" access="read"/>
+    <property name="Vpn" type="b" access="read"/>
+    <property name="Controller" type="o" access="read"/>
+    <property name="Master" type="o" access="read"/>
+  </interface>
+</node>
+)XML";
+
+/* ---------- Options ---------- */
+
+static gint     opt_wifi_devices = 1;
+static gint     opt_aps = 40;
+static gint     opt_saved = 3;
+static gboolean opt_ethernet = FALSE;
+static gint     opt_activation_delay_ms = 300;
+static gchar  **opt_fail_ssids = NULL;
+static gint     opt_seed = 1;
+
+static const GOptionEntry option_entries[] = {
+    { "wifi-devices", 0, 0, G_OPTION_ARG_INT, &opt_wifi_devices, "Number of Wi-Fi devices (default 1)", "N" },
+    { "aps", 0, 0, G_OPTION_ARG_INT, &opt_aps, "Access points per Wi-Fi device (default 40)", "N" },
+    { "saved", 0, 0, G_OPTION_ARG_INT, &opt_saved, "Saved connections for the first N SSIDs (default 3)", "N" },
+    { "ethernet", 0, 0, G_OPTION_ARG_NONE, &opt_ethernet, "Add a connected ethernet device", NULL },
+    { "activation-delay", 0, 0, G_OPTION_ARG_INT, &opt_activation_delay_ms, "Milliseconds from activating to activated (default 300)", "MS" },
+    { "fail-ssid", 0, 0, G_OPTION_ARG_STRING_ARRAY, &opt_fail_ssids, "Activations of this SSID fail with no-secrets (repeatable)", "SSID" },
+    { "seed", 0, 0, G_OPTION_ARG_INT, &opt_seed, "Random seed (default 1)", "N" },
+    { NULL, 0, 0, G_OPTION_ARG_NONE, NULL, NULL, NULL }
+};
+
+/* ---------- Exported objects ---------- */
+
+/* One D-Bus object: per interface, a table of property name -> GVariant.
+   Registered with the connection only once exported, so the initial
+   properties go out in a single InterfacesAdded. */
+typedef struct {
+    gchar      *path;
+    GHashTable *ifaces;   // interface name -> GHashTable (property -> GVariant)
+    GArray     *reg_ids;  // guint, empty until exported
+    gpointer    owner;    // the MockDevice / MockAp / ... this object backs
+} MockObject;
+
+static GDBusConnection *bus = NULL;
+static GDBusNodeInfo   *introspection = NULL;
+static GHashTable      *objects = NULL;   // path -> MockObject
+static GMainLoop       *loop = NULL;
+static GRand           *rng = NULL;
+
+static void method_call(GDBusConnection *connection, const gchar *sender, const gchar *object_path,
+                        const gchar *interface_name, const gchar *method_name, GVariant *parameters,
+                        GDBusMethodInvocation *invocation, gpointer user_data);
+static GVariant* get_property(GDBusConnection *connection, const gchar *sender, const gchar *object_path,
+                              const gchar *interface_name, const gchar *property_name,
+                              GError **error, gpointer user_data);
+static gboolean set_property(GDBusConnection *connection, const gchar *sender, const gchar *object_path,
+                             const gchar *interface_name, const gchar *property_name, GVariant *value,
+                             GError **error, gpointer user_data);
+
+static const GDBusInterfaceVTable vtable = { method_call, get_property, set_property, { 0 } };
+
+static MockObject* mock_object_new(const gchar *path, gpointer owner) {
+    MockObject *obj = g_new0(MockObject, 1);
+    obj->path = g_strdup(path);
+    obj->ifaces = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify) g_hash_table_unref);
+    obj->reg_ids = g_array_new(FALSE, FALSE, sizeof(guint));
+    obj->owner = owner;
+    return obj;
+}
+
+static GHashTable* mock_object_iface(MockObject *obj, const gchar *iface) {
+    GHashTable *props = (GHashTable*) g_hash_table_lookup(obj->ifaces, iface);
+    if (!props) {
+        props = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify) g_variant_unref);
+        g_hash_table_insert(obj->ifaces, g_strdup(iface), props);
+    }
+    return props;
+}
+
+static GVariant* mock_object_props_variant(MockObject *obj, const gchar *iface) {
+    GVariantBuilder b;
+    g_variant_builder_init(&b, G_VARIANT_TYPE("a{sv}"));
+    GHashTableIter iter;
+    gpointer name, value;
+    g_hash_table_iter_init(&iter, (GHashTable*) g_hash_table_lookup(obj->ifaces, iface));
+    while (g_hash_table_iter_next(&iter, &name, &value)) {
+        g_variant_builder_add(&b, "{sv}", (const gchar*) name, (GVariant*) value);
+    }
+    return g_variant_builder_end(&b);
+}
+
+static GVariant* mock_object_ifaces_variant(MockObject *obj) {
+    GVariantBuilder b;
+    g_variant_builder_init(&b, G_VARIANT_TYPE("a{sa{sv}}"));
+    GHashTableIter iter;
+    gpointer iface;
+    g_hash_table_iter_init(&iter, obj->ifaces);
+    while (g_hash_table_iter_next(&iter, &iface, NULL)) {
+        g_variant_builder_add(&b, "{s@a{sv}}", (const gchar*) iface, mock_object_props_variant(obj, (const gchar*) iface));
+    }
+    return g_variant_builder_end(&b);
+}
+
+static gboolean mock_object_exported(MockObject *obj) {
+    return obj->reg_ids->len > 0;
+}
+
+static void mock_emit(MockObject *obj, const gchar *iface, const gchar *signal, GVariant *params) {
+    g_dbus_connection_emit_signal(bus, NULL, obj->path, iface, signal, params, NULL);
+}
+
+/* Set a property; once exported, announce it with PropertiesChanged */
+static void mock_set(MockObject *obj, const gchar *iface, const gchar *name, GVariant *value) {
+    g_variant_ref_sink(value);
+    g_hash_table_insert(mock_object_iface(obj, iface), g_strdup(name), g_variant_ref(value));
+
+    if (mock_object_exported(obj)) {
+        GVariantBuilder changed;
+        g_variant_builder_init(&changed, G_VARIANT_TYPE("a{sv}"));
+        g_variant_builder_add(&changed, "{sv}", name, value);
+        mock_emit(obj, "org.freedesktop.DBus.Properties", "PropertiesChanged",
+                  g_variant_new("(sa{sv}as)", iface, &changed, NULL));
+    }
+    g_variant_unref(value);
+}
+
+static GVariant* mock_get(MockObject *obj, const gchar *iface, const gchar *name) {
+    GHashTable *props = (GHashTable*) g_hash_table_lookup(obj->ifaces, iface);
+    return props ? (GVariant*) g_hash_table_lookup(props, name) : NULL;
+}
+
+static void mock_object_export(MockObject *obj) {
+    GHashTableIter iter;
+    gpointer iface;
+    g_hash_table_iter_init(&iter, obj->ifaces);
+    while (g_hash_table_iter_next(&iter, &iface, NULL)) {
+        GError *error = NULL;
+        GDBusInterfaceInfo *info = g_dbus_node_info_lookup_interface(introspection, (const gchar*) iface);
+        guint id = g_dbus_connection_register_object(bus, obj->path, info, &vtable, obj, NULL, &error);
+        if (id == 0) {
+            g_printerr("mock-nm: cannot export %s on %s: %s\n", (const gchar*) iface, obj->path, error->message);
+            g_error_free(error);
+            continue;
+        }
+        g_array_append_val(obj->reg_ids, id);
+    }
+    g_hash_table_insert(objects, obj->path, obj);
+    g_dbus_connection_emit_signal(bus, NULL, OBJECT_MANAGER_PATH, "org.freedesktop.DBus.ObjectManager",
+                                  "InterfacesAdded",
+                                  g_variant_new("(o@a{sa{sv}})", obj->path, mock_object_ifaces_variant(obj)), NULL);
+}
+
+static void mock_object_unexport(MockObject *obj) {
+    for (guint i = 0; i < obj->reg_ids->len; i++) {
+        g_dbus_connection_unregister_object(bus, g_array_index(obj->reg_ids, guint, i));
+    }
+    g_array_set_size(obj->reg_ids, 0);
+
+    GVariantBuilder names;
+    g_variant_builder_init(&names, G_VARIANT_TYPE("as"));
+    GHashTableIter iter;
+    gpointer iface;
+    g_hash_table_iter_init(&iter, obj->ifaces);
+    while (g_hash_table_iter_next(&iter, &iface, NULL)) g_variant_builder_add(&names, "s", (const gchar*) iface);
+    g_dbus_connection_emit_signal(bus, NULL, OBJECT_MANAGER_PATH, "org.freedesktop.DBus.ObjectManager",
+                                  "InterfacesRemoved", g_variant_new("(oas)", obj->path, &names), NULL);
+    g_hash_table_remove(objects, obj->path);
+}
+
+static void mock_object_free(MockObject *obj) {
+    if (!obj) return;
+    if (mock_object_exported(obj)) mock_object_unexport(obj);
+    g_hash_table_unref(obj->ifaces);
+    g_array_unref(obj->reg_ids);
+    g_free(obj->path);
+    g_free(obj);
+}
+
+/* ---------- Model ---------- */
+
+typedef struct {
+    MockObject *obj;
+    gchar      *ssid;
+    gboolean    secured;
+} MockAp;
+
+typedef struct MockActive MockActive;
+
+typedef struct {
+    MockObject *obj;
+    guint       type;
+    GPtrArray  *aps;          // MockAp, owned
+    MockActive *active;
+    guint       state;
+} MockDevice;
+
+typedef struct {
+    MockObject *obj;
+    gchar      *ssid;         // NULL for wired profiles
+    gchar      *id;
+    gchar      *uuid;
+    GVariant   *settings;     // a{sa{sv}}
+} MockConnection;
+
+struct MockActive {
+    MockObject     *obj;
+    MockConnection *conn;
+    MockDevice     *dev;
+    MockAp         *ap;
+    guint           timer_id;
+};
+
+static MockObject *manager = NULL;
+static MockObject *settings = NULL;
+static GPtrArray  *devices = NULL;      // MockDevice
+static GPtrArray  *connections = NULL;  // MockConnection
+static GPtrArray  *actives = NULL;      // MockActive
+static guint       next_object_id = 1;
+static guint       next_ssid_id = 0;
+static gboolean    wireless_enabled = TRUE;
+
+static gchar* next_path(const gchar *kind) {
+    return g_strdup_printf(NM_DBUS_PATH "/%s/%u", kind, next_object_id++);
+}
+
+/* "ao" of the objects in items; get_obj picks the MockObject of each item */
+static GVariant* paths_variant(GPtrArray *items, MockObject* (*get_obj)(gpointer)) {
+    GVariantBuilder b;
+    g_variant_builder_init(&b, G_VARIANT_TYPE("ao"));
+    for (guint i = 0; items && i < items->len; i++) {
+        g_variant_builder_add(&b, "o", get_obj(g_ptr_array_index(items, i))->path);
+    }
+    return g_variant_builder_end(&b);
+}
+
+static MockObject* ap_obj(gpointer p)         { return ((MockAp*) p)->obj; }
+static MockObject* device_obj(gpointer p)     { return ((MockDevice*) p)->obj; }
+static MockObject* connection_obj(gpointer p) { return ((MockConnection*) p)->obj; }
+static MockObject* active_obj(gpointer p)     { return ((MockActive*) p)->obj; }
+
+static const gchar* path_or_root(MockObject *obj) {
+    return obj ? obj->path : "/";
+}
+
+static gchar* random_mac(void) {
+    return g_strdup_printf("02:00:%02X:%02X:%02X:%02X",
+                           g_rand_int_range(rng, 0, 256), g_rand_int_range(rng, 0, 256),
+                           g_rand_int_range(rng, 0, 256), g_rand_int_range(rng, 0, 256));
+}
+
+static gboolean ssid_fails(const gchar *ssid) {
+    return opt_fail_ssids && ssid && g_strv_contains((const gchar* const*) opt_fail_ssids, ssid);
+}
+
+static void publish_manager_state(void) {
+    MockActive *primary = NULL, *activating = NULL;
+    for (guint i = 0; i < actives->len; i++) {
+        MockActive *act = (MockActive*) g_ptr_array_index(actives, i);
+        guint state = g_variant_get_uint32(mock_get(act->obj, ACTIVE_IFACE, "State"));
+        if (state == NM_ACTIVE_STATE_ACTIVATED && !primary) primary = act;
+        if (state == NM_ACTIVE_STATE_ACTIVATING && !activating) activating = act;
+    }
+    guint state = primary ? NM_STATE_CONNECTED_GLOBAL : activating ? NM_STATE_CONNECTING : NM_STATE_DISCONNECTED;
+
+    mock_set(manager, NM_IFACE, "ActiveConnections", paths_variant(actives, active_obj));
+    mock_set(manager, NM_IFACE, "PrimaryConnection", g_variant_new_object_path(path_or_root(primary ? primary->obj : NULL)));
+    mock_set(manager, NM_IFACE, "PrimaryConnectionType",
+             g_variant_new_string(primary ? (primary->conn->ssid ? "802-11-wireless" : "802-3-ethernet") : ""));
+    mock_set(manager, NM_IFACE, "ActivatingConnection", g_variant_new_object_path(path_or_root(activating ? activating->obj : NULL)));
+    mock_set(manager, NM_IFACE, "Connectivity", g_variant_new_uint32(primary ? NM_CONNECTIVITY_FULL : NM_CONNECTIVITY_NONE));
+    if (g_variant_get_uint32(mock_get(manager, NM_IFACE, "State")) != state) {
+        mock_set(manager, NM_IFACE, "State", g_variant_new_uint32(state));
+        mock_emit(manager, NM_IFACE, "StateChanged", g_variant_new("(u)", state));
+    }
+}
+
+static void set_device_state(MockDevice *dev, guint state, guint reason) {
+    guint old = dev->state;
+    if (old == state) return;
+    dev->state = state;
+    mock_set(dev->obj, DEVICE_IFACE, "State", g_variant_new_uint32(state));
+    mock_set(dev->obj, DEVICE_IFACE, "StateReason", g_variant_new("(uu)", state, reason));
+    mock_emit(dev->obj, DEVICE_IFACE, "StateChanged", g_variant_new("(uuu)", state, old, reason));
+}
+
+/* ---------- Access points ---------- */
+
+static void publish_device_aps(MockDevice *dev) {
+    /* a disabled radio sees nothing */
+    GPtrArray *visible = wireless_enabled ? dev->aps : NULL;
+    mock_set(dev->obj, WIRELESS_IFACE, "AccessPoints", paths_variant(visible, ap_obj));
+}
+
+static MockAp* ap_new(const gchar *ssid, gboolean secured) {
+    MockAp *ap = g_new0(MockAp, 1);
+    gchar *path = next_path("AccessPoint");
+    ap->obj = mock_object_new(path, ap);
+    ap->ssid = g_strdup(ssid);
+    ap->secured = secured;
+    g_free(path);
+
+    guint rsn = secured ? (NM_802_11_AP_SEC_KEY_MGMT_PSK | NM_802_11_AP_SEC_PAIR_CCMP | NM_802_11_AP_SEC_GROUP_CCMP) : 0;
+    gchar *mac = random_mac();
+    MockObject *o = ap->obj;
+    mock_set(o, AP_IFACE, "Flags", g_variant_new_uint32(secured ? NM_802_11_AP_FLAGS_PRIVACY : 0));
+    mock_set(o, AP_IFACE, "WpaFlags", g_variant_new_uint32(0));
+    mock_set(o, AP_IFACE, "RsnFlags", g_variant_new_uint32(rsn));
+    mock_set(o, AP_IFACE, "Ssid", g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE, ssid, strlen(ssid), 1));
+    mock_set(o, AP_IFACE, "Frequency", g_variant_new_uint32(g_rand_boolean(rng) ? 2412 : 5180));
+    mock_set(o, AP_IFACE, "HwAddress", g_variant_new_string(mac));
+    mock_set(o, AP_IFACE, "Mode", g_variant_new_uint32(2));  // infrastructure
+    mock_set(o, AP_IFACE, "MaxBitrate", g_variant_new_uint32(270000));
+    mock_set(o, AP_IFACE, "Bandwidth", g_variant_new_uint32(20));
+    mock_set(o, AP_IFACE, "Strength", g_variant_new_byte((guint8) g_rand_int_range(rng, 5, 100)));
+    mock_set(o, AP_IFACE, "LastSeen", g_variant_new_int32((gint32) (g_get_monotonic_time() / G_USEC_PER_SEC)));
+    g_free(mac);
+    return ap;
+}
+
+static void ap_free(gpointer data) {
+    MockAp *ap = (MockAp*) data;
+    mock_object_free(ap->obj);
+    g_free(ap->ssid);
+    g_free(ap);
+}
+
+static gchar* next_ssid(void) {
+    return g_strdup_printf("mock-ap-%04u", next_ssid_id++);
+}
+
+static void device_add_aps(MockDevice *dev, guint n) {
+    for (guint i = 0; i < n; i++) {
+        gchar *ssid = next_ssid();
+        MockAp *ap = ap_new(ssid, g_rand_int_range(rng, 0, 4) != 0);  // 3 in 4 secured
+        g_free(ssid);
+        g_ptr_array_add(dev->aps, ap);
+        mock_object_export(ap->obj);
+        if (wireless_enabled) mock_emit(dev->obj, WIRELESS_IFACE, "AccessPointAdded", g_variant_new("(o)", ap->obj->path));
+    }
+    publish_device_aps(dev);
+}
+
+static void device_remove_aps(MockDevice *dev, guint n) {
+    for (guint i = 0; i < n && dev->aps->len > 0; i++) {
+        guint index = g_rand_int_range(rng, 0, dev->aps->len);
+        MockAp *ap = (MockAp*) g_ptr_array_index(dev->aps, index);
+        if (dev->active && dev->active->ap == ap) continue;  // keep the one we're on
+        if (wireless_enabled) mock_emit(dev->obj, WIRELESS_IFACE, "AccessPointRemoved", g_variant_new("(o)", ap->obj->path));
+        g_ptr_array_remove_index_fast(dev->aps, index);
+    }
+    publish_device_aps(dev);
+}
+
+/* ---------- Settings connections ---------- */
+
+static void publish_connections(void) {
+    mock_set(settings, SETTINGS_IFACE, "Connections", paths_variant(connections, connection_obj));
+    for (guint i = 0; i < devices->len; i++) {
+        MockDevice *dev = (MockDevice*) g_ptr_array_index(devices, i);
+        GPtrArray *available = g_ptr_array_new();
+        for (guint j = 0; j < connections->len; j++) {
+            MockConnection *conn = (MockConnection*) g_ptr_array_index(connections, j);
+            if ((conn->ssid != NULL) == (dev->type == NM_DEVICE_TYPE_WIFI)) g_ptr_array_add(available, conn);
+        }
+        mock_set(dev->obj, DEVICE_IFACE, "AvailableConnections", paths_variant(available, connection_obj));
+        g_ptr_array_unref(available);
+    }
+}
+
+static gchar* settings_lookup_string(GVariant *s, const gchar *setting, const gchar *key) {
+    gchar *value = NULL;
+    GVariant *group = g_variant_lookup_value(s, setting, G_VARIANT_TYPE("a{sv}"));
+    if (group) {
+        g_variant_lookup(group, key, "s", &value);
+        g_variant_unref(group);
+    }
+    return value;
+}
+
+static gchar* settings_ssid(GVariant *s) {
+    gchar *ssid = NULL;
+    GVariant *group = g_variant_lookup_value(s, "802-11-wireless", G_VARIANT_TYPE("a{sv}"));
+    if (group) {
+        GVariant *bytes = g_variant_lookup_value(group, "ssid", G_VARIANT_TYPE_BYTESTRING);
+        if (bytes) {
+            gsize len;
+            const gchar *data = (const gchar*) g_variant_get_fixed_array(bytes, &len, 1);
+            ssid = g_strndup(data, len);
+            g_variant_unref(bytes);
+        }
+        g_variant_unref(group);
+    }
+    return ssid;
+}
+
+/* Fill in connection.id / uuid / type the way NM does for a partial profile */
+static GVariant* settings_complete(GVariant *s, const gchar *ssid, const gchar *type) {
+    GVariantBuilder out;
+    g_variant_builder_init(&out, G_VARIANT_TYPE("a{sa{sv}}"));
+
+    GVariantDict conn;
+    GVariant *group = g_variant_lookup_value(s, "connection", G_VARIANT_TYPE("a{sv}"));
+    g_variant_dict_init(&conn, group);
+    if (group) g_variant_unref(group);
+    if (!g_variant_dict_contains(&conn, "id")) g_variant_dict_insert(&conn, "id", "s", ssid ? ssid : "Wired connection");
+    if (!g_variant_dict_contains(&conn, "uuid")) {
+        gchar *uuid = g_uuid_string_random();
+        g_variant_dict_insert(&conn, "uuid", "s", uuid);
+        g_free(uuid);
+    }
+    if (!g_variant_dict_contains(&conn, "type")) g_variant_dict_insert(&conn, "type", "s", type);
+    g_variant_builder_add(&out, "{s@a{sv}}", "connection", g_variant_dict_end(&conn));
+
+    GVariantIter iter;
+    const gchar *name;
+    GVariant *value;
+    g_variant_iter_init(&iter, s);
+    while (g_variant_iter_next(&iter, "{&s@a{sv}}", &name, &value)) {
+        if (g_strcmp0(name, "connection") != 0) g_variant_builder_add(&out, "{s@a{sv}}", name, value);
+        g_variant_unref(value);
+    }
+    return g_variant_ref_sink(g_variant_builder_end(&out));
+}
+
+static MockConnection* connection_add(GVariant *s) {
+    MockConnection *conn = g_new0(MockConnection, 1);
+    conn->ssid = settings_ssid(s);
+    conn->settings = settings_complete(s, conn->ssid, conn->ssid ? "802-11-wireless" : "802-3-ethernet");
+    conn->id = settings_lookup_string(conn->settings, "connection", "id");
+    conn->uuid = settings_lookup_string(conn->settings, "connection", "uuid");
+
+    gchar *path = next_path("Settings");
+    conn->obj = mock_object_new(path, conn);
+    g_free(path);
+    mock_set(conn->obj, CONNECTION_IFACE, "Unsaved", g_variant_new_boolean(FALSE));
+    mock_set(conn->obj, CONNECTION_IFACE, "Flags", g_variant_new_uint32(0));
+    mock_set(conn->obj, CONNECTION_IFACE, "Filename", g_variant_new_string(""));
+    mock_object_export(conn->obj);
+
+    g_ptr_array_add(connections, conn);
+    mock_emit(settings, SETTINGS_IFACE, "NewConnection", g_variant_new("(o)", conn->obj->path));
+    publish_connections();
+    return conn;
+}
+
+static GVariant* wifi_settings(const gchar *ssid, gboolean secured) {
+    GVariantBuilder b;
+    g_variant_builder_init(&b, G_VARIANT_TYPE("a{sa{sv}}"));
+    g_variant_builder_open(&b, G_VARIANT_TYPE("{sa{sv}}"));
+    g_variant_builder_add(&b, "s", "802-11-wireless");
+    g_variant_builder_open(&b, G_VARIANT_TYPE("a{sv}"));
+    g_variant_builder_add(&b, "{sv}", "ssid", g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE, ssid, strlen(ssid), 1));
+    g_variant_builder_add(&b, "{sv}", "mode", g_variant_new_string("infrastructure"));
+    g_variant_builder_close(&b);
+    g_variant_builder_close(&b);
+    if (secured) {
+        g_variant_builder_add_parsed(&b, "{'802-11-wireless-security', {'key-mgmt': <'wpa-psk'>}}");
+    }
+    return g_variant_builder_end(&b);
+}
+
+static MockConnection* find_connection(const gchar *path) {
+    for (guint i = 0; i < connections->len; i++) {
+        MockConnection *conn = (MockConnection*) g_ptr_array_index(connections, i);
+        if (g_strcmp0(conn->obj->path, path) == 0) return conn;
+    }
+    return NULL;
+}
+
+/* ---------- Active connections ---------- */
+
+static void active_remove(MockActive *act, guint reason) {
+    if (act->timer_id) g_source_remove(act->timer_id);
+    mock_set(act->obj, ACTIVE_IFACE, "State", g_variant_new_uint32(NM_ACTIVE_STATE_DEACTIVATED));
+    mock_emit(act->obj, ACTIVE_IFACE, "StateChanged", g_variant_new("(uu)", NM_ACTIVE_STATE_DEACTIVATED, reason));
+
+    MockDevice *dev = act->dev;
+    dev->active = NULL;
+    mock_set(dev->obj, DEVICE_IFACE, "ActiveConnection", g_variant_new_object_path("/"));
+    if (dev->type == NM_DEVICE_TYPE_WIFI) {
+        mock_set(dev->obj, WIRELESS_IFACE, "ActiveAccessPoint", g_variant_new_object_path("/"));
+    }
+    set_device_state(dev, NM_DEVICE_STATE_DISCONNECTED, 0);
+
+    g_ptr_array_remove(actives, act);
+    publish_manager_state();
+    mock_object_free(act->obj);
+    g_free(act);
+}
+
+static gboolean active_complete(gpointer user_data) {
+    MockActive *act = (MockActive*) user_data;
+    act->timer_id = 0;
+
+    if (ssid_fails(act->conn->ssid)) {
+        active_remove(act, NM_ACTIVE_REASON_NO_SECRETS);
+        return G_SOURCE_REMOVE;
+    }
+
+    mock_set(act->obj, ACTIVE_IFACE, "State", g_variant_new_uint32(NM_ACTIVE_STATE_ACTIVATED));
+    mock_set(act->obj, ACTIVE_IFACE, "Default", g_variant_new_boolean(TRUE));
+    mock_emit(act->obj, ACTIVE_IFACE, "StateChanged", g_variant_new("(uu)", NM_ACTIVE_STATE_ACTIVATED, NM_ACTIVE_REASON_NONE));
+    set_device_state(act->dev, NM_DEVICE_STATE_ACTIVATED, 0);
+    publish_manager_state();
+    return G_SOURCE_REMOVE;
+}
+
+static MockActive* active_start(MockConnection *conn, MockDevice *dev, MockAp *ap, gboolean immediate) {
+    if (dev->active) active_remove(dev->active, NM_ACTIVE_REASON_USER_DISCONNECTED);
+
+    MockActive *act = g_new0(MockActive, 1);
+    act->conn = conn;
+    act->dev = dev;
+    act->ap = ap;
+    gchar *path = next_path("ActiveConnection");
+    act->obj = mock_object_new(path, act);
+    g_free(path);
+
+    MockObject *o = act->obj;
+    mock_set(o, ACTIVE_IFACE, "Connection", g_variant_new_object_path(conn->obj->path));
+    mock_set(o, ACTIVE_IFACE, "SpecificObject", g_variant_new_object_path(path_or_root(ap ? ap->obj : NULL)));
+    mock_set(o, ACTIVE_IFACE, "Id", g_variant_new_string(conn->id));
+    mock_set(o, ACTIVE_IFACE, "Uuid", g_variant_new_string(conn->uuid));
+    mock_set(o, ACTIVE_IFACE, "Type", g_variant_new_string(conn->ssid ? "802-11-wireless" : "802-3-ethernet"));
+    const gchar *device_paths[] = { dev->obj->path };
+    mock_set(o, ACTIVE_IFACE, "Devices", g_variant_new_objv(device_paths, 1));
+    mock_set(o, ACTIVE_IFACE, "State", g_variant_new_uint32(NM_ACTIVE_STATE_ACTIVATING));
+    mock_set(o, ACTIVE_IFACE, "StateFlags", g_variant_new_uint32(0));
+    mock_set(o, ACTIVE_IFACE, "Default", g_variant_new_boolean(FALSE));
+    mock_set(o, ACTIVE_IFACE, "Default6", g_variant_new_boolean(FALSE));
+    mock_set(o, ACTIVE_IFACE, "Vpn", g_variant_new_boolean(FALSE));
+    static const gchar *const unset_paths[] = { "Ip4Config", "Dhcp4Config", "Ip6Config", "Dhcp6Config", "Controller", "Master" };
+    for (guint i = 0; i < G_N_ELEMENTS(unset_paths); i++) {
+        mock_set(o, ACTIVE_IFACE, unset_paths[i], g_variant_new_object_path("/"));
+    }
+    mock_object_export(o);
+
+    dev->active = act;
+    g_ptr_array_add(actives, act);
+    mock_set(dev->obj, DEVICE_IFACE, "ActiveConnection", g_variant_new_object_path(o->path));
+    if (dev->type == NM_DEVICE_TYPE_WIFI) {
+        mock_set(dev->obj, WIRELESS_IFACE, "ActiveAccessPoint", g_variant_new_object_path(path_or_root(ap ? ap->obj : NULL)));
+    }
+
+    if (immediate) {
+        active_complete(act);
+    } else {
+        set_device_state(dev, NM_DEVICE_STATE_CONFIG, 0);
+        publish_manager_state();
+        act->timer_id = g_timeout_add(opt_activation_delay_ms, active_complete, act);
+    }
+    return act;
+}
+
+/* ---------- Devices ---------- */
+
+static MockDevice* device_new(guint type, guint index) {
+    MockDevice *dev = g_new0(MockDevice, 1);
+    dev->type = type;
+    dev->aps = g_ptr_array_new_with_free_func(ap_free);
+    dev->state = NM_DEVICE_STATE_DISCONNECTED;
+
+    gchar *path = next_path("Devices");
+    dev->obj = mock_object_new(path, dev);
+    g_free(path);
+
+    gboolean wifi = type == NM_DEVICE_TYPE_WIFI;
+    gchar *iface = g_strdup_printf(wifi ? "wlan%u" : "eth%u", index);
+    gchar *mac = random_mac();
+    MockObject *o = dev->obj;
+    mock_set(o, DEVICE_IFACE, "Udi", g_variant_new_string(o->path));
+    mock_set(o, DEVICE_IFACE, "Path", g_variant_new_string(""));
+    mock_set(o, DEVICE_IFACE, "Interface", g_variant_new_string(iface));
+    mock_set(o, DEVICE_IFACE, "IpInterface", g_variant_new_string(iface));
+    mock_set(o, DEVICE_IFACE, "Driver", g_variant_new_string(wifi ? "mock-wifi" : "mock-eth"));
+    mock_set(o, DEVICE_IFACE, "DriverVersion", g_variant_new_string("1.0"));
+    mock_set(o, DEVICE_IFACE, "FirmwareVersion", g_variant_new_string(""));
+    mock_set(o, DEVICE_IFACE, "Capabilities", g_variant_new_uint32(0x1));
+    mock_set(o, DEVICE_IFACE, "State", g_variant_new_uint32(dev->state));
+    mock_set(o, DEVICE_IFACE, "StateReason", g_variant_new("(uu)", dev->state, 0));
+    mock_set(o, DEVICE_IFACE, "Managed", g_variant_new_boolean(TRUE));
+    mock_set(o, DEVICE_IFACE, "Autoconnect", g_variant_new_boolean(TRUE));
+    mock_set(o, DEVICE_IFACE, "FirmwareMissing", g_variant_new_boolean(FALSE));
+    mock_set(o, DEVICE_IFACE, "NmPluginMissing", g_variant_new_boolean(FALSE));
+    mock_set(o, DEVICE_IFACE, "DeviceType", g_variant_new_uint32(type));
+    mock_set(o, DEVICE_IFACE, "PhysicalPortId", g_variant_new_string(""));
+    mock_set(o, DEVICE_IFACE, "Mtu", g_variant_new_uint32(1500));
+    mock_set(o, DEVICE_IFACE, "Metered", g_variant_new_uint32(0));
+    mock_set(o, DEVICE_IFACE, "Real", g_variant_new_boolean(TRUE));
+    mock_set(o, DEVICE_IFACE, "Ip4Connectivity", g_variant_new_uint32(0));
+    mock_set(o, DEVICE_IFACE, "Ip6Connectivity", g_variant_new_uint32(0));
+    mock_set(o, DEVICE_IFACE, "InterfaceFlags", g_variant_new_uint32(0x1));
+    mock_set(o, DEVICE_IFACE, "HwAddress", g_variant_new_string(mac));
+    mock_set(o, DEVICE_IFACE, "AvailableConnections", g_variant_new_objv(NULL, 0));
+    static const gchar *const unset_paths[] = { "ActiveConnection", "Ip4Config", "Dhcp4Config", "Ip6Config", "Dhcp6Config" };
+    for (guint i = 0; i < G_N_ELEMENTS(unset_paths); i++) {
+        mock_set(o, DEVICE_IFACE, unset_paths[i], g_variant_new_object_path("/"));
+    }
+
+    if (wifi) {
+        mock_set(o, WIRELESS_IFACE, "HwAddress", g_variant_new_string(mac));
+        mock_set(o, WIRELESS_IFACE, "PermHwAddress", g_variant_new_string(mac));
+        mock_set(o, WIRELESS_IFACE, "Mode", g_variant_new_uint32(2));
+        mock_set(o, WIRELESS_IFACE, "Bitrate", g_variant_new_uint32(0));
+        mock_set(o, WIRELESS_IFACE, "AccessPoints", g_variant_new_objv(NULL, 0));
+        mock_set(o, WIRELESS_IFACE, "ActiveAccessPoint", g_variant_new_object_path("/"));
+        mock_set(o, WIRELESS_IFACE, "WirelessCapabilities", g_variant_new_uint32(0x3ff));
+        mock_set(o, WIRELESS_IFACE, "LastScan", g_variant_new_int64(g_get_monotonic_time() / 1000));
+    } else {
+        mock_set(o, WIRED_IFACE, "HwAddress", g_variant_new_string(mac));
+        mock_set(o, WIRED_IFACE, "PermHwAddress", g_variant_new_string(mac));
+        mock_set(o, WIRED_IFACE, "Speed", g_variant_new_uint32(1000));
+        mock_set(o, WIRED_IFACE, "S390Subchannels", g_variant_new_strv(NULL, 0));
+        mock_set(o, WIRED_IFACE, "Carrier", g_variant_new_boolean(TRUE));
+    }
+    g_free(iface);
+    g_free(mac);
+
+    mock_object_export(o);
+    g_ptr_array_add(devices, dev);
+    return dev;
+}
+
+static MockDevice* find_device(const gchar *path, guint type) {
+    for (guint i = 0; i < devices->len; i++) {
+        MockDevice *dev = (MockDevice*) g_ptr_array_index(devices, i);
+        if (g_strcmp0(path, "/") == 0 ? dev->type == type : g_strcmp0(dev->obj->path, path) == 0) return dev;
+    }
+    return NULL;
+}
+
+static MockAp* find_ap(MockDevice *dev, const gchar *path, const gchar *ssid) {
+    for (guint i = 0; dev && i < dev->aps->len; i++) {
+        MockAp *ap = (MockAp*) g_ptr_array_index(dev->aps, i);
+        if (g_strcmp0(ap->obj->path, path) == 0) return ap;
+        if (g_strcmp0(path, "/") == 0 && g_strcmp0(ap->ssid, ssid) == 0) return ap;
+    }
+    return NULL;
+}
+
+static void set_wireless_enabled(gboolean enabled) {
+    if (enabled == wireless_enabled) return;
+    wireless_enabled = enabled;
+    mock_set(manager, NM_IFACE, "WirelessEnabled", g_variant_new_boolean(enabled));
+    for (guint i = 0; i < devices->len; i++) {
+        MockDevice *dev = (MockDevice*) g_ptr_array_index(devices, i);
+        if (dev->type != NM_DEVICE_TYPE_WIFI) continue;
+        if (!enabled && dev->active) active_remove(dev->active, NM_ACTIVE_REASON_USER_DISCONNECTED);
+        set_device_state(dev, enabled ? NM_DEVICE_STATE_DISCONNECTED : NM_DEVICE_STATE_UNAVAILABLE, 0);
+        publish_device_aps(dev);
+    }
+}
+
+/* ---------- D-Bus handlers ---------- */
+
+static GVariant* managed_objects_variant(void) {
+    GVariantBuilder b;
+    g_variant_builder_init(&b, G_VARIANT_TYPE("a{oa{sa{sv}}}"));
+    GHashTableIter iter;
+    gpointer path, obj;
+    g_hash_table_iter_init(&iter, objects);
+    while (g_hash_table_iter_next(&iter, &path, &obj)) {
+        g_variant_builder_add(&b, "{o@a{sa{sv}}}", (const gchar*) path, mock_object_ifaces_variant((MockObject*) obj));
+    }
+    return g_variant_builder_end(&b);
+}
+
+static void activate_and_reply(GDBusMethodInvocation *invocation, MockConnection *conn, const gchar *device_path,
+                               const gchar *specific_path, const gchar *reply_type) {
+    guint type = conn->ssid ? NM_DEVICE_TYPE_WIFI : NM_DEVICE_TYPE_ETHERNET;
+    MockDevice *dev = find_device(device_path, type);
+    if (!dev || dev->type != type) {
+        g_dbus_method_invocation_return_dbus_error(invocation, NM_IFACE ".UnknownDevice", "No suitable device");
+        return;
+    }
+    MockAp *ap = type == NM_DEVICE_TYPE_WIFI ? find_ap(dev, specific_path, conn->ssid) : NULL;
+    if (type == NM_DEVICE_TYPE_WIFI && !ap) {
+        g_dbus_method_invocation_return_dbus_error(invocation, NM_IFACE ".UnknownConnection", "SSID not in range");
+        return;
+    }
+    MockActive *act = active_start(conn, dev, ap, FALSE);
+
+    if (g_strcmp0(reply_type, "(o)") == 0) {
+        g_dbus_method_invocation_return_value(invocation, g_variant_new("(o)", act->obj->path));
+    } else if (g_strcmp0(reply_type, "(oo)") == 0) {
+        g_dbus_method_invocation_return_value(invocation, g_variant_new("(oo)", conn->obj->path, act->obj->path));
+    } else {
+        g_dbus_method_invocation_return_value(invocation, g_variant_new("(oo@a{sv})", conn->obj->path, act->obj->path,
+                                                                        g_variant_new_array(G_VARIANT_TYPE("{sv}"), NULL, 0)));
+    }
+}
+
+static void manager_method(const gchar *method, GVariant *params, GDBusMethodInvocation *invocation) {
+    if (g_strcmp0(method, "GetDevices") == 0 || g_strcmp0(method, "GetAllDevices") == 0) {
+        g_dbus_method_invocation_return_value(invocation, g_variant_new("(@ao)", paths_variant(devices, device_obj)));
+    } else if (g_strcmp0(method, "ActivateConnection") == 0) {
+        const gchar *conn_path, *dev_path, *specific;
+        g_variant_get(params, "(&o&o&o)", &conn_path, &dev_path, &specific);
+        MockConnection *conn = find_connection(conn_path);
+        if (!conn) {
+            g_dbus_method_invocation_return_dbus_error(invocation, NM_IFACE ".UnknownConnection", "No such connection");
+            return;
+        }
+        activate_and_reply(invocation, conn, dev_path, specific, "(o)");
+    } else if (g_strcmp0(method, "AddAndActivateConnection") == 0 || g_strcmp0(method, "AddAndActivateConnection2") == 0) {
+        GVariant *s = g_variant_get_child_value(params, 0);
+        const gchar *dev_path, *specific;
+        g_variant_get_child(params, 1, "&o", &dev_path);
+        g_variant_get_child(params, 2, "&o", &specific);
+        MockConnection *conn = connection_add(s);
+        g_variant_unref(s);
+        activate_and_reply(invocation, conn, dev_path, specific,
+                           g_strcmp0(method, "AddAndActivateConnection") == 0 ? "(oo)" : "(ooa{sv})");
+    } else if (g_strcmp0(method, "DeactivateConnection") == 0) {
+        const gchar *path;
+        g_variant_get(params, "(&o)", &path);
+        for (guint i = 0; i < actives->len; i++) {
+            MockActive *act = (MockActive*) g_ptr_array_index(actives, i);
+            if (g_strcmp0(act->obj->path, path) == 0) {
+                active_remove(act, NM_ACTIVE_REASON_USER_DISCONNECTED);
+                g_dbus_method_invocation_return_value(invocation, NULL);
+                return;
+            }
+        }
+        g_dbus_method_invocation_return_dbus_error(invocation, NM_IFACE ".ConnectionNotActive", "Not active");
+    } else if (g_strcmp0(method, "Enable") == 0) {
+        gboolean enable;
+        g_variant_get(params, "(b)", &enable);
+        mock_set(manager, NM_IFACE, "NetworkingEnabled", g_variant_new_boolean(enable));
+        g_dbus_method_invocation_return_value(invocation, NULL);
+    } else if (g_strcmp0(method, "GetPermissions") == 0) {
+        g_dbus_method_invocation_return_value(invocation, g_variant_new_parsed("(@a{ss} {},)"));
+    } else if (g_strcmp0(method, "state") == 0) {
+        g_dbus_method_invocation_return_value(invocation, g_variant_new("(@u)", mock_get(manager, NM_IFACE, "State")));
+    } else if (g_strcmp0(method, "CheckConnectivity") == 0) {
+        g_dbus_method_invocation_return_value(invocation, g_variant_new("(@u)", mock_get(manager, NM_IFACE, "Connectivity")));
+    } else {
+        g_dbus_method_invocation_return_dbus_error(invocation, "org.freedesktop.DBus.Error.UnknownMethod", method);
+    }
+}
+
+static void settings_method(const gchar *method, GVariant *params, GDBusMethodInvocation *invocation) {
+    if (g_strcmp0(method, "ListConnections") == 0) {
+        g_dbus_method_invocation_return_value(invocation, g_variant_new("(@ao)", paths_variant(connections, connection_obj)));
+    } else if (g_strcmp0(method, "GetConnectionByUuid") == 0) {
+        const gchar *uuid;
+        g_variant_get(params, "(&s)", &uuid);
+        for (guint i = 0; i < connections->len; i++) {
+            MockConnection *conn = (MockConnection*) g_ptr_array_index(connections, i);
+            if (g_strcmp0(conn->uuid, uuid) == 0) {
+                g_dbus_method_invocation_return_value(invocation, g_variant_new("(o)", conn->obj->path));
+                return;
+            }
+        }
+        g_dbus_method_invocation_return_dbus_error(invocation, SETTINGS_IFACE ".InvalidConnection", "No such connection");
+    } else if (g_strcmp0(method, "AddConnection") == 0 || g_strcmp0(method, "AddConnection2") == 0) {
+        GVariant *s = g_variant_get_child_value(params, 0);
+        MockConnection *conn = connection_add(s);
+        g_variant_unref(s);
+        if (g_strcmp0(method, "AddConnection") == 0) {
+            g_dbus_method_invocation_return_value(invocation, g_variant_new("(o)", conn->obj->path));
+        } else {
+            g_dbus_method_invocation_return_value(invocation, g_variant_new("(o@a{sv})", conn->obj->path,
+                                                                            g_variant_new_array(G_VARIANT_TYPE("{sv}"), NULL, 0)));
+        }
+    } else {
+        g_dbus_method_invocation_return_dbus_error(invocation, "org.freedesktop.DBus.Error.UnknownMethod", method);
+    }
+}
+
+static void connection_method(MockConnection *conn, const gchar *method, GVariant *params, GDBusMethodInvocation *invocation) {
+    if (g_strcmp0(method, "GetSettings") == 0) {
+        g_dbus_method_invocation_return_value(invocation, g_variant_new("(@a{sa{sv}})", conn->settings));
+    } else if (g_strcmp0(method, "GetSecrets") == 0) {
+        g_dbus_method_invocation_return_value(invocation, g_variant_new_parsed("(@a{sa{sv}} {},)"));
+    } else if (g_strcmp0(method, "Update") == 0) {
+        GVariant *s = g_variant_get_child_value(params, 0);
+        g_variant_unref(conn->settings);
+        conn->settings = settings_complete(s, conn->ssid, conn->ssid ? "802-11-wireless" : "802-3-ethernet");
+        g_variant_unref(s);
+        mock_emit(conn->obj, CONNECTION_IFACE, "Updated", NULL);
+        g_dbus_method_invocation_return_value(invocation, NULL);
+    } else if (g_strcmp0(method, "Delete") == 0) {
+        for (guint i = 0; i < actives->len; i++) {
+            MockActive *act = (MockActive*) g_ptr_array_index(actives, i);
+            if (act->conn == conn) {
+                active_remove(act, NM_ACTIVE_REASON_USER_DISCONNECTED);
+                break;
+            }
+        }
+        mock_emit(conn->obj, CONNECTION_IFACE, "Removed", NULL);
+        mock_emit(settings, SETTINGS_IFACE, "ConnectionRemoved", g_variant_new("(o)", conn->obj->path));
+        g_dbus_method_invocation_return_value(invocation, NULL);
+
+        g_ptr_array_remove(connections, conn);
+        publish_connections();
+        mock_object_free(conn->obj);
+        g_variant_unref(conn->settings);
+        g_free(conn->ssid);
+        g_free(conn->id);
+        g_free(conn->uuid);
+        g_free(conn);
+    } else {
+        g_dbus_method_invocation_return_dbus_error(invocation, "org.freedesktop.DBus.Error.UnknownMethod", method);
+    }
+}
+
+static void device_method(MockDevice *dev, const gchar *iface, const gchar *method, GDBusMethodInvocation *invocation) {
+    if (g_strcmp0(iface, DEVICE_IFACE) == 0 && g_strcmp0(method, "Disconnect") == 0) {
+        if (dev->active) active_remove(dev->active, NM_ACTIVE_REASON_USER_DISCONNECTED);
+        g_dbus_method_invocation_return_value(invocation, NULL);
+    } else if (g_strcmp0(method, "GetAccessPoints") == 0 || g_strcmp0(method, "GetAllAccessPoints") == 0) {
+        g_dbus_method_invocation_return_value(invocation,
+            g_variant_new("(@ao)", paths_variant(wireless_enabled ? dev->aps : NULL, ap_obj)));
+    } else if (g_strcmp0(method, "RequestScan") == 0) {
+        mock_set(dev->obj, WIRELESS_IFACE, "LastScan", g_variant_new_int64(g_get_monotonic_time() / 1000));
+        g_dbus_method_invocation_return_value(invocation, NULL);
+    } else {
+        g_dbus_method_invocation_return_dbus_error(invocation, "org.freedesktop.DBus.Error.UnknownMethod", method);
+    }
+}
+
+static void method_call(GDBusConnection *connection, const gchar *sender, const gchar *object_path,
+                        const gchar *interface_name, const gchar *method_name, GVariant *parameters,
+                        GDBusMethodInvocation *invocation, gpointer user_data) {
+    (void)connection; (void)sender; (void)object_path;
+    MockObject *obj = (MockObject*) user_data;
+
+    if (g_strcmp0(interface_name, "org.freedesktop.DBus.ObjectManager") == 0) {
+        g_dbus_method_invocation_return_value(invocation, g_variant_new("(@a{oa{sa{sv}}})", managed_objects_variant()));
+    } else if (g_strcmp0(interface_name, NM_IFACE) == 0) {
+        manager_method(method_name, parameters, invocation);
+    } else if (g_strcmp0(interface_name, SETTINGS_IFACE) == 0) {
+        settings_method(method_name, parameters, invocation);
+    } else if (g_strcmp0(interface_name, CONNECTION_IFACE) == 0) {
+        connection_method((MockConnection*) obj->owner, method_name, parameters, invocation);
+    } else if (g_str_has_prefix(interface_name, DEVICE_IFACE)) {
+        device_method((MockDevice*) obj->owner, interface_name, method_name, invocation);
+    } else {
+        g_dbus_method_invocation_return_dbus_error(invocation, "org.freedesktop.DBus.Error.UnknownMethod", method_name);
+    }
+}
+
+static GVariant* get_property(GDBusConnection *connection, const gchar *sender, const gchar *object_path,
+                              const gchar *interface_name, const gchar *property_name,
+                              GError **error, gpointer user_data) {
+    (void)connection; (void)sender; (void)object_path;
+    GVariant *value = mock_get((MockObject*) user_data, interface_name, property_name);
+    if (!value) {
+        g_set_error(error, G_DBUS_ERROR, G_DBUS_ERROR_UNKNOWN_PROPERTY, "No property %s", property_name);
+        return NULL;
+    }
+    return g_variant_ref(value);
+}
+
+static gboolean set_property(GDBusConnection *connection, const gchar *sender, const gchar *object_path,
+                             const gchar *interface_name, const gchar *property_name, GVariant *value,
+                             GError **error, gpointer user_data) {
+    (void)connection; (void)sender; (void)object_path;
+    MockObject *obj = (MockObject*) user_data;
+    if (obj == manager && g_strcmp0(property_name, "WirelessEnabled") == 0) {
+        set_wireless_enabled(g_variant_get_boolean(value));
+        return TRUE;
+    }
+    if (mock_get(obj, interface_name, property_name)) {
+        mock_set(obj, interface_name, property_name, value);
+        return TRUE;
+    }
+    g_set_error(error, G_DBUS_ERROR, G_DBUS_ERROR_PROPERTY_READ_ONLY, "%s is read-only", property_name);
+    return FALSE;
+}
+
+/* ---------- Initial state ---------- */
+
+static void build_initial_state(void) {
+    manager = mock_object_new(NM_DBUS_PATH, NULL);
+    MockObject *m = manager;
+    mock_set(m, NM_IFACE, "Devices", g_variant_new_objv(NULL, 0));
+    mock_set(m, NM_IFACE, "AllDevices", g_variant_new_objv(NULL, 0));
+    mock_set(m, NM_IFACE, "Checkpoints", g_variant_new_objv(NULL, 0));
+    mock_set(m, NM_IFACE, "NetworkingEnabled", g_variant_new_boolean(TRUE));
+    mock_set(m, NM_IFACE, "WirelessEnabled", g_variant_new_boolean(TRUE));
+    mock_set(m, NM_IFACE, "WirelessHardwareEnabled", g_variant_new_boolean(TRUE));
+    mock_set(m, NM_IFACE, "WwanEnabled", g_variant_new_boolean(FALSE));
+    mock_set(m, NM_IFACE, "WwanHardwareEnabled", g_variant_new_boolean(FALSE));
+    mock_set(m, NM_IFACE, "ActiveConnections", g_variant_new_objv(NULL, 0));
+    mock_set(m, NM_IFACE, "PrimaryConnection", g_variant_new_object_path("/"));
+    mock_set(m, NM_IFACE, "PrimaryConnectionType", g_variant_new_string(""));
+    mock_set(m, NM_IFACE, "Metered", g_variant_new_uint32(0));
+    mock_set(m, NM_IFACE, "ActivatingConnection", g_variant_new_object_path("/"));
+    mock_set(m, NM_IFACE, "Startup", g_variant_new_boolean(FALSE));
+    mock_set(m, NM_IFACE, "Version", g_variant_new_string("1.46.0"));
+    mock_set(m, NM_IFACE, "Capabilities", g_variant_new_array(G_VARIANT_TYPE_UINT32, NULL, 0));
+    mock_set(m, NM_IFACE, "State", g_variant_new_uint32(NM_STATE_DISCONNECTED));
+    mock_set(m, NM_IFACE, "Connectivity", g_variant_new_uint32(NM_CONNECTIVITY_NONE));
+    mock_set(m, NM_IFACE, "ConnectivityCheckAvailable", g_variant_new_boolean(FALSE));
+    mock_set(m, NM_IFACE, "ConnectivityCheckEnabled", g_variant_new_boolean(FALSE));
+    mock_set(m, NM_IFACE, "GlobalDnsConfiguration", g_variant_new_array(G_VARIANT_TYPE("{sv}"), NULL, 0));
+    mock_object_export(m);
+
+    settings = mock_object_new(SETTINGS_PATH, NULL);
+    mock_set(settings, SETTINGS_IFACE, "Connections", g_variant_new_objv(NULL, 0));
+    mock_set(settings, SETTINGS_IFACE, "Hostname", g_variant_new_string("mock"));
+    mock_set(settings, SETTINGS_IFACE, "CanModify", g_variant_new_boolean(TRUE));
+    mock_object_export(settings);
+
+    for (gint i = 0; i < opt_wifi_devices; i++) {
+        MockDevice *dev = device_new(NM_DEVICE_TYPE_WIFI, i);
+        device_add_aps(dev, opt_aps);
+    }
+
+    /* saved profiles for the first SSIDs of the first device */
+    MockDevice *first_wifi = find_device("/", NM_DEVICE_TYPE_WIFI);
+    for (gint i = 0; first_wifi && i < opt_saved && i < (gint) first_wifi->aps->len; i++) {
+        MockAp *ap = (MockAp*) g_ptr_array_index(first_wifi->aps, i);
+        GVariant *s = g_variant_ref_sink(wifi_settings(ap->ssid, ap->secured));
+        connection_add(s);
+        g_variant_unref(s);
+    }
+
+    if (opt_ethernet) {
+        MockDevice *eth = device_new(NM_DEVICE_TYPE_ETHERNET, 0);
+        GVariant *s = g_variant_ref_sink(g_variant_new_parsed("@a{sa{sv}} {'802-3-ethernet': @a{sv} {}}"));
+        MockConnection *wired = connection_add(s);
+        g_variant_unref(s);
+        active_start(wired, eth, NULL, TRUE);
+    }
+
+    mock_set(manager, NM_IFACE, "Devices", paths_variant(devices, device_obj));
+    mock_set(manager, NM_IFACE, "AllDevices", paths_variant(devices, device_obj));
+    publish_connections();
+}
+
+/* ---------- Commands ---------- */
+
+static GDataInputStream *commands = NULL;
+
+static void read_next_command(void);
+
+static gboolean resume_commands(gpointer user_data) {
+    (void)user_data;
+    read_next_command();
+    return G_SOURCE_REMOVE;
+}
+
+static void for_each_wifi_device(void (*fn)(MockDevice*, guint), guint n) {
+    for (guint i = 0; i < devices->len; i++) {
+        MockDevice *dev = (MockDevice*) g_ptr_array_index(devices, i);
+        if (dev->type == NM_DEVICE_TYPE_WIFI) fn(dev, n);
+    }
+}
+
+static void churn_device(MockDevice *dev, guint n) {
+    device_remove_aps(dev, n);
+    device_add_aps(dev, n);
+}
+
+static void jitter_device(MockDevice *dev, guint n) {
+    (void)n;
+    for (guint i = 0; i < dev->aps->len; i++) {
+        MockAp *ap = (MockAp*) g_ptr_array_index(dev->aps, i);
+        mock_set(ap->obj, AP_IFACE, "Strength", g_variant_new_byte((guint8) g_rand_int_range(rng, 5, 100)));
+    }
+}
+
+static void burst_device(MockDevice *dev, guint n) {
+    guint original = dev->state;
+    for (guint i = 0; i < n; i++) {
+        set_device_state(dev, i % 2 == 0 ? NM_DEVICE_STATE_PREPARE : original, 0);
+    }
+    set_device_state(dev, original, 0);
+}
+
+/* Returns the delay before the next command, or -1 to stop reading */
+static gint run_command(const gchar *line) {
+    gchar **argv = g_strsplit_set(g_strstrip((gchar*) line), " \t", 2);
+    const gchar *cmd = argv[0] ? argv[0] : "";
+    guint n = argv[0] && argv[1] ? (guint) g_ascii_strtoull(argv[1], NULL, 10) : 1;
+    gint delay = 0;
+
+    if (!*cmd || cmd[0] == '#') {
+        /* blank line or comment */
+    } else if (g_strcmp0(cmd, "churn") == 0) {
+        for_each_wifi_device(churn_device, n);
+    } else if (g_strcmp0(cmd, "add-aps") == 0) {
+        for_each_wifi_device(device_add_aps, n);
+    } else if (g_strcmp0(cmd, "remove-aps") == 0) {
+        for_each_wifi_device(device_remove_aps, n);
+    } else if (g_strcmp0(cmd, "jitter") == 0) {
+        for_each_wifi_device(jitter_device, 0);
+    } else if (g_strcmp0(cmd, "burst") == 0) {
+        for_each_wifi_device(burst_device, n);
+    } else if (g_strcmp0(cmd, "wifi") == 0) {
+        set_wireless_enabled(g_strcmp0(g_strstrip(argv[1] ? argv[1] : (gchar*) ""), "off") != 0);
+    } else if (g_strcmp0(cmd, "networking") == 0) {
+        mock_set(manager, NM_IFACE, "NetworkingEnabled",
+                 g_variant_new_boolean(g_strcmp0(g_strstrip(argv[1] ? argv[1] : (gchar*) ""), "off") != 0));
+    } else if (g_strcmp0(cmd, "sleep") == 0) {
+        delay = (gint) n;
+    } else if (g_strcmp0(cmd, "quit") == 0) {
+        g_main_loop_quit(loop);
+        delay = -1;
+    } else {
+        g_printerr("mock-nm: unknown command \"%s\"\n", cmd);
+    }
+    g_strfreev(argv);
+    return delay;
+}
+
+static void on_command_line(GObject *source, GAsyncResult *result, gpointer user_data) {
+    (void)user_data;
+    gchar *line = g_data_input_stream_read_line_finish_utf8(G_DATA_INPUT_STREAM(source), result, NULL, NULL);
+    if (!line) return;  // EOF: keep serving until killed
+
+    gint delay = run_command(line);
+    g_free(line);
+    if (delay > 0) g_timeout_add(delay, resume_commands, NULL);
+    else if (delay == 0) read_next_command();
+}
+
+static void read_next_command(void) {
+    g_data_input_stream_read_line_async(commands, G_PRIORITY_DEFAULT, NULL, on_command_line, NULL);
+}
+
+/* ---------- main ---------- */
+
+static void on_name_acquired(GDBusConnection *connection, const gchar *name, gpointer user_data) {
+    (void)connection; (void)user_data;
+    g_print("mock-nm: serving %s with %u devices, %u connections\n", name, devices->len, connections->len);
+
+    GInputStream *in = g_unix_input_stream_new(STDIN_FILENO, FALSE);
+    commands = g_data_input_stream_new(in);
+    g_object_unref(in);
+    read_next_command();
+}
+
+static void on_name_lost(GDBusConnection *connection, const gchar *name, gpointer user_data) {
+    (void)connection; (void)user_data;
+    g_printerr("mock-nm: could not own %s (is a real NetworkManager on this bus?)\n", name);
+    g_main_loop_quit(loop);
+}
+
+static gboolean on_terminate(gpointer user_data) {
+    (void)user_data;
+    g_main_loop_quit(loop);
+    return G_SOURCE_REMOVE;
+}
+
+int main(int argc, char *argv[]) {
+    GError *error = NULL;
+    GOptionContext *context = g_option_context_new("- mock NetworkManager D-Bus service");
+    g_option_context_add_main_entries(context, option_entries, NULL);
+    if (!g_option_context_parse(context, &argc, &argv, &error)) {
+        g_printerr("mock-nm: %s\n", error->message);
+        return 2;
+    }
+    g_option_context_free(context);
+
+    bus = g_bus_get_sync(G_BUS_TYPE_SYSTEM, NULL, &error);
+    if (!bus) {
+        g_printerr("mock-nm: no bus (set DBUS_SYSTEM_BUS_ADDRESS): %s\n", error->message);
+        return 1;
+    }
+
+    introspection = g_dbus_node_info_new_for_xml(introspection_xml, &error);
+    g_assert_no_error(error);
+
+    rng = g_rand_new_with_seed((guint32) opt_seed);
+    objects = g_hash_table_new(g_str_hash, g_str_equal);
+    devices = g_ptr_array_new();
+    connections = g_ptr_array_new();
+    actives = g_ptr_array_new();
+
+    g_dbus_connection_register_object(bus, OBJECT_MANAGER_PATH,
+                                      g_dbus_node_info_lookup_interface(introspection, "org.freedesktop.DBus.ObjectManager"),
+                                      &vtable, NULL, NULL, NULL);
+    build_initial_state();
+
+    loop = g_main_loop_new(NULL, FALSE);
+    g_unix_signal_add(SIGINT, on_terminate, NULL);
+    g_unix_signal_add(SIGTERM, on_terminate, NULL);
+    g_bus_own_name_on_connection(bus, NM_DBUS_NAME, G_BUS_NAME_OWNER_FLAGS_NONE,
+                                 on_name_acquired, on_name_lost, NULL, NULL);
+    g_main_loop_run(loop);
+    return 0;
+}
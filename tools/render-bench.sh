@@ -0,0 +1,43 @@
+#!/bin/sh
+# Headless render benchmark: runs elysia-welcome --render-bench on the
+# software (Cairo) GSK renderer inside a headless Weston, or Xvfb when
+# Weston isn't installed, so results don't depend on a GPU or a session.
+#
+#   tools/render-bench.sh [PNG_DIR]
+#
+# With PNG_DIR every page is also saved as <theme>-<page>.png there, for
+# comparing against golden images.
+set -eu
+
+here=$(cd "$(dirname "$0")" && pwd)
+top=$(dirname "$here")
+app="$top/elysia-welcome"
+[ -x "$app" ] || make -C "$top" >/dev/null
+
+set -- --render-bench ${1:+--render-bench-png="$1"}
+
+export GSK_RENDERER=cairo
+export GTK_A11Y=none
+export NO_AT_BRIDGE=1
+# fixed scale so runs are comparable
+export GDK_SCALE=1
+
+if command -v weston >/dev/null 2>&1; then
+    runtime=$(mktemp -d)
+    weston_pid=""
+    trap 'kill $weston_pid 2>/dev/null || true; rm -rf "$runtime"' EXIT INT TERM
+    export XDG_RUNTIME_DIR="$runtime"
+    weston --backend=headless --socket=welcome-bench --width=1280 --height=1024 --idle-time=0 \
+        >"$runtime/weston.log" 2>&1 &
+    weston_pid=$!
+    for _ in $(seq 50); do
+        [ -S "$runtime/welcome-bench" ] && break
+        sleep 0.1
+    done
+    WAYLAND_DISPLAY=welcome-bench GDK_BACKEND=wayland "$app" "$@"
+elif command -v xvfb-run >/dev/null 2>&1; then
+    GDK_BACKEND=x11 xvfb-run -a -s "-screen 0 1280x1024x24" "$app" "$@"
+else
+    echo "render-bench: needs weston or xvfb-run" >&2
+    exit 1
+fi
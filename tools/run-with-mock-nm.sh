@@ -0,0 +1,68 @@
+#!/bin/sh
+# Run elysia-welcome against tools/mock-nm on a private system bus.
+#
+#   tools/run-with-mock-nm.sh [mock-nm options] [-- welcome options] [< commands]
+#
+# Standard input is forwarded to mock-nm, so a command file drives the
+# network churn while the app runs, e.g.
+#
+#   printf 'sleep 3000\nchurn 10\nsleep 1000\nburst 20\n' |
+#       WELCOME_WATCHDOG=16 tools/run-with-mock-nm.sh --aps 200
+#
+# Everything is torn down when the app exits.
+set -eu
+
+here=$(cd "$(dirname "$0")" && pwd)
+top=$(dirname "$here")
+
+mock_args=""
+while [ $# -gt 0 ] && [ "$1" != "--" ]; do
+    mock_args="$mock_args $1"
+    shift
+done
+[ $# -gt 0 ] && shift
+
+[ -x "$here/mock-nm" ] || make -C "$top" mock-nm >/dev/null
+
+config=$(mktemp)
+mock_pid=""
+bus_pid=""
+trap 'kill $mock_pid $bus_pid 2>/dev/null || true; rm -f "$config"' EXIT INT TERM
+
+cat > "$config" <<XML
+<!DOCTYPE busconfig PUBLIC "-//freedesktop//DTD D-BUS Bus Configuration 1.0//EN"
+ "http://www.freedesktop.org/standards/dbus/1.0/busconfig.dtd">
+<busconfig>
+  <type>system</type>
+  <listen>unix:tmpdir=/tmp</listen>
+  <auth>EXTERNAL</auth>
+  <policy context="default">
+    <allow user="*"/>
+    <allow own="*"/>
+    <allow send_destination="*"/>
+    <allow receive_sender="*"/>
+  </policy>
+</busconfig>
+XML
+
+eval "$(dbus-daemon --config-file="$config" --fork --print-address=1 --print-pid=1 |
+        { read -r address; read -r pid; echo "DBUS_SYSTEM_BUS_ADDRESS='$address' bus_pid=$pid"; })"
+export DBUS_SYSTEM_BUS_ADDRESS
+
+# background jobs get /dev/null as stdin unless told otherwise
+exec 3<&0
+# shellcheck disable=SC2086
+"$here/mock-nm" $mock_args <&3 &
+mock_pid=$!
+
+# wait for the name so NMClient never sees an empty bus
+for _ in $(seq 50); do
+    if dbus-send --system --print-reply --dest=org.freedesktop.DBus / \
+           org.freedesktop.DBus.NameHasOwner string:org.freedesktop.NetworkManager 2>/dev/null |
+           grep -q 'boolean true'; then
+        break
+    fi
+    sleep 0.1
+done
+
+"$top/elysia-welcome" "$@" </dev/null
@@ -49,6 +49,10 @@ typedef struct {
     const char* connected_status;
     const char* saved_status;
     const char* secured_status;
+    const char* search_networks_placeholder;
+    const char* connecting_status;
+    const char* connection_failed_status;
+    const char* autoconnect_status;
     
     // Keybind translations
     const char* keybind_close_window;
@@ -121,6 +125,10 @@ static const Translations en_translations = {
     "Connected",
     "Saved",
     "Secured",
+    "Search networks",
+    "Connecting…",
+    "Connection failed",
+    "Connecting to \"%s\" automatically…",
     
     // Keybind translations
     "Close focused window",
@@ -193,6 +201,10 @@ static const Translations fr_translations = {
     "Connecté",
     "Enregistré",
     "Sécurisé",
+    "Rechercher des réseaux",
+    "Connexion…",
+    "Échec de la connexion",
+    "Connexion automatique à « %s »…",
     
     // Keybind translations
     "Fermer la fenêtre active",
@@ -265,6 +277,10 @@ static const Translations es_translations = {
     "Conectado",
     "Guardado",
     "Protegido",
+    "Buscar redes",
+    "Conectando…",
+    "Error de conexión",
+    "Conectando automáticamente a \"%s\"…",
     
     // Keybind translations
     "Cerrar ventana enfocada",
@@ -337,6 +353,10 @@ static const Translations ru_translations = {
     "Подключено",
     "Сохранено",
     "Защищено",
+    "Поиск сетей",
+    "Подключение…",
+    "Не удалось подключиться",
+    "Автоматическое подключение к «%s»…",
     
     // Keybind translations
     "Закрыть активное окно",
@@ -409,6 +429,10 @@ static const Translations vi_translations = {
     "Đã kết nối",
     "Đã lưu",
     "Đã bảo mật",
+    "Tìm mạng",
+    "Đang kết nối…",
+    "Kết nối thất bại",
+    "Đang tự động kết nối tới \"%s\"…",
     
     // Keybind translations
     "Đóng cửa sổ đang tập trung",
@@ -481,6 +505,10 @@ static const Translations id_translations = {
     "Terhubung",
     "Tersimpan",
     "Diamankan",
+    "Cari jaringan",
+    "Menghubungkan…",
+    "Koneksi gagal",
+    "Menghubungkan otomatis ke \"%s\"…",
     
     // Keybind translations
     "Tutup jendela yang difokuskan",
@@ -553,6 +581,10 @@ static const Translations ja_translations = {
     "接続済み",
     "保存済み",
     "保護済み",
+    "ネットワークを検索",
+    "接続中…",
+    "接続に失敗しました",
+    "「%s」に自動接続しています…",
     
     // Keybind translations
     "フォーカスされたウィンドウを閉じる",
@@ -625,6 +657,10 @@ static const Translations zh_translations = {
     "已连接",
     "已保存",
     "已保护",
+    "搜索网络",
+    "正在连接…",
+    "连接失败",
+    "正在自动连接到“%s”…",
     
     // Keybind translations
     "关闭焦点窗口",
@@ -2,8 +2,22 @@
 #include <glib.h>
 #include <gio/gio.h>
 #include <NetworkManager.h>
+#include <cstddef>
 #include <cstring>
+#include <cstdlib>
+#include <cerrno>
 #include "translations.h"
+#include "logging.h"
+#include "perf.h"
+#include "latency.h"
+#include "census.h"
+#include "startup.h"
+#include "task_graph.h"
+#include "wifi_helpers.h"
+#include "theme_css.h"
+#include "keybinds_view.h"
+#include "hypr_keybinds.h"
+#include "render_quality.h"
 
 /* Declare resource functions */
 extern "C" {
@@ -25,6 +39,22 @@ typedef struct {
     GtkWidget *wifi_switch;
     GtkWidget *wifi_list_box;
     GtkWidget *wifi_refresh_btn;
+    GtkWidget *wifi_search_entry;
+    GtkWidget *network_status_label;
+
+    // Keybinds page
+    GtkWidget *keybinds_view;
+
+    // Complete page
+    GtkWidget *complete_logo;
+
+    // Wi-Fi list model: store -> filter -> sort -> wifi_list_box
+    GListStore *wifi_store;
+    GtkFilter  *wifi_filter;
+    GtkSorter  *wifi_sorter;
+    guint       wifi_resort_id;
+    gchar      *wifi_query;
+    const gchar *wifi_list_message;
 
     NMClient  *nm_client;
     int        current_page;
@@ -44,8 +74,63 @@ typedef struct {
     gboolean   networking_enabled;
     gboolean   has_ethernet_connection;
     guint      update_timeout_id;
+    guint      populate_timeout_id;  // list refresh 2 s after a scan request
+
+    // Connection attempts (ssid -> WifiActivation) and time-to-IP telemetry
+    GHashTable *activations;
+    GArray     *activation_times_ms;
+    guint       activation_failures;
+
+    // Startup auto-connect: evaluated once, when the first scan results are in
+    gboolean      autoconnect_checked;
+    gchar        *autoconnect_ssid;
+    NMDeviceWifi *autoconnect_device;  // followed for notify::last-scan until then
+
+    // Everything async is scoped to the window: NM requests and subprocess
+    // waits share this cancellable, timers are tracked in the registry
+    GCancellable *cancellable;
+    GHashTable   *timers;
+
+    // Background work is paused while the window is unfocused, minimised
+    // or suspended; list rebuilds requested meanwhile are replayed once
+    gboolean   background_paused;
+    gboolean   pending_network_refresh;
+
+    // NM signal subscriptions only exist while the network page is shown
+    gboolean   network_page_visible;
+    gboolean   nm_subscribed;
+    GPtrArray *subscribed_devices;
+
+    // Frame timing overlay, only allocated with WELCOME_HUD set
+    struct FrameHud *hud;
+
+    // Frame clock hooks timing a theme restyle, only while one is pending
+    struct RestyleTiming *restyle;
+
+    // SIGUSR1 prints the memory report (and input latency, see latency.h)
+    guint      memory_report_signal_id;
+
+    // --census-rescans: simulated rescans still to run, counts after warm-up
+    guint       census_rescans_left;
+    GHashTable *census_baseline;
+
+    // --render-bench: frame clock hooks for the transition pass
+    struct RenderBench *bench;
+
+    // --script: walkthrough being replayed
+    struct ScriptRun *script;
 } WelcomeApp;
 
+/* ---------- Command line ---------- */
+static gboolean opt_memory_report = FALSE;
+static gint opt_census_rescans = 0;
+static int census_exit_status = 0;
+static gboolean opt_render_bench = FALSE;
+static gchar *opt_render_bench_png = NULL;
+static gchar *opt_script = NULL;
+static gchar *opt_script_results = NULL;
+static int script_exit_status = 0;
+
 /* ---------- Forward declarations ---------- */
 /* navigation / pages */
 static void update_page_indicators(WelcomeApp *app);
@@ -53,7 +138,7 @@ static void update_navigation(WelcomeApp *app);
 static GtkWidget* create_welcome_page(WelcomeApp *app);
 static GtkWidget* create_theme_page(WelcomeApp *app);
 static GtkWidget* create_network_page(WelcomeApp *app);
-static GtkWidget* create_keybinds_page(void);
+static GtkWidget* create_keybinds_page(WelcomeApp *app);
 static GtkWidget* create_updater_page(void);
 static GtkWidget* create_settings_page(void);
 static GtkWidget* create_store_page(void);
@@ -69,21 +154,25 @@ static void on_finish_clicked(GtkButton *button, WelcomeApp *app);
 
 /* Wi-Fi helpers */
 static NMDeviceWifi* get_primary_wifi_device(NMClient *client);
-static gchar* ssid_from_bytes(GBytes *ssid_bytes);
-static gboolean ap_is_secured(NMAccessPoint *ap);
-static NMRemoteConnection* find_saved_connection_for_ssid(NMClient *client, const gchar *ssid);
-static gboolean ssid_equal(const gchar *a, const gchar *b);
+
+static GtkWidget* create_ap_row(gpointer item, gpointer user_data);
+static void refresh_ap_row_status(WelcomeApp *app, GtkWidget *row);
+static void refresh_wifi_row_statuses(WelcomeApp *app);
+static void sync_wifi_store(WelcomeApp *app, const GPtrArray *aps);
+static gboolean wifi_filter_func(gpointer item, gpointer user_data);
+static int wifi_sort_func(gconstpointer a, gconstpointer b, gpointer user_data);
+static void on_wifi_search_changed(GtkSearchEntry *entry, WelcomeApp *app);
 
 static void scan_wifi_networks(WelcomeApp *app);
 static void populate_wifi_list_now(WelcomeApp *app);
 static gboolean populate_wifi_list_timeout(gpointer user_data);
+static void autoconnect_best_known_network(WelcomeApp *app);
 static void on_wifi_refresh_clicked(GtkButton *button, WelcomeApp *app);
 static gboolean on_wifi_switch_state_set(GtkSwitch *sw, gboolean state, WelcomeApp *app);
 static void reflect_wifi_switch_state(WelcomeApp *app);
 
 /* Network state helpers */
 static gboolean check_networking_enabled(NMClient *client);
-static gboolean check_ethernet_connection(NMClient *client);
 static void update_network_state(WelcomeApp *app);
 static gboolean update_network_state_timeout(gpointer user_data);
 static void enable_networking(WelcomeApp *app);
@@ -98,20 +187,89 @@ static gboolean theme_check_timeout(gpointer user_data);
 static void on_wifi_connect_clicked(GtkButton *button, gpointer user_data);
 static void on_connect_button_clicked(GtkButton *button, gpointer user_data);
 static void on_password_dialog_destroy(GtkWidget *dialog, gpointer user_data);
-static void add_and_activate_psk(NMClient *client, NMDeviceWifi *wifi_dev, NMAccessPoint *ap, const gchar *ssid, const gchar *psk);
-static void activate_saved_connection(NMClient *client, NMRemoteConnection *conn, NMDevice *dev);
+static void show_password_dialog(WelcomeApp *app, NMDeviceWifi *wifi_dev, NMAccessPoint *ap, const gchar *ssid,
+                                 NMRemoteConnection *saved);
+static void add_and_activate_psk(WelcomeApp *app, NMDeviceWifi *wifi_dev, NMAccessPoint *ap, const gchar *ssid, const gchar *psk);
+static void add_and_activate_open(WelcomeApp *app, NMDeviceWifi *wifi_dev, NMAccessPoint *ap, const gchar *ssid);
+static void activate_saved_connection(WelcomeApp *app, NMRemoteConnection *conn, NMDeviceWifi *wifi_dev, NMAccessPoint *ap, const gchar *ssid);
+static const gchar* wifi_activation_status_text(WelcomeApp *app, const gchar *ssid, gboolean *in_progress);
 
 static void on_nm_notify_wireless_enabled(GObject *gobj, GParamSpec *pspec, gpointer user_data);
 static void on_nm_client_changed(NMClient *client, gpointer user_data);
 static void on_wifi_device_props_changed(GObject *gobj, GParamSpec *pspec, gpointer user_data);
+static void on_nm_device_added_removed(NMClient *client, NMDevice *device, gpointer user_data);
+static void on_nm_connection_added_removed(NMClient *client, GObject *connection, gpointer user_data);
+static void attach_network_subscriptions(WelcomeApp *app);
+static void detach_network_subscriptions(WelcomeApp *app);
+static void reconcile_network_page(WelcomeApp *app);
 
 /* lifecycle */
 static void on_window_destroy(GtkWidget *w, gpointer user_data);
 static void activate(GtkApplication *app_gtk, gpointer user_data);
 
 /* ---------- Small UI helpers ---------- */
+
+/* The icons the app itself asks for are bundled under BUNDLED_ICON_PATH in
+   hicolor layout. make_icon_image() loads them straight from the resource,
+   so the system icon theme is never indexed for them and they still show
+   on minimal live media. The path is also registered with the icon theme,
+   so GTK's own widgets (e.g. the search entry) fall back to the bundle. */
+#define BUNDLED_ICON_PATH "/org/elysiaos/welcome/icons"
+#define BUNDLED_ICON_DEFAULT_SIZE 16
+
+static GHashTable *bundled_icons = NULL;  // "name@size" -> GtkIconPaintable, shared by all images
+
+static void register_bundled_icons(void) {
+    GdkDisplay *display = gdk_display_get_default();
+    if (display) gtk_icon_theme_add_resource_path(gtk_icon_theme_get_for_display(display), BUNDLED_ICON_PATH);
+}
+
+/* Render at the largest monitor scale so HiDPI outputs stay sharp */
+static int bundled_icon_scale(void) {
+    GdkDisplay *display = gdk_display_get_default();
+    GListModel *monitors = display ? gdk_display_get_monitors(display) : NULL;
+    int scale = 1;
+    for (guint i = 0; monitors && i < g_list_model_get_n_items(monitors); i++) {
+        GdkMonitor *monitor = GDK_MONITOR(g_list_model_get_item(monitors, i));
+        scale = MAX(scale, gdk_monitor_get_scale_factor(monitor));
+        g_object_unref(monitor);
+    }
+    return scale;
+}
+
+static GdkPaintable* lookup_bundled_icon(const char *icon_name, int pixel_size) {
+    static const char *contexts[] = { "actions", "status" };
+    int size = pixel_size > 0 ? pixel_size : BUNDLED_ICON_DEFAULT_SIZE;
+    gchar *key = g_strdup_printf("%s@%d", icon_name, size);
+    if (!bundled_icons) bundled_icons = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_object_unref);
+
+    GdkPaintable *paintable = (GdkPaintable*) g_hash_table_lookup(bundled_icons, key);
+    for (guint i = 0; !paintable && i < G_N_ELEMENTS(contexts); i++) {
+        gchar *path = g_strdup_printf(BUNDLED_ICON_PATH "/scalable/%s/%s.svg", contexts[i], icon_name);
+        if (g_resources_get_info(path, G_RESOURCE_LOOKUP_FLAGS_NONE, NULL, NULL, NULL)) {
+            gchar *uri = g_strconcat("resource://", path, NULL);
+            GFile *file = g_file_new_for_uri(uri);
+            paintable = GDK_PAINTABLE(gtk_icon_paintable_new_for_file(file, size, bundled_icon_scale()));
+            g_hash_table_insert(bundled_icons, g_strdup(key), paintable);
+            g_object_unref(file);
+            g_free(uri);
+        }
+        g_free(path);
+    }
+    g_free(key);
+    return paintable;
+}
+
+static void set_icon_image(GtkWidget *img, const char *icon_name, int pixel_size) {
+    GdkPaintable *bundled = lookup_bundled_icon(icon_name, pixel_size);
+    if (!bundled) log_debug(LOG_UI, "Icon %s is not bundled, using the icon theme", icon_name);
+    if (bundled) gtk_image_set_from_paintable(GTK_IMAGE(img), bundled);
+    else         gtk_image_set_from_icon_name(GTK_IMAGE(img), icon_name);
+}
+
 static GtkWidget* make_icon_image(const char *icon_name, int pixel_size) {
-    GtkWidget *img = gtk_image_new_from_icon_name(icon_name);
+    GtkWidget *img = gtk_image_new();
+    set_icon_image(img, icon_name, pixel_size);
     if (pixel_size > 0) gtk_image_set_pixel_size(GTK_IMAGE(img), pixel_size);
     return img;
 }
@@ -122,16 +280,158 @@ static GtkWidget* make_icon_button(const char *icon_name, int pixel_size) {
     return btn;
 }
 
-static GtkWidget* make_resource_image(const char *resource_path, int pixel_size) {
-    GError *error = NULL;
-    GdkTexture *texture = gdk_texture_new_from_resource(resource_path);
+/* ---------- Texture registry ---------- */
+
+/* Decoded bytes of every live texture, per resource, so the HUD and the
+   memory report can attribute texture memory. Entries stay at zero once
+   all their textures are gone. */
+typedef struct {
+    gsize bytes;
+    guint live;
+} TextureUsage;
+
+typedef struct {
+    gchar *resource_path;
+    gsize  bytes;
+} TextureRecord;
+
+static GHashTable *texture_usage = NULL;  // resource path -> TextureUsage
+static gsize texture_bytes_total = 0;
+
+static void on_texture_finalized(gpointer data, GObject *where_the_object_was) {
+    (void)where_the_object_was;
+    TextureRecord *rec = (TextureRecord*) data;
+    TextureUsage *usage = (TextureUsage*) g_hash_table_lookup(texture_usage, rec->resource_path);
+    if (usage) {
+        usage->bytes -= rec->bytes;
+        usage->live--;
+    }
+    texture_bytes_total -= rec->bytes;
+    g_free(rec->resource_path);
+    g_free(rec);
+}
+
+static GdkTexture* take_prefetched_texture(const char *resource_path);
+static gboolean defer_prefetched_texture(GtkWidget *widget, const char *resource_path);
+
+static void account_texture(GdkTexture *texture, const char *resource_path) {
+    if (!texture_usage) texture_usage = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+    TextureUsage *usage = (TextureUsage*) g_hash_table_lookup(texture_usage, resource_path);
+    if (!usage) {
+        usage = g_new0(TextureUsage, 1);
+        g_hash_table_insert(texture_usage, g_strdup(resource_path), usage);
+    }
+
+    // Our PNGs decode to 8-bit RGBA
+    TextureRecord *rec = g_new0(TextureRecord, 1);
+    rec->resource_path = g_strdup(resource_path);
+    rec->bytes = (gsize) gdk_texture_get_width(texture) * gdk_texture_get_height(texture) * 4;
+    usage->bytes += rec->bytes;
+    usage->live++;
+    texture_bytes_total += rec->bytes;
+    g_object_set_data(G_OBJECT(texture), "welcome-texture-record", rec);
+    g_object_weak_ref(G_OBJECT(texture), on_texture_finalized, rec);
+}
+
+/* The reduced render quality variant of texture, made once and shared by
+   every widget showing texture. Takes the caller's reference. */
+static GdkTexture* reduce_texture(GdkTexture *texture) {
+    GdkTexture *reduced = (GdkTexture*) g_object_get_data(G_OBJECT(texture), "welcome-reduced-texture");
+    if (reduced) {
+        g_object_ref(reduced);
+        g_object_unref(texture);
+        return reduced;
+    }
+
+    PerfSpan span = perf_span_begin("reduce_texture");
+    reduced = render_quality_reduce_texture(texture);
+    perf_span_end_with(&span, "%dx%d to %dx%d", gdk_texture_get_width(texture), gdk_texture_get_height(texture),
+                       gdk_texture_get_width(reduced), gdk_texture_get_height(reduced));
+    if (reduced == texture) {
+        /* already small (or reduced on the startup worker) */
+        g_object_unref(reduced);
+        return texture;
+    }
+
+    TextureRecord *rec = (TextureRecord*) g_object_get_data(G_OBJECT(texture), "welcome-texture-record");
+    if (rec) account_texture(reduced, rec->resource_path);
+    g_object_set_data_full(G_OBJECT(texture), "welcome-reduced-texture", g_object_ref(reduced), g_object_unref);
+    g_object_unref(texture);
+    return reduced;
+}
+
+static GdkTexture* load_resource_texture(const char *resource_path) {
+    GdkTexture *texture = take_prefetched_texture(resource_path);
     if (texture == NULL) {
-        g_warning("Failed to load resource %s: %s", resource_path, error->message);
-        g_error_free(error);
-        return make_icon_image("image-missing", pixel_size);
+        PerfSpan span = perf_span_begin("load_resource_texture");
+        texture = gdk_texture_new_from_resource(resource_path);
+        perf_span_end_with(&span, "decoding %s", resource_path);
     }
-    
-    GtkWidget *image = gtk_image_new_from_paintable(GDK_PAINTABLE(texture));
+    if (texture == NULL) {
+        log_warning(LOG_UI, "Failed to load resource %s", resource_path);
+        return NULL;
+    }
+
+    /* prefetched textures are shared by every widget showing that resource */
+    if (!g_object_get_data(G_OBJECT(texture), "welcome-texture-record")) account_texture(texture, resource_path);
+    return render_quality_reduced_textures() ? reduce_texture(texture) : texture;
+}
+
+/* Swap every texture under widget for its reduced variant; pages are stack
+   children, so this reaches the hidden ones too */
+static void reduce_widget_textures(GtkWidget *widget) {
+    GdkPaintable *paintable = NULL;
+    if (GTK_IS_PICTURE(widget)) {
+        paintable = gtk_picture_get_paintable(GTK_PICTURE(widget));
+    } else if (GTK_IS_IMAGE(widget) && gtk_image_get_storage_type(GTK_IMAGE(widget)) == GTK_IMAGE_PAINTABLE) {
+        paintable = gtk_image_get_paintable(GTK_IMAGE(widget));
+    }
+    if (GDK_IS_TEXTURE(paintable)) {
+        GdkTexture *reduced = reduce_texture(GDK_TEXTURE(g_object_ref(paintable)));
+        if (GDK_PAINTABLE(reduced) != paintable) {
+            if (GTK_IS_PICTURE(widget)) gtk_picture_set_paintable(GTK_PICTURE(widget), GDK_PAINTABLE(reduced));
+            else gtk_image_set_from_paintable(GTK_IMAGE(widget), GDK_PAINTABLE(reduced));
+        }
+        g_object_unref(reduced);
+    }
+    for (GtkWidget *child = gtk_widget_get_first_child(widget); child; child = gtk_widget_get_next_sibling(child)) {
+        reduce_widget_textures(child);
+    }
+}
+
+/* The render quality dropped after a slow transition: reduced textures
+   from now on, and for everything already built */
+static void on_render_quality_changed(RenderQualityLevel level, gpointer user_data) {
+    WelcomeApp *app = (WelcomeApp*) user_data;
+    if (level < RENDER_QUALITY_REDUCED) return;
+    PerfSpan span = perf_span_begin("reduce_widget_textures");
+    reduce_widget_textures(app->window);
+    perf_span_end_with(&span, "%.1f MiB decoded", texture_bytes_total / (1024.0 * 1024.0));
+}
+
+/* Show resource_path in a GtkPicture or GtkImage; an image that failed to
+   load shows "image-missing" instead */
+static void set_resource_texture(GtkWidget *widget, const char *resource_path) {
+    GdkTexture *texture = load_resource_texture(resource_path);
+    if (GTK_IS_PICTURE(widget)) {
+        gtk_picture_set_paintable(GTK_PICTURE(widget), texture ? GDK_PAINTABLE(texture) : NULL);
+    } else if (texture) {
+        gtk_image_set_from_paintable(GTK_IMAGE(widget), GDK_PAINTABLE(texture));
+    } else {
+        set_icon_image(widget, "image-missing", gtk_image_get_pixel_size(GTK_IMAGE(widget)));
+    }
+    if (texture) g_object_unref(texture);
+}
+
+/* gtk_picture_new_for_resource(), but accounted in the texture registry */
+static GtkWidget* make_resource_picture(const char *resource_path) {
+    GtkWidget *picture = gtk_picture_new();
+    if (!defer_prefetched_texture(picture, resource_path)) set_resource_texture(picture, resource_path);
+    return picture;
+}
+
+static GtkWidget* make_resource_image(const char *resource_path, int pixel_size) {
+    GtkWidget *image = gtk_image_new();
     if (pixel_size > 0) {
         gtk_image_set_pixel_size(GTK_IMAGE(image), pixel_size);
     }
@@ -140,7 +440,7 @@ static GtkWidget* make_resource_image(const char *resource_path, int pixel_size)
     gtk_widget_set_vexpand(GTK_WIDGET(image), TRUE);
     gtk_widget_set_halign(GTK_WIDGET(image), GTK_ALIGN_CENTER);
     gtk_widget_set_valign(GTK_WIDGET(image), GTK_ALIGN_CENTER);
-    g_object_unref(texture);
+    if (!defer_prefetched_texture(image, resource_path)) set_resource_texture(image, resource_path);
     return image;
 }
 
@@ -157,23 +457,13 @@ static GtkWidget* create_theme_button(const char *resource_path, const char *lab
     GtkWidget *overlay = gtk_overlay_new();
     
     // Create the background image
-    GError *error = NULL;
-    GdkTexture *texture = gdk_texture_new_from_resource(resource_path);
-    if (texture == NULL) {
-        g_warning("Failed to load resource %s: %s", resource_path, error->message);
-        g_error_free(error);
-        GtkWidget *placeholder = make_icon_image("image-missing", -1);
-        gtk_overlay_set_child(GTK_OVERLAY(overlay), placeholder);
-    } else {
-        GtkWidget *picture = gtk_picture_new_for_paintable(GDK_PAINTABLE(texture));
-        gtk_widget_set_hexpand(picture, FALSE);  // Don't expand
-        gtk_widget_set_vexpand(picture, FALSE);  // Don't expand
-        gtk_picture_set_content_fit(GTK_PICTURE(picture), GTK_CONTENT_FIT_COVER);
-        gtk_picture_set_content_fit(GTK_PICTURE(picture), GTK_CONTENT_FIT_CONTAIN);
-        gtk_widget_set_size_request(picture, 130, 70);  // Set picture size directly
-        gtk_overlay_set_child(GTK_OVERLAY(overlay), picture);
-        g_object_unref(texture);
-    }
+    GtkWidget *picture = make_resource_picture(resource_path);
+    gtk_widget_set_hexpand(picture, FALSE);  // Don't expand
+    gtk_widget_set_vexpand(picture, FALSE);  // Don't expand
+    gtk_picture_set_content_fit(GTK_PICTURE(picture), GTK_CONTENT_FIT_COVER);
+    gtk_picture_set_content_fit(GTK_PICTURE(picture), GTK_CONTENT_FIT_CONTAIN);
+    gtk_widget_set_size_request(picture, 130, 70);  // Set picture size directly
+    gtk_overlay_set_child(GTK_OVERLAY(overlay), picture);
     
     // Create a box to hold the label
     GtkWidget *label_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 0);
@@ -199,6 +489,76 @@ static GtkWidget* create_theme_button(const char *resource_path, const char *lab
     return button;
 }
 
+/* ---------- Window-scoped async operations ---------- */
+
+/* A timer owned by the app; dropped from app->timers when its source goes
+   away, or all at once by app_cancel_operations() */
+typedef struct {
+    WelcomeApp *app;
+    GSourceFunc func;
+    gpointer    data;       // what func is called with: the app, or app_timeout_add_data()'s
+    const char *name;
+    guint       id;
+    gboolean    detached;
+} AppTimer;
+
+static gboolean app_timer_dispatch(gpointer data) {
+    AppTimer *t = (AppTimer*) data;
+    PerfSpan span = perf_span_begin(t->name);
+    gboolean ret = t->func(t->data);
+    perf_span_end(&span);
+    return ret;
+}
+
+static void app_timer_free(gpointer data) {
+    AppTimer *t = (AppTimer*) data;
+    if (!t->detached) g_hash_table_remove(t->app->timers, t);
+    g_free(t);
+}
+
+/* g_timeout_add() for callbacks that take the WelcomeApp; the source is
+   named after the callback so stall reports can attribute it */
+#define app_timeout_add(app, interval_ms, func) app_timeout_add_named((app), (interval_ms), (func), (app), #func)
+/* The same for callbacks on an object the app owns; data must stay valid
+   until the timer fires or its owner removes it */
+#define app_timeout_add_data(app, interval_ms, func, data) \
+    app_timeout_add_named((app), (interval_ms), (func), (data), #func)
+
+static guint app_timeout_add_named(WelcomeApp *app, guint interval_ms, GSourceFunc func, gpointer data, const char *name) {
+    AppTimer *t = g_new0(AppTimer, 1);
+    t->app = app;
+    t->func = func;
+    t->data = data;
+    t->name = name;
+    t->id = g_timeout_add_full(G_PRIORITY_DEFAULT, interval_ms, app_timer_dispatch, t, app_timer_free);
+    g_source_set_name_by_id(t->id, name);
+    g_hash_table_add(app->timers, t);
+    return t->id;
+}
+
+/* Cancel every in-flight NM request / subprocess wait and remove every
+   pending timer. Late async callbacks see G_IO_ERROR_CANCELLED and must
+   not touch the app. */
+static void app_cancel_operations(WelcomeApp *app) {
+    g_cancellable_cancel(app->cancellable);
+
+    GList *timers = g_hash_table_get_keys(app->timers);
+    for (GList *l = timers; l; l = l->next) {
+        AppTimer *t = (AppTimer*) l->data;
+        /* the source may be the one dispatching right now, in which case
+           it is freed only after we return: don't let it look back */
+        t->detached = TRUE;
+        g_hash_table_remove(app->timers, t);
+        g_source_remove(t->id);
+    }
+    g_list_free(timers);
+
+    app->update_timeout_id = 0;
+    app->populate_timeout_id = 0;
+    app->theme_check_id = 0;
+    app->wifi_resort_id = 0;
+}
+
 /* ---------- Utility implementations ---------- */
 
 static NMDeviceWifi* get_primary_wifi_device(NMClient *client) {
@@ -212,58 +572,73 @@ static NMDeviceWifi* get_primary_wifi_device(NMClient *client) {
     return NULL;
 }
 
-static gchar* ssid_from_bytes(GBytes *ssid_bytes) {
-    if (!ssid_bytes) return NULL;
-    gsize len = 0;
-    const guint8 *data = reinterpret_cast<const guint8*>(g_bytes_get_data(ssid_bytes, &len));
-    if (!data || len == 0) return NULL;
-    return g_strndup(reinterpret_cast<const char*>(data), len);
-}
-
-static gboolean ap_is_secured(NMAccessPoint *ap) {
-    if (!ap) return FALSE;
-    return (nm_access_point_get_flags(ap)     != NM_802_11_AP_FLAGS_NONE) ||
-           (nm_access_point_get_wpa_flags(ap) != NM_802_11_AP_SEC_NONE)   ||
-           (nm_access_point_get_rsn_flags(ap) != NM_802_11_AP_SEC_NONE);
-}
-
-static gboolean ssid_equal(const gchar *a, const gchar *b) {
-    if (!a || !b) return FALSE;
-    return g_strcmp0(a, b) == 0;
-}
-
-/* Search saved remote (system) connections for matching SSID
-   Returns a referenced NMRemoteConnection* (or NULL). Caller must g_object_unref() */
-static NMRemoteConnection* find_saved_connection_for_ssid(NMClient *client, const gchar *ssid) {
-    if (!client || !ssid) return NULL;
-
-    // iterate through nm_client_get_connections()
-    const GPtrArray *conns = nm_client_get_connections(client);
-    if (!conns) return NULL;
-
-    for (guint i = 0; i < conns->len; ++i) {
-        NMRemoteConnection *rc = reinterpret_cast<NMRemoteConnection*>(g_ptr_array_index(conns, i));
-        if (!rc) continue;
-        NMConnection *c = NM_CONNECTION(rc);
-        NMSettingWireless *s_wifi = nm_connection_get_setting_wireless(c);
-        if (!s_wifi) continue;
-        GBytes *bytes = nm_setting_wireless_get_ssid(s_wifi);
-        gchar *conn_ssid = ssid_from_bytes(bytes);
-        gboolean match = ssid_equal(conn_ssid, ssid);
-        g_free(conn_ssid);
-        if (match) {
-            // return a reference to the remote connection
-            return NM_REMOTE_CONNECTION(g_object_ref(rc));
+/* ---------- Wi-Fi UI building ---------- */
+
+/* Status line for a row: Connected / Saved / Secured (NULL for open networks) */
+static const gchar* ap_status_text(WelcomeApp *app, NMDeviceWifi *wifi_dev, NMAccessPoint *ap, const gchar *ssid, gboolean *accent, gboolean *in_progress) {
+    const Translations* tr = get_translations();
+    *accent = FALSE;
+
+    /* An attempt in flight (or one that just failed) outranks everything else */
+    const gchar *attempt = wifi_activation_status_text(app, ssid, in_progress);
+    if (attempt) return attempt;
+
+    NMAccessPoint *active_ap = wifi_dev ? nm_device_wifi_get_active_access_point(wifi_dev) : NULL;
+    if (active_ap) {
+        const char *p1 = nm_object_get_path(NM_OBJECT(active_ap));
+        const char *p2 = nm_object_get_path(NM_OBJECT(ap));
+        if (p1 && p2 && g_strcmp0(p1, p2) == 0) {
+            *accent = TRUE;
+            return tr->connected_status;
         }
     }
-    return NULL;
+
+    NMRemoteConnection *saved = find_saved_connection_for_ssid(app->nm_client, ssid);
+    if (saved) {
+        g_object_unref(saved);
+        return tr->saved_status;
+    }
+
+    return ap_is_secured(ap) ? tr->secured_status : NULL;
 }
 
-/* ---------- Wi-Fi UI building ---------- */
+static void refresh_ap_row_status(WelcomeApp *app, GtkWidget *row) {
+    GtkWidget *status = reinterpret_cast<GtkWidget*>(g_object_get_data(G_OBJECT(row), "status-label"));
+    GtkWidget *spinner = reinterpret_cast<GtkWidget*>(g_object_get_data(G_OBJECT(row), "spinner"));
+    NMAccessPoint *ap = reinterpret_cast<NMAccessPoint*>(g_object_get_data(G_OBJECT(row), "ap"));
+    const gchar *ssid = reinterpret_cast<const gchar*>(g_object_get_data(G_OBJECT(row), "ssid"));
+    if (!status || !spinner || !ap) return;
+
+    gboolean accent = FALSE, in_progress = FALSE;
+    const gchar *text = ap_status_text(app, get_primary_wifi_device(app->nm_client), ap, ssid, &accent, &in_progress);
+    gtk_label_set_text(GTK_LABEL(status), text ? text : "");
+    gtk_widget_set_visible(status, text != NULL);
+    gtk_spinner_set_spinning(GTK_SPINNER(spinner), in_progress);
+    gtk_widget_set_visible(spinner, in_progress);
+    if (accent) gtk_widget_add_css_class(status, "accent");
+    else        gtk_widget_remove_css_class(status, "accent");
+}
+
+static const char* ap_signal_icon_name(guint8 strength) {
+    return (strength > 75) ? "network-wireless-signal-excellent-symbolic" :
+           (strength > 50) ? "network-wireless-signal-good-symbolic" :
+           (strength > 25) ? "network-wireless-signal-ok-symbolic" :
+                             "network-wireless-signal-weak-symbolic";
+}
+
+static void refresh_ap_row_signal(GtkWidget *row) {
+    GtkWidget *icon = reinterpret_cast<GtkWidget*>(g_object_get_data(G_OBJECT(row), "signal-icon"));
+    NMAccessPoint *ap = reinterpret_cast<NMAccessPoint*>(g_object_get_data(G_OBJECT(row), "ap"));
+    if (!icon || !ap) return;
+    set_icon_image(icon, ap_signal_icon_name(nm_access_point_get_strength(ap)), 20);
+}
+
+/* GtkListBoxCreateWidgetFunc: one row per NMAccessPoint in the (filtered, sorted) model */
+static GtkWidget* create_ap_row(gpointer item, gpointer user_data) {
+    WelcomeApp *app = (WelcomeApp*) user_data;
+    NMAccessPoint *ap = NM_ACCESS_POINT(item);
+    NMDeviceWifi *wifi_dev = get_primary_wifi_device(app->nm_client);
 
-static void build_ap_row(WelcomeApp *app, NMDeviceWifi *wifi_dev, NMAccessPoint *ap) {
-    const Translations* tr = get_translations();
-    
     gchar *ssid = ssid_from_bytes(nm_access_point_get_ssid(ap));
     if (!ssid) ssid = g_strdup("<hidden>");
 
@@ -271,6 +646,7 @@ static void build_ap_row(WelcomeApp *app, NMDeviceWifi *wifi_dev, NMAccessPoint
     guint8 strength = nm_access_point_get_strength(ap);
 
     GtkWidget *row = gtk_list_box_row_new();
+    census_track(row);
     gtk_widget_set_size_request(row, -1, 60);
 
     GtkWidget *row_box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 15);
@@ -279,12 +655,7 @@ static void build_ap_row(WelcomeApp *app, NMDeviceWifi *wifi_dev, NMAccessPoint
     gtk_widget_set_margin_start(row_box, 20);
     gtk_widget_set_margin_end(row_box, 20);
 
-    const char *icon_name =
-        (strength > 75) ? "network-wireless-signal-excellent-symbolic" :
-        (strength > 50) ? "network-wireless-signal-good-symbolic" :
-        (strength > 25) ? "network-wireless-signal-ok-symbolic" :
-                          "network-wireless-signal-weak-symbolic";
-    GtkWidget *signal_icon = make_icon_image(icon_name, 20);
+    GtkWidget *signal_icon = make_icon_image(ap_signal_icon_name(strength), 20);
     gtk_box_append(GTK_BOX(row_box), signal_icon);
 
     GtkWidget *name_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 2);
@@ -293,40 +664,21 @@ static void build_ap_row(WelcomeApp *app, NMDeviceWifi *wifi_dev, NMAccessPoint
     gtk_widget_add_css_class(name_label, "heading");
     gtk_box_append(GTK_BOX(name_box), name_label);
 
-    /* Status: Connected / Saved / Secured */
-    NMAccessPoint *active_ap = nm_device_wifi_get_active_access_point(wifi_dev);
-    gboolean is_active = FALSE;
-    if (active_ap) {
-        const char *p1 = nm_object_get_path(NM_OBJECT(active_ap));
-        const char *p2 = nm_object_get_path(NM_OBJECT(ap));
-        if (p1 && p2 && g_strcmp0(p1, p2) == 0) is_active = TRUE;
-    }
-
-    NMRemoteConnection *saved = find_saved_connection_for_ssid(app->nm_client, ssid);
-
-    if (is_active) {
-        GtkWidget *status = gtk_label_new(tr->connected_status);
-        gtk_widget_add_css_class(status, "caption");
-        gtk_widget_add_css_class(status, "accent");
-        gtk_widget_set_halign(status, GTK_ALIGN_START);
-        gtk_box_append(GTK_BOX(name_box), status);
-    } else if (saved) {
-        GtkWidget *status = gtk_label_new(tr->saved_status);
-        gtk_widget_add_css_class(status, "caption");
-        gtk_widget_set_halign(status, GTK_ALIGN_START);
-        gtk_box_append(GTK_BOX(name_box), status);
-    } else if (secured) {
-        GtkWidget *status = gtk_label_new(tr->secured_status);
-        gtk_widget_add_css_class(status, "caption");
-        gtk_widget_set_halign(status, GTK_ALIGN_START);
-        gtk_box_append(GTK_BOX(name_box), status);
-    }
-
-    if (saved) g_object_unref(saved);
+    /* Status: Connected / Saved / Secured - kept on the row so it can be
+       refreshed in place when NM state changes without rebuilding the row */
+    GtkWidget *status = gtk_label_new(NULL);
+    gtk_widget_add_css_class(status, "caption");
+    gtk_widget_set_halign(status, GTK_ALIGN_START);
+    gtk_box_append(GTK_BOX(name_box), status);
 
     gtk_widget_set_hexpand(name_box, TRUE);
     gtk_box_append(GTK_BOX(row_box), name_box);
 
+    /* Activation progress for this SSID */
+    GtkWidget *spinner = gtk_spinner_new();
+    gtk_widget_set_visible(spinner, FALSE);
+    gtk_box_append(GTK_BOX(row_box), spinner);
+
     if (secured) {
         GtkWidget *lock_icon = make_icon_image("network-wireless-encrypted-symbolic", 16);
         gtk_box_append(GTK_BOX(row_box), lock_icon);
@@ -338,7 +690,9 @@ static void build_ap_row(WelcomeApp *app, NMDeviceWifi *wifi_dev, NMAccessPoint
     gtk_button_set_child(GTK_BUTTON(connect_btn), make_icon_image("go-next-symbolic", 16));
 
     /* attach data for handler; keep refs so AP stays valid while row exists */
-    g_object_set_data_full(G_OBJECT(connect_btn), "wifi-dev", g_object_ref(wifi_dev), (GDestroyNotify)g_object_unref);
+    if (wifi_dev) {
+        g_object_set_data_full(G_OBJECT(connect_btn), "wifi-dev", g_object_ref(wifi_dev), (GDestroyNotify)g_object_unref);
+    }
     g_object_set_data_full(G_OBJECT(connect_btn), "ap",       g_object_ref(ap),       (GDestroyNotify)g_object_unref);
     g_object_set_data_full(G_OBJECT(connect_btn), "ssid",     g_strdup(ssid),         g_free);
 
@@ -347,9 +701,171 @@ static void build_ap_row(WelcomeApp *app, NMDeviceWifi *wifi_dev, NMAccessPoint
     gtk_box_append(GTK_BOX(row_box), connect_btn);
 
     gtk_list_box_row_set_child(GTK_LIST_BOX_ROW(row), row_box);
-    gtk_list_box_append(GTK_LIST_BOX(app->wifi_list_box), row);
 
+    g_object_set_data(G_OBJECT(row), "status-label", status);
+    g_object_set_data(G_OBJECT(row), "spinner", spinner);
+    g_object_set_data(G_OBJECT(row), "signal-icon", signal_icon);
+    g_object_set_data_full(G_OBJECT(row), "ap",   g_object_ref(ap), (GDestroyNotify)g_object_unref);
+    g_object_set_data_full(G_OBJECT(row), "ssid", ssid,             g_free);
+    refresh_ap_row_status(app, row);
+
+    return row;
+}
+
+/* ---------- Wi-Fi list model ---------- */
+
+/* Case-folded SSID cached on the AP so filtering never re-decodes SSID bytes */
+static const gchar* ap_search_key(NMAccessPoint *ap) {
+    const gchar *key = reinterpret_cast<const gchar*>(g_object_get_data(G_OBJECT(ap), "welcome-search-key"));
+    if (key) return key;
+
+    gchar *ssid = ssid_from_bytes(nm_access_point_get_ssid(ap));
+    gchar *valid = g_utf8_make_valid(ssid ? ssid : "", -1);
+    gchar *folded = g_utf8_casefold(valid, -1);
+    g_free(valid);
     g_free(ssid);
+
+    g_object_set_data_full(G_OBJECT(ap), "welcome-search-key", folded, g_free);
+    return folded;
+}
+
+static gboolean wifi_filter_func(gpointer item, gpointer user_data) {
+    WelcomeApp *app = (WelcomeApp*) user_data;
+    if (!app->wifi_query || !*app->wifi_query) return TRUE;
+    return strstr(ap_search_key(NM_ACCESS_POINT(item)), app->wifi_query) != NULL;
+}
+
+/* Strongest networks first */
+static int wifi_sort_func(gconstpointer a, gconstpointer b, gpointer user_data) {
+    (void)user_data;
+    guint8 sa = nm_access_point_get_strength(NM_ACCESS_POINT((gpointer)a));
+    guint8 sb = nm_access_point_get_strength(NM_ACCESS_POINT((gpointer)b));
+    if (sa > sb) return GTK_ORDERING_SMALLER;
+    if (sa < sb) return GTK_ORDERING_LARGER;
+    return GTK_ORDERING_EQUAL;
+}
+
+static void on_wifi_search_changed(GtkSearchEntry *entry, WelcomeApp *app) {
+    gchar *valid = g_utf8_make_valid(gtk_editable_get_text(GTK_EDITABLE(entry)), -1);
+    gchar *query = g_utf8_casefold(valid, -1);
+    g_free(valid);
+
+    const gchar *old = app->wifi_query ? app->wifi_query : "";
+    if (g_strcmp0(query, old) == 0) {
+        g_free(query);
+        return;
+    }
+
+    /* Typing more characters can only hide rows, deleting can only reveal them:
+       tell the filter model so it re-checks just the affected half of the list */
+    GtkFilterChange change;
+    if (strstr(query, old))      change = GTK_FILTER_CHANGE_MORE_STRICT;
+    else if (strstr(old, query)) change = GTK_FILTER_CHANGE_LESS_STRICT;
+    else                         change = GTK_FILTER_CHANGE_DIFFERENT;
+
+    g_free(app->wifi_query);
+    app->wifi_query = query;
+    gtk_filter_changed(app->wifi_filter, change);
+}
+
+/* Strength changes arrive per AP as NM updates its scan results: the icon
+   follows at once, the order is re-sorted once for the whole batch */
+static gboolean wifi_resort_timeout(gpointer user_data) {
+    WelcomeApp *app = (WelcomeApp*) user_data;
+    app->wifi_resort_id = 0;
+    gtk_sorter_changed(app->wifi_sorter, GTK_SORTER_CHANGE_DIFFERENT);
+    return G_SOURCE_REMOVE;
+}
+
+static void on_ap_strength_changed(GObject *object, GParamSpec *pspec, gpointer user_data) {
+    (void)pspec;
+    WelcomeApp *app = (WelcomeApp*) user_data;
+    for (GtkWidget *child = gtk_widget_get_first_child(app->wifi_list_box); child; child = gtk_widget_get_next_sibling(child)) {
+        if (g_object_get_data(G_OBJECT(child), "ap") == object) refresh_ap_row_signal(child);
+    }
+    if (app->wifi_resort_id == 0) app->wifi_resort_id = app_timeout_add(app, 0, wifi_resort_timeout);
+}
+
+/* A hidden network revealing its name: the search key, the filter result
+   and the row's label and connect data all derive from the SSID, so put
+   the AP back in its place in the store and let the model stack filter,
+   sort and build its row again */
+static void on_ap_ssid_changed(GObject *object, GParamSpec *pspec, gpointer user_data) {
+    (void)pspec;
+    WelcomeApp *app = (WelcomeApp*) user_data;
+    g_object_set_data(object, "welcome-search-key", NULL);
+    guint position;
+    if (g_list_store_find(app->wifi_store, object, &position)) {
+        gpointer item = g_object_ref(object);
+        g_list_store_splice(app->wifi_store, position, 1, &item, 1);
+        g_object_unref(item);
+    }
+}
+
+static void wifi_store_append(WelcomeApp *app, NMAccessPoint *ap) {
+    census_track(ap);
+    g_signal_connect(ap, "notify::strength", G_CALLBACK(on_ap_strength_changed), app);
+    g_signal_connect(ap, "notify::ssid", G_CALLBACK(on_ap_ssid_changed), app);
+    g_list_store_append(app->wifi_store, ap);
+}
+
+/* NM owns the APs and may keep them after they leave the store */
+static void wifi_store_clear(WelcomeApp *app) {
+    if (!app->wifi_store) return;
+    GListModel *model = G_LIST_MODEL(app->wifi_store);
+    for (guint i = 0; i < g_list_model_get_n_items(model); ++i) {
+        gpointer ap = g_list_model_get_item(model, i);
+        g_signal_handlers_disconnect_by_data(ap, app);
+        g_object_unref(ap);
+    }
+    g_list_store_remove_all(app->wifi_store);
+}
+
+/* Bring the store in line with the current scan: vanished APs are removed,
+   surviving APs keep their rows, new APs are appended (and filtered/sorted
+   on insertion by the model stack) */
+static void sync_wifi_store(WelcomeApp *app, const GPtrArray *aps) {
+    GHashTable *incoming = g_hash_table_new(NULL, NULL);
+    for (guint i = 0; aps && i < aps->len; ++i) {
+        g_hash_table_add(incoming, g_ptr_array_index(aps, i));
+    }
+
+    GListModel *model = G_LIST_MODEL(app->wifi_store);
+    for (guint i = g_list_model_get_n_items(model); i > 0; --i) {
+        gpointer ap = g_list_model_get_item(model, i - 1);
+        if (!g_hash_table_remove(incoming, ap)) {
+            g_signal_handlers_disconnect_by_data(ap, app);
+            g_list_store_remove(app->wifi_store, i - 1);
+        }
+        g_object_unref(ap);
+    }
+
+    /* whatever is left in the set was not in the store yet */
+    for (guint i = 0; aps && i < aps->len; ++i) {
+        gpointer ap = g_ptr_array_index(aps, i);
+        if (g_hash_table_contains(incoming, ap)) {
+            wifi_store_append(app, NM_ACCESS_POINT(ap));
+        }
+    }
+    g_hash_table_unref(incoming);
+}
+
+/* The list box placeholder carries every non-list state (disabled, no device,
+   nothing found / nothing matching the search); it is only rebuilt when the
+   message actually changes */
+static void set_wifi_list_placeholder(WelcomeApp *app, const gchar *message, GtkWidget *content) {
+    app->wifi_list_message = message;
+    gtk_list_box_set_placeholder(GTK_LIST_BOX(app->wifi_list_box), content);
+}
+
+static void set_wifi_list_message(WelcomeApp *app, const gchar *message, const char *css_class) {
+    if (app->wifi_list_message == message) return;
+
+    GtkWidget *lbl = gtk_label_new(message);
+    if (css_class) gtk_widget_add_css_class(lbl, css_class);
+    gtk_widget_set_margin_top(lbl, 20);
+    gtk_widget_set_margin_bottom(lbl, 20);
+    set_wifi_list_placeholder(app, message, lbl);
 }
 
 /* ---------- Theme helpers ---------- */
@@ -365,7 +881,7 @@ static void detect_and_apply_theme(WelcomeApp *app) {
     gchar *current_theme = get_current_gtk_theme();
     
     if (current_theme) {
-        g_print("Current GTK theme: %s\n", current_theme);
+        log_debug(LOG_THEME, "Current GTK theme: %s", current_theme);
         
         gboolean should_be_dark = FALSE;
         if (g_strcmp0(current_theme, "ElysiaOS-HoC") == 0) {
@@ -374,13 +890,13 @@ static void detect_and_apply_theme(WelcomeApp *app) {
             should_be_dark = FALSE;
         }
         
-        g_print("Theme detection: current_theme=%s, is_dark_theme=%s, should_be_dark=%s\n", 
+        log_debug(LOG_THEME, "Theme detection: current_theme=%s, is_dark_theme=%s, should_be_dark=%s", 
                 current_theme, 
                 app->is_dark_theme ? "true" : "false",
                 should_be_dark ? "true" : "false");
         
         if (app->is_dark_theme != should_be_dark) {
-            g_print("Theme changed from %s to %s\n", 
+            log_info(LOG_THEME, "Theme changed from %s to %s", 
                     app->is_dark_theme ? "dark" : "light",
                     should_be_dark ? "dark" : "light");
             app->is_dark_theme = should_be_dark;
@@ -388,7 +904,7 @@ static void detect_and_apply_theme(WelcomeApp *app) {
         } else {
             // Even if theme hasn't changed, we still need to update logo images
             // in case they haven't been set yet
-            g_print("Calling update_logo_images (no theme change)\n");
+            log_debug(LOG_THEME, "Calling update_logo_images (no theme change)");
             update_logo_images(app);
         }
         
@@ -409,10 +925,13 @@ static gboolean theme_check_timeout(gpointer user_data) {
 static void enable_networking(WelcomeApp *app) {
     if (!app->nm_client) return;
     
-    g_print("Enabling networking...\n");
+    log_info(LOG_NETWORK, "Enabling networking...");
     GError *error = NULL;
-    if (!nm_client_networking_set_enabled(app->nm_client, TRUE, &error)) {
-        g_warning("Failed to enable networking: %s", error ? error->message : "Unknown error");
+    PerfSpan span = perf_span_begin("nm_client_networking_set_enabled");
+    gboolean ok = nm_client_networking_set_enabled(app->nm_client, TRUE, &error);
+    perf_span_end(&span);
+    if (!ok) {
+        log_warning(LOG_NETWORK, "Failed to enable networking: %s", error ? error->message : "Unknown error");
         if (error) g_error_free(error);
     }
 }
@@ -427,17 +946,11 @@ static void populate_wifi_list_now(WelcomeApp *app) {
     
     if (!app->nm_client || !app->wifi_list_box) return;
 
-    /* Clear existing list */
-    for (GtkWidget *child = gtk_widget_get_first_child(app->wifi_list_box); child; ) {
-        GtkWidget *next = gtk_widget_get_next_sibling(child);
-        gtk_list_box_remove(GTK_LIST_BOX(app->wifi_list_box), child);
-        child = next;
-    }
-
     /* Check if networking is enabled */
     if (!app->networking_enabled) {
-        GtkWidget *row = gtk_list_box_row_new();
-        
+        wifi_store_clear(app);
+        if (app->wifi_list_message == tr->networking_disabled_message) return;
+
         GtkWidget *row_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 10);
         gtk_widget_set_margin_top(row_box, 20);
         gtk_widget_set_margin_bottom(row_box, 20);
@@ -455,18 +968,14 @@ static void populate_wifi_list_now(WelcomeApp *app) {
         g_signal_connect(enable_btn, "clicked", G_CALLBACK(on_enable_networking_clicked), app);
         gtk_box_append(GTK_BOX(row_box), enable_btn);
         
-        gtk_list_box_row_set_child(GTK_LIST_BOX_ROW(row), row_box);
-        gtk_list_box_append(GTK_LIST_BOX(app->wifi_list_box), row);
+        set_wifi_list_placeholder(app, tr->networking_disabled_message, row_box);
         return;
     }
 
     /* Check if already connected via ethernet */
     if (app->has_ethernet_connection) {
-        GtkWidget *row = gtk_list_box_row_new();
-        GtkWidget *lbl = gtk_label_new(tr->ethernet_connected_message);
-        gtk_widget_add_css_class(lbl, "dim-label");
-        gtk_list_box_row_set_child(GTK_LIST_BOX_ROW(row), lbl);
-        gtk_list_box_append(GTK_LIST_BOX(app->wifi_list_box), row);
+        wifi_store_clear(app);
+        set_wifi_list_message(app, tr->ethernet_connected_message, "dim-label");
         return;
     }
 
@@ -475,60 +984,110 @@ static void populate_wifi_list_now(WelcomeApp *app) {
     gboolean sw_enabled = nm_client_wireless_get_enabled(app->nm_client);
     
     if (!hw_enabled) {
-        GtkWidget *row = gtk_list_box_row_new();
-        GtkWidget *lbl = gtk_label_new(tr->wifi_hardware_disabled_message);
-        gtk_widget_add_css_class(lbl, "dim-label");
-        gtk_list_box_row_set_child(GTK_LIST_BOX_ROW(row), lbl);
-        gtk_list_box_append(GTK_LIST_BOX(app->wifi_list_box), row);
+        wifi_store_clear(app);
+        set_wifi_list_message(app, tr->wifi_hardware_disabled_message, "dim-label");
         return;
     }
     
     if (!sw_enabled) {
-        GtkWidget *row = gtk_list_box_row_new();
-        GtkWidget *lbl = gtk_label_new(tr->wifi_disabled_message);
-        gtk_widget_add_css_class(lbl, "dim-label");
-        gtk_list_box_row_set_child(GTK_LIST_BOX_ROW(row), lbl);
-        gtk_list_box_append(GTK_LIST_BOX(app->wifi_list_box), row);
+        wifi_store_clear(app);
+        set_wifi_list_message(app, tr->wifi_disabled_message, "dim-label");
         return;
     }
 
     NMDeviceWifi *wifi = get_primary_wifi_device(app->nm_client);
     if (!wifi) {
-        GtkWidget *row = gtk_list_box_row_new();
-        GtkWidget *lbl = gtk_label_new(tr->no_wifi_device_message);
-        gtk_list_box_row_set_child(GTK_LIST_BOX_ROW(row), lbl);
-        gtk_list_box_append(GTK_LIST_BOX(app->wifi_list_box), row);
+        wifi_store_clear(app);
+        set_wifi_list_message(app, tr->no_wifi_device_message, NULL);
         return;
     }
 
+    /* Shown whenever the filtered model is empty: no scan results, or no match */
+    set_wifi_list_message(app, tr->no_networks_found_message, NULL);
+
+    PerfSpan span = perf_span_begin("populate_wifi_list_now");
     const GPtrArray *aps = nm_device_wifi_get_access_points(wifi);
-    if (!aps || aps->len == 0) {
-        GtkWidget *row = gtk_list_box_row_new();
-        GtkWidget *lbl = gtk_label_new(tr->no_networks_found_message);
-        gtk_list_box_row_set_child(GTK_LIST_BOX_ROW(row), lbl);
-        gtk_list_box_append(GTK_LIST_BOX(app->wifi_list_box), row);
-        return;
-    }
+    log_debug(LOG_WIFI, "Found %d Wi-Fi networks", aps ? aps->len : 0);
+    sync_wifi_store(app, aps);
+
+    /* Rows that survived the sync keep their widgets; only their status
+       (connected / saved) may be stale */
+    refresh_wifi_row_statuses(app);
+    perf_span_end_with(&span, "with %u APs", aps ? aps->len : 0);
+    census_checkpoint("wifi list rebuild");
+}
 
-    g_print("Found %d Wi-Fi networks\n", aps->len);
-    for (guint j = 0; j < aps->len; ++j) {
-        NMAccessPoint *ap = reinterpret_cast<NMAccessPoint*>(g_ptr_array_index(aps, j));
-        build_ap_row(app, wifi, ap);
-    }
+/* Nothing to redraw for: window backgrounded or network page not shown.
+   Remember that a refresh is owed; it is replayed once on resume/return. */
+static gboolean defer_network_refresh(WelcomeApp *app) {
+    if (!app->background_paused && app->network_page_visible) return FALSE;
+    app->pending_network_refresh = TRUE;
+    return TRUE;
 }
 
 static gboolean populate_wifi_list_timeout(gpointer user_data) {
     WelcomeApp *app = (WelcomeApp*) user_data;
+    app->populate_timeout_id = 0;
+    if (defer_network_refresh(app)) return G_SOURCE_REMOVE;
     populate_wifi_list_now(app);
     return G_SOURCE_REMOVE;
 }
 
+/* The device finished a scan. Getting online is worth doing even while
+   nobody is looking, so this is followed regardless of the visible page. */
+static void on_autoconnect_last_scan(GObject *gobj, GParamSpec *pspec, gpointer user_data) {
+    (void)gobj; (void)pspec;
+    autoconnect_best_known_network((WelcomeApp*) user_data);
+}
+
+static void autoconnect_stop_watching(WelcomeApp *app) {
+    if (!app->autoconnect_device) return;
+    g_signal_handlers_disconnect_by_func(app->autoconnect_device, (gpointer) on_autoconnect_last_scan, app);
+    g_clear_object(&app->autoconnect_device);
+}
+
+static void on_request_scan_done(GObject *source, GAsyncResult *result, gpointer user_data) {
+    GError *error = NULL;
+    if (nm_device_wifi_request_scan_finish(NM_DEVICE_WIFI(source), result, &error)) return;  /* last-scan follows */
+    if (!g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+        /* NM refuses a scan while one is running or just finished; the
+           results it already has are the ones to go by */
+        log_debug(LOG_WIFI, "Wi-Fi scan request refused: %s", error->message);
+        autoconnect_best_known_network((WelcomeApp*) user_data);
+    }
+    g_error_free(error);
+}
+
 static void scan_wifi_networks(WelcomeApp *app) {
     if (!app->nm_client) return;
     NMDeviceWifi *wifi = get_primary_wifi_device(app->nm_client);
     if (!wifi) return;
-    nm_device_wifi_request_scan_async(wifi, NULL, NULL, NULL);
-    g_timeout_add(2000, populate_wifi_list_timeout, app);
+    if (!app->autoconnect_checked && !app->autoconnect_device) {
+        app->autoconnect_device = NM_DEVICE_WIFI(g_object_ref(wifi));
+        g_signal_connect(wifi, "notify::last-scan", G_CALLBACK(on_autoconnect_last_scan), app);
+    }
+    nm_device_wifi_request_scan_async(wifi, app->cancellable, on_request_scan_done, app);
+    if (app->populate_timeout_id > 0) {
+        g_source_remove(app->populate_timeout_id);
+    }
+    app->populate_timeout_id = app_timeout_add(app, 2000, populate_wifi_list_timeout);
+}
+
+static gboolean scan_wifi_networks_timeout(gpointer user_data) {
+    scan_wifi_networks((WelcomeApp*) user_data);
+    return G_SOURCE_REMOVE;
+}
+
+static gboolean refresh_wifi_list_timeout(gpointer user_data) {
+    WelcomeApp *app = (WelcomeApp*) user_data;
+    if (defer_network_refresh(app)) return G_SOURCE_REMOVE;
+    populate_wifi_list_now(app);
+    return G_SOURCE_REMOVE;
+}
+
+static gboolean reflect_wifi_switch_state_timeout(gpointer user_data) {
+    reflect_wifi_switch_state((WelcomeApp*) user_data);
+    return G_SOURCE_REMOVE;
 }
 
 static void on_wifi_refresh_clicked(GtkButton *button, WelcomeApp *app) {
@@ -545,7 +1104,7 @@ static void reflect_wifi_switch_state(WelcomeApp *app) {
     gboolean hw_enabled = nm_client_wireless_hardware_get_enabled(app->nm_client);
     gboolean sw_enabled = nm_client_wireless_get_enabled(app->nm_client);
     
-    g_print("Wi-Fi Hardware enabled: %s, Software enabled: %s, Networking enabled: %s\n", 
+    log_debug(LOG_WIFI, "Wi-Fi Hardware enabled: %s, Software enabled: %s, Networking enabled: %s", 
             hw_enabled ? "YES" : "NO", sw_enabled ? "YES" : "NO", 
             app->networking_enabled ? "YES" : "NO");
     
@@ -570,25 +1129,26 @@ static void reflect_wifi_switch_state(WelcomeApp *app) {
    returns TRUE to stop default handler (we manually reflect the state) */
 static gboolean on_wifi_switch_state_set(GtkSwitch *sw, gboolean state, WelcomeApp *app) {
     if (!app->nm_client || app->updating_wifi_switch) return TRUE;
+    latency_mark("wifi-switch");
 
     gboolean hw_enabled = nm_client_wireless_hardware_get_enabled(app->nm_client);
     gboolean current_sw_enabled = nm_client_wireless_get_enabled(app->nm_client);
     
-    g_print("Switch toggle requested: %s (HW: %s, Current SW: %s, Networking: %s)\n", 
+    log_info(LOG_WIFI, "Switch toggle requested: %s (HW: %s, Current SW: %s, Networking: %s)", 
             state ? "ON" : "OFF", 
             hw_enabled ? "enabled" : "disabled",
             current_sw_enabled ? "enabled" : "disabled",
             app->networking_enabled ? "enabled" : "disabled");
     
     if (!hw_enabled) {
-        g_print("Cannot enable Wi-Fi: Hardware is disabled\n");
+        log_info(LOG_WIFI, "Cannot enable Wi-Fi: Hardware is disabled");
         /* Hardware is disabled, prevent any state change */
         reflect_wifi_switch_state(app);
         return TRUE;
     }
     
     if (!app->networking_enabled) {
-        g_print("Cannot enable Wi-Fi: Networking is disabled\n");
+        log_info(LOG_WIFI, "Cannot enable Wi-Fi: Networking is disabled");
         /* Networking is disabled, prevent any state change */
         reflect_wifi_switch_state(app);
         return TRUE;
@@ -596,7 +1156,7 @@ static gboolean on_wifi_switch_state_set(GtkSwitch *sw, gboolean state, WelcomeA
     
     /* Only proceed if the requested state is different from current state */
     if (state != current_sw_enabled) {
-        g_print("Setting Wi-Fi software state to: %s\n", state ? "enabled" : "disabled");
+        log_info(LOG_WIFI, "Setting Wi-Fi software state to: %s", state ? "enabled" : "disabled");
         
         /* Set software Wi-Fi state */
         #pragma GCC diagnostic push
@@ -607,14 +1167,14 @@ static gboolean on_wifi_switch_state_set(GtkSwitch *sw, gboolean state, WelcomeA
         /* Give some time for the change to take effect before updating UI */
         if (state) {
             /* Enabling Wi-Fi - scan after a delay */
-            g_timeout_add(1000, (GSourceFunc)scan_wifi_networks, app);
+            app_timeout_add(app, 1000, scan_wifi_networks_timeout);
         } else {
             /* Disabling Wi-Fi - update list immediately */
-            g_timeout_add(500, (GSourceFunc)populate_wifi_list_now, app);
+            app_timeout_add(app, 500, refresh_wifi_list_timeout);
         }
         
         /* Reflect the state change after a short delay */
-        g_timeout_add(300, (GSourceFunc)reflect_wifi_switch_state, app);
+        app_timeout_add(app, 300, reflect_wifi_switch_state_timeout);
     }
 
     return TRUE; /* Prevent default toggle handling */
@@ -628,22 +1188,12 @@ static gboolean check_networking_enabled(NMClient *client) {
     return nm_client_networking_get_enabled(client);
 }
 
-static gboolean check_ethernet_connection(NMClient *client) {
-    if (!client) return FALSE;
-    
-    const GPtrArray *devices = nm_client_get_devices(client);
-    if (!devices) return FALSE;
-    
-    for (guint i = 0; i < devices->len; ++i) {
-        NMDevice *dev = reinterpret_cast<NMDevice*>(g_ptr_array_index(devices, i));
-        if (NM_IS_DEVICE_ETHERNET(dev)) {
-            NMDeviceState state = nm_device_get_state(dev);
-            if (state == NM_DEVICE_STATE_ACTIVATED) {
-                return TRUE;
-            }
-        }
+/* Update UI with debounced timeout */
+static void schedule_network_ui_update(WelcomeApp *app) {
+    if (app->update_timeout_id > 0) {
+        g_source_remove(app->update_timeout_id);
     }
-    return FALSE;
+    app->update_timeout_id = app_timeout_add(app, 300, update_network_state_timeout);
 }
 
 static void update_network_state(WelcomeApp *app) {
@@ -659,15 +1209,11 @@ static void update_network_state(WelcomeApp *app) {
     app->has_ethernet_connection = new_ethernet_connection;
     
     if (state_changed) {
-        g_print("Network state changed: networking=%s, ethernet=%s\n", 
+        log_info(LOG_NETWORK, "Network state changed: networking=%s, ethernet=%s", 
                 new_networking_enabled ? "enabled" : "disabled",
                 new_ethernet_connection ? "connected" : "disconnected");
         
-        // Update UI with debounced timeout
-        if (app->update_timeout_id > 0) {
-            g_source_remove(app->update_timeout_id);
-        }
-        app->update_timeout_id = g_timeout_add(300, update_network_state_timeout, app);
+        schedule_network_ui_update(app);
     }
 }
 
@@ -675,6 +1221,8 @@ static gboolean update_network_state_timeout(gpointer user_data) {
     WelcomeApp *app = (WelcomeApp*) user_data;
     app->update_timeout_id = 0;
     
+    if (defer_network_refresh(app)) return G_SOURCE_REMOVE;
+    
     if (!app->updating_wifi_switch) {
         reflect_wifi_switch_state(app);
         populate_wifi_list_now(app);
@@ -697,41 +1245,475 @@ static void on_wifi_device_props_changed(GObject *gobj, GParamSpec *pspec, gpoin
     (void)gobj; (void)pspec;
     WelcomeApp *app = (WelcomeApp*) user_data;
     update_network_state(app);
+    /* AP list / active AP changed: rows need a sync even if the link state did not */
+    schedule_network_ui_update(app);
 }
 
-/* ---------- Connect flow ---------- */
+static void subscribe_devices(WelcomeApp *app) {
+    /* Connect to all device signals for state changes */
+    const GPtrArray *devices = nm_client_get_devices(app->nm_client);
+    for (guint i = 0; devices && i < devices->len; ++i) {
+        NMDevice *dev = reinterpret_cast<NMDevice*>(g_ptr_array_index(devices, i));
+        if (!dev) continue;
+        g_signal_connect(dev, "notify::state", 
+                         G_CALLBACK(on_wifi_device_props_changed), app);
+        g_ptr_array_add(app->subscribed_devices, g_object_ref(dev));
+    }
 
-/* Activate an already-saved connection (async) */
-static void activate_saved_connection(NMClient *client, NMRemoteConnection *conn, NMDevice *dev) {
-    if (!client || !conn || !dev) return;
-    nm_client_activate_connection_async(client, NM_CONNECTION(conn), dev, NULL, NULL, NULL, NULL);
+    /* Connect to Wi-Fi device signals */
+    NMDeviceWifi *wifi = get_primary_wifi_device(app->nm_client);
+    if (wifi) {
+        g_signal_connect(wifi, "notify::active-access-point", 
+                         G_CALLBACK(on_wifi_device_props_changed), app);
+        g_signal_connect(wifi, "notify::access-points", 
+                         G_CALLBACK(on_wifi_device_props_changed), app);
+    }
 }
 
-/* Build a WPA-PSK connection and add+activate it */
-static void add_and_activate_psk(NMClient *client, NMDeviceWifi *wifi_dev, NMAccessPoint *ap, const gchar *ssid, const gchar *psk) {
-    if (!client || !wifi_dev || !ap || !ssid || !psk) return;
+static void unsubscribe_devices(WelcomeApp *app) {
+    for (guint i = 0; i < app->subscribed_devices->len; ++i) {
+        g_signal_handlers_disconnect_by_data(g_ptr_array_index(app->subscribed_devices, i), app);
+    }
+    g_ptr_array_set_size(app->subscribed_devices, 0);
+}
 
-    NMConnection *c = nm_simple_connection_new();
+static void on_nm_device_added_removed(NMClient *client, NMDevice *device, gpointer user_data) {
+    (void)client; (void)device;
+    WelcomeApp *app = (WelcomeApp*) user_data;
+    unsubscribe_devices(app);
+    subscribe_devices(app);
+    update_network_state(app);
+    schedule_network_ui_update(app);
+}
 
-    /* Connection setting */
-    NMSettingConnection *s_con = NM_SETTING_CONNECTION(nm_setting_connection_new());
-    g_object_set(G_OBJECT(s_con),
-                 NM_SETTING_CONNECTION_ID, ssid,
-                 NM_SETTING_CONNECTION_TYPE, NM_SETTING_WIRELESS_SETTING_NAME,
-                 NM_SETTING_CONNECTION_AUTOCONNECT, TRUE,
-                 NULL);
-    nm_connection_add_setting(c, NM_SETTING(s_con));
+/* Saved profiles changed: "Saved" row status may be stale */
+static void on_nm_connection_added_removed(NMClient *client, GObject *connection, gpointer user_data) {
+    (void)client; (void)connection;
+    schedule_network_ui_update((WelcomeApp*) user_data);
+}
 
-    /* Wireless setting */
-    NMSettingWireless *s_wifi = NM_SETTING_WIRELESS(nm_setting_wireless_new());
-    GBytes *ssid_bytes = g_bytes_new(ssid, strlen(ssid));
-    g_object_set(G_OBJECT(s_wifi),
-                 NM_SETTING_WIRELESS_SSID, ssid_bytes,
+static void attach_network_subscriptions(WelcomeApp *app) {
+    if (!app->nm_client || app->nm_subscribed) return;
+    app->nm_subscribed = TRUE;
+
+    /* Connect to NetworkManager state change signals */
+    g_signal_connect(app->nm_client, "notify::wireless-enabled", 
+                     G_CALLBACK(on_nm_notify_wireless_enabled), app);
+    g_signal_connect(app->nm_client, "notify::wireless-hardware-enabled", 
+                     G_CALLBACK(on_nm_notify_wireless_enabled), app);
+    g_signal_connect(app->nm_client, "notify::networking-enabled", 
+                     G_CALLBACK(on_nm_client_changed), app);
+    g_signal_connect(app->nm_client, "device-added", 
+                     G_CALLBACK(on_nm_device_added_removed), app);
+    g_signal_connect(app->nm_client, "device-removed", 
+                     G_CALLBACK(on_nm_device_added_removed), app);
+    g_signal_connect(app->nm_client, "connection-added", 
+                     G_CALLBACK(on_nm_connection_added_removed), app);
+    g_signal_connect(app->nm_client, "connection-removed", 
+                     G_CALLBACK(on_nm_connection_added_removed), app);
+
+    subscribe_devices(app);
+}
+
+static void detach_network_subscriptions(WelcomeApp *app) {
+    if (!app->nm_client || !app->nm_subscribed) return;
+    app->nm_subscribed = FALSE;
+
+    unsubscribe_devices(app);
+    g_signal_handlers_disconnect_by_data(app->nm_client, app);
+
+    /* A debounced rebuild queued by the last event is pointless now */
+    if (app->update_timeout_id > 0) {
+        g_source_remove(app->update_timeout_id);
+        app->update_timeout_id = 0;
+        app->pending_network_refresh = TRUE;
+    }
+}
+
+/* Back on the network page: one pass brings state, switch and list up to date */
+static void reconcile_network_page(WelcomeApp *app) {
+    if (!app->nm_client) return;
+    app->pending_network_refresh = FALSE;
+    app->networking_enabled = check_networking_enabled(app->nm_client);
+    app->has_ethernet_connection = check_ethernet_connection(app->nm_client);
+    reflect_wifi_switch_state(app);
+    populate_wifi_list_now(app);
+}
+
+/* ---------- Connect flow ---------- */
+
+/* Give NM this long to go from "activate" to an IP address before we call
+   the attempt failed and tear it down */
+static const guint WIFI_ACTIVATION_TIMEOUT_MS = 45000;
+/* How long a row keeps saying "Connection failed" */
+static const guint WIFI_FAILED_STATUS_MS = 8000;
+
+typedef enum {
+    WIFI_ACTIVATION_STARTING,    /* D-Bus request in flight */
+    WIFI_ACTIVATION_CONNECTING,  /* NMActiveConnection exists, associating / DHCP */
+    WIFI_ACTIVATION_ACTIVATED,
+    WIFI_ACTIVATION_FAILED
+} WifiActivationState;
+
+/* One connection attempt, tracked from the request until NM reports the
+   NMActiveConnection activated (got IP) or deactivated.
+   Referenced by app->activations and by every in-flight async call; app is
+   cleared when the attempt is superseded or the window goes away, so late
+   callbacks only drop their reference. */
+typedef struct {
+    int                 ref_count;
+    WelcomeApp         *app;
+    gchar              *ssid;
+    NMDeviceWifi       *wifi_dev;
+    NMAccessPoint      *ap;
+    NMActiveConnection *active;
+    WifiActivationState state;
+    gint64              started_us;
+    guint               timeout_id;       /* activation timeout, then the failed status expiry */
+    gboolean            created_profile;  /* the profile was added by this attempt */
+} WifiActivation;
+
+static WifiActivation* wifi_activation_ref(WifiActivation *act) {
+    act->ref_count++;
+    return act;
+}
+
+static void wifi_activation_unref(WifiActivation *act) {
+    if (--act->ref_count > 0) return;
+    if (act->active) g_object_unref(act->active);
+    if (act->ap) g_object_unref(act->ap);
+    if (act->wifi_dev) g_object_unref(act->wifi_dev);
+    g_free(act->ssid);
+    g_free(act);
+}
+
+/* Stop following the attempt: no more signals, timers or UI updates */
+static void wifi_activation_detach(WifiActivation *act) {
+    act->app = NULL;
+    if (act->timeout_id > 0) {
+        g_source_remove(act->timeout_id);
+        act->timeout_id = 0;
+    }
+    if (act->active) {
+        g_signal_handlers_disconnect_by_data(act->active, act);
+    }
+}
+
+/* GDestroyNotify for app->activations values */
+static void wifi_activation_release(gpointer data) {
+    WifiActivation *act = (WifiActivation*) data;
+    wifi_activation_detach(act);
+    wifi_activation_unref(act);
+}
+
+static const gchar* wifi_activation_status_text(WelcomeApp *app, const gchar *ssid, gboolean *in_progress) {
+    const Translations* tr = get_translations();
+    *in_progress = FALSE;
+
+    WifiActivation *act = ssid ? reinterpret_cast<WifiActivation*>(g_hash_table_lookup(app->activations, ssid)) : NULL;
+    if (!act) return NULL;
+
+    switch (act->state) {
+        case WIFI_ACTIVATION_STARTING:
+        case WIFI_ACTIVATION_CONNECTING:
+            *in_progress = TRUE;
+            return tr->connecting_status;
+        case WIFI_ACTIVATION_FAILED:
+            return tr->connection_failed_status;
+        default:
+            return NULL;
+    }
+}
+
+static void refresh_wifi_row_statuses(WelcomeApp *app) {
+    if (!app->wifi_list_box) return;
+    for (GtkWidget *child = gtk_widget_get_first_child(app->wifi_list_box); child; child = gtk_widget_get_next_sibling(child)) {
+        refresh_ap_row_status(app, child);
+    }
+}
+
+/* The failed status has been shown long enough: forget the attempt */
+static gboolean on_wifi_failed_status_expired(gpointer user_data) {
+    WifiActivation *act = (WifiActivation*) user_data;
+    WelcomeApp *app = act->app;
+    act->timeout_id = 0;
+    if (!app) return G_SOURCE_REMOVE;
+    g_hash_table_remove(app->activations, act->ssid);  /* may free act */
+    refresh_wifi_row_statuses(app);
+    return G_SOURCE_REMOVE;
+}
+
+static void wifi_activation_finish(WifiActivation *act, WifiActivationState state) {
+    WelcomeApp *app = act->app;
+    gboolean was_autoconnect = ssid_equal(app->autoconnect_ssid, act->ssid);
+    act->state = state;
+
+    if (act->timeout_id > 0) {
+        g_source_remove(act->timeout_id);
+        act->timeout_id = 0;
+    }
+
+    gint64 elapsed_ms = (g_get_monotonic_time() - act->started_us) / 1000;
+    if (state == WIFI_ACTIVATION_ACTIVATED) {
+        g_array_append_val(app->activation_times_ms, elapsed_ms);
+        log_info(LOG_WIFI, "Wi-Fi \"%s\" online after %" G_GINT64_FORMAT " ms", act->ssid, elapsed_ms);
+        /* The row now reports "Connected" through the active AP */
+        g_hash_table_remove(app->activations, act->ssid);
+    } else {
+        app->activation_failures++;
+        log_info(LOG_WIFI, "Wi-Fi \"%s\" failed after %" G_GINT64_FORMAT " ms", act->ssid, elapsed_ms);
+        /* A new attempt on the SSID replaces the entry sooner */
+        act->timeout_id = app_timeout_add_data(app, WIFI_FAILED_STATUS_MS, on_wifi_failed_status_expired, act);
+    }
+
+    /* Startup auto-connect is over either way; the row carries the result */
+    if (was_autoconnect) {
+        gtk_widget_set_visible(app->network_status_label, FALSE);
+        g_clear_pointer(&app->autoconnect_ssid, g_free);
+    }
+
+    refresh_wifi_row_statuses(app);
+}
+
+static void on_active_connection_state_changed(NMActiveConnection *active, guint state, guint reason, gpointer user_data) {
+    (void)active;
+    WifiActivation *act = (WifiActivation*) user_data;
+    WelcomeApp *app = act->app;
+    if (!app) return;
+
+    switch (state) {
+        case NM_ACTIVE_CONNECTION_STATE_ACTIVATING:
+            if (act->state != WIFI_ACTIVATION_CONNECTING) {
+                act->state = WIFI_ACTIVATION_CONNECTING;
+                refresh_wifi_row_statuses(app);
+            }
+            break;
+        case NM_ACTIVE_CONNECTION_STATE_ACTIVATED:
+            wifi_activation_finish(act, WIFI_ACTIVATION_ACTIVATED);
+            break;
+        case NM_ACTIVE_CONNECTION_STATE_DEACTIVATED: {
+            gboolean bad_secrets = (reason == NM_ACTIVE_CONNECTION_STATE_REASON_NO_SECRETS);
+            log_info(LOG_WIFI, "Wi-Fi \"%s\" deactivated (reason %u)", act->ssid, reason);
+
+            /* A rejected password: a profile this attempt just added can
+               never connect, so drop it and ask again. A profile the user
+               already had keeps its other settings; the dialog only
+               replaces its secrets. */
+            NMRemoteConnection *saved = NULL;
+            if (bad_secrets) {
+                NMRemoteConnection *conn = nm_active_connection_get_connection(act->active);
+                if (conn && act->created_profile) nm_remote_connection_delete_async(conn, app->cancellable, NULL, NULL);
+                else if (conn) saved = NM_REMOTE_CONNECTION(g_object_ref(conn));
+            }
+
+            wifi_activation_ref(act);
+            wifi_activation_finish(act, WIFI_ACTIVATION_FAILED);
+            if (bad_secrets && act->ap && act->wifi_dev) {
+                show_password_dialog(app, act->wifi_dev, act->ap, act->ssid, saved);
+            }
+            if (saved) g_object_unref(saved);
+            wifi_activation_unref(act);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+static gboolean on_wifi_activation_timeout(gpointer user_data) {
+    WifiActivation *act = (WifiActivation*) user_data;
+    act->timeout_id = 0;
+    if (!act->app) return G_SOURCE_REMOVE;
+
+    log_info(LOG_WIFI, "Wi-Fi \"%s\" did not come online within %u ms", act->ssid, WIFI_ACTIVATION_TIMEOUT_MS);
+    if (act->active) {
+        g_signal_handlers_disconnect_by_data(act->active, act);
+        nm_client_deactivate_connection_async(act->app->nm_client, act->active, act->app->cancellable, NULL, NULL);
+    }
+    wifi_activation_finish(act, WIFI_ACTIVATION_FAILED);
+    return G_SOURCE_REMOVE;
+}
+
+/* Start tracking a new attempt for ssid, replacing any earlier one */
+static WifiActivation* wifi_activation_new(WelcomeApp *app, NMDeviceWifi *wifi_dev, NMAccessPoint *ap, const gchar *ssid) {
+    WifiActivation *act = g_new0(WifiActivation, 1);
+    act->ref_count = 1;
+    act->app = app;
+    act->ssid = g_strdup(ssid);
+    act->wifi_dev = wifi_dev ? NM_DEVICE_WIFI(g_object_ref(wifi_dev)) : NULL;
+    act->ap = ap ? NM_ACCESS_POINT(g_object_ref(ap)) : NULL;
+    act->state = WIFI_ACTIVATION_STARTING;
+    act->started_us = g_get_monotonic_time();
+    act->timeout_id = app_timeout_add_data(app, WIFI_ACTIVATION_TIMEOUT_MS, on_wifi_activation_timeout, act);
+
+    g_hash_table_replace(app->activations, act->ssid, act);
+    refresh_wifi_row_statuses(app);
+    return act;
+}
+
+/* Common tail of the activate / add-and-activate callbacks; consumes the
+   reference the async call held */
+static void wifi_activation_attach(WifiActivation *act, NMActiveConnection *active, GError *error) {
+    if (!act->app) {
+        if (active) g_object_unref(active);
+        g_clear_error(&error);
+        wifi_activation_unref(act);
+        return;
+    }
+
+    if (!active) {
+        log_warning(LOG_WIFI, "Failed to activate Wi-Fi \"%s\": %s", act->ssid, error ? error->message : "Unknown error");
+        g_clear_error(&error);
+        wifi_activation_finish(act, WIFI_ACTIVATION_FAILED);
+        wifi_activation_unref(act);
+        return;
+    }
+
+    act->active = active;
+    act->state = WIFI_ACTIVATION_CONNECTING;
+    g_signal_connect(active, "state-changed", G_CALLBACK(on_active_connection_state_changed), act);
+    refresh_wifi_row_statuses(act->app);
+
+    /* NM may already be past ACTIVATING by the time the reply arrives */
+    NMActiveConnectionState state = nm_active_connection_get_state(active);
+    if (state == NM_ACTIVE_CONNECTION_STATE_ACTIVATED || state == NM_ACTIVE_CONNECTION_STATE_DEACTIVATED) {
+        on_active_connection_state_changed(active, state, nm_active_connection_get_state_reason(active), act);
+    }
+    wifi_activation_unref(act);
+}
+
+static void on_activate_connection_done(GObject *source, GAsyncResult *result, gpointer user_data) {
+    GError *error = NULL;
+    NMActiveConnection *active = nm_client_activate_connection_finish(NM_CLIENT(source), result, &error);
+    wifi_activation_attach((WifiActivation*) user_data, active, error);
+}
+
+static void on_add_and_activate_done(GObject *source, GAsyncResult *result, gpointer user_data) {
+    GError *error = NULL;
+    NMActiveConnection *active = nm_client_add_and_activate_connection_finish(NM_CLIENT(source), result, &error);
+    wifi_activation_attach((WifiActivation*) user_data, active, error);
+}
+
+/* Activate an already-saved connection (async) */
+static void activate_saved_connection(WelcomeApp *app, NMRemoteConnection *conn, NMDeviceWifi *wifi_dev, NMAccessPoint *ap, const gchar *ssid) {
+    if (!app->nm_client || !conn || !wifi_dev) return;
+    WifiActivation *act = wifi_activation_new(app, wifi_dev, ap, ssid);
+    nm_client_activate_connection_async(app->nm_client, NM_CONNECTION(conn), NM_DEVICE(wifi_dev), NULL, app->cancellable,
+                                        on_activate_connection_done, wifi_activation_ref(act));
+}
+
+/* Startup policy: once the first scan is in, if nothing is up or coming up,
+   bring up the strongest in-range network that already has a saved profile
+   instead of waiting for the user to reach the network page.
+   Runs on every scan until the device reports access points; the decision
+   taken then, whichever it is, is final. */
+static void autoconnect_best_known_network(WelcomeApp *app) {
+    const Translations* tr = get_translations();
+
+    if (app->autoconnect_checked) return;
+    if (!app->nm_client || !app->networking_enabled) return;
+
+    NMDeviceWifi *wifi = get_primary_wifi_device(app->nm_client);
+    if (!wifi) return;
+
+    const GPtrArray *aps = nm_device_wifi_get_access_points(wifi);
+    if (!aps || aps->len == 0) return;  /* no results yet: wait for the next scan */
+
+    app->autoconnect_checked = TRUE;
+    autoconnect_stop_watching(app);
+
+    if (app->has_ethernet_connection) return;
+    if (nm_client_get_primary_connection(app->nm_client) || nm_client_get_activating_connection(app->nm_client)) return;
+    if (g_hash_table_size(app->activations) > 0) return;  /* the user got there first */
+
+    NMAccessPoint *best_ap = NULL;
+    NMRemoteConnection *best_conn = NULL;
+    gchar *best_ssid = NULL;
+
+    for (guint i = 0; aps && i < aps->len; ++i) {
+        NMAccessPoint *ap = reinterpret_cast<NMAccessPoint*>(g_ptr_array_index(aps, i));
+        if (best_ap && nm_access_point_get_strength(ap) <= nm_access_point_get_strength(best_ap)) continue;
+
+        gchar *ssid = ssid_from_bytes(nm_access_point_get_ssid(ap));
+        NMRemoteConnection *conn = ssid ? find_saved_connection_for_ssid(app->nm_client, ssid) : NULL;
+        if (!conn) {
+            g_free(ssid);
+            continue;
+        }
+
+        if (best_conn) g_object_unref(best_conn);
+        g_free(best_ssid);
+        best_ap = ap;
+        best_conn = conn;
+        best_ssid = ssid;
+    }
+
+    if (!best_conn) return;
+
+    log_info(LOG_WIFI, "Auto-connecting to saved network \"%s\" (strength %u)",
+            best_ssid, nm_access_point_get_strength(best_ap));
+
+    app->autoconnect_ssid = g_strdup(best_ssid);
+    if (app->network_status_label) {
+        gchar *status = g_strdup_printf(tr->autoconnect_status, best_ssid);
+        gtk_label_set_text(GTK_LABEL(app->network_status_label), status);
+        gtk_widget_set_visible(app->network_status_label, TRUE);
+        g_free(status);
+    }
+
+    activate_saved_connection(app, best_conn, wifi, best_ap, best_ssid);
+    g_object_unref(best_conn);
+    g_free(best_ssid);
+}
+
+/* Connection + wireless settings shared by open and WPA-PSK profiles */
+static NMConnection* new_wifi_connection(const gchar *ssid) {
+    NMConnection *c = nm_simple_connection_new();
+
+    /* Connection setting */
+    NMSettingConnection *s_con = NM_SETTING_CONNECTION(nm_setting_connection_new());
+    g_object_set(G_OBJECT(s_con),
+                 NM_SETTING_CONNECTION_ID, ssid,
+                 NM_SETTING_CONNECTION_TYPE, NM_SETTING_WIRELESS_SETTING_NAME,
+                 NM_SETTING_CONNECTION_AUTOCONNECT, TRUE,
+                 NULL);
+    nm_connection_add_setting(c, NM_SETTING(s_con));
+
+    /* Wireless setting */
+    NMSettingWireless *s_wifi = NM_SETTING_WIRELESS(nm_setting_wireless_new());
+    GBytes *ssid_bytes = g_bytes_new(ssid, strlen(ssid));
+    g_object_set(G_OBJECT(s_wifi),
+                 NM_SETTING_WIRELESS_SSID, ssid_bytes,
                  NM_SETTING_WIRELESS_MODE, "infrastructure",
                  NULL);
     g_bytes_unref(ssid_bytes);
     nm_connection_add_setting(c, NM_SETTING(s_wifi));
 
+    return c;
+}
+
+static void add_and_activate(WelcomeApp *app, NMConnection *c, NMDeviceWifi *wifi_dev, NMAccessPoint *ap, const gchar *ssid) {
+    WifiActivation *act = wifi_activation_new(app, wifi_dev, ap, ssid);
+    act->created_profile = TRUE;
+
+    /* AP object path string as specific_object */
+    const char *ap_path = nm_object_get_path(NM_OBJECT(ap));
+
+    nm_client_add_and_activate_connection_async(
+        app->nm_client,
+        c,
+        NM_DEVICE(wifi_dev),
+        ap_path,
+        app->cancellable, on_add_and_activate_done, wifi_activation_ref(act));
+    g_object_unref(c);
+}
+
+/* Build a WPA-PSK connection and add+activate it */
+static void add_and_activate_psk(WelcomeApp *app, NMDeviceWifi *wifi_dev, NMAccessPoint *ap, const gchar *ssid, const gchar *psk) {
+    if (!app->nm_client || !wifi_dev || !ap || !ssid || !psk) return;
+
+    NMConnection *c = new_wifi_connection(ssid);
+
     /* Security (WPA-PSK) */
     NMSettingWirelessSecurity *s_wsec = NM_SETTING_WIRELESS_SECURITY(nm_setting_wireless_security_new());
     g_object_set(G_OBJECT(s_wsec),
@@ -740,15 +1722,54 @@ static void add_and_activate_psk(NMClient *client, NMDeviceWifi *wifi_dev, NMAcc
                  NULL);
     nm_connection_add_setting(c, NM_SETTING(s_wsec));
 
-    /* AP object path string as specific_object */
-    const char *ap_path = nm_object_get_path(NM_OBJECT(ap));
+    add_and_activate(app, c, wifi_dev, ap, ssid);
+}
 
-    nm_client_add_and_activate_connection_async(
-        client,
-        c,
-        NM_DEVICE(wifi_dev),
-        ap_path,
-        NULL, NULL, NULL);
+static void on_update_psk_done(GObject *source, GAsyncResult *result, gpointer user_data) {
+    WifiActivation *act = (WifiActivation*) user_data;
+    GError *error = NULL;
+    GVariant *ret = nm_remote_connection_update2_finish(NM_REMOTE_CONNECTION(source), result, &error);
+    if (ret) g_variant_unref(ret);
+    if (!ret || !act->app) {
+        /* same failure path as a rejected activation */
+        wifi_activation_attach(act, NULL, error);
+        return;
+    }
+
+    nm_client_activate_connection_async(act->app->nm_client, NM_CONNECTION(source), NM_DEVICE(act->wifi_dev), NULL,
+                                        act->app->cancellable, on_activate_connection_done, act);
+}
+
+/* Replace the PSK of a saved profile (keeping its other settings) and
+   activate it again */
+static void update_and_activate_psk(WelcomeApp *app, NMRemoteConnection *saved, NMDeviceWifi *wifi_dev, NMAccessPoint *ap,
+                                    const gchar *ssid, const gchar *psk) {
+    if (!app->nm_client || !saved || !wifi_dev || !ssid || !psk) return;
+
+    NMConnection *c = nm_simple_connection_new_clone(NM_CONNECTION(saved));
+    NMSettingWirelessSecurity *s_wsec = nm_connection_get_setting_wireless_security(c);
+    if (!s_wsec) {
+        s_wsec = NM_SETTING_WIRELESS_SECURITY(nm_setting_wireless_security_new());
+        nm_connection_add_setting(c, NM_SETTING(s_wsec));
+    }
+    /* Store the new key with the profile, as add_and_activate_psk() does */
+    g_object_set(G_OBJECT(s_wsec),
+                 NM_SETTING_WIRELESS_SECURITY_KEY_MGMT, "wpa-psk",
+                 NM_SETTING_WIRELESS_SECURITY_PSK, psk,
+                 NM_SETTING_WIRELESS_SECURITY_PSK_FLAGS, NM_SETTING_SECRET_FLAG_NONE,
+                 NULL);
+
+    WifiActivation *act = wifi_activation_new(app, wifi_dev, ap, ssid);
+    nm_remote_connection_update2(saved, nm_connection_to_dbus(c, NM_CONNECTION_SERIALIZE_ALL),
+                                 NM_SETTINGS_UPDATE2_FLAG_TO_DISK, NULL, app->cancellable,
+                                 on_update_psk_done, wifi_activation_ref(act));
+    g_object_unref(c);
+}
+
+/* Open network: add & activate without security settings */
+static void add_and_activate_open(WelcomeApp *app, NMDeviceWifi *wifi_dev, NMAccessPoint *ap, const gchar *ssid) {
+    if (!app->nm_client || !wifi_dev || !ap || !ssid) return;
+    add_and_activate(app, new_wifi_connection(ssid), wifi_dev, ap, ssid);
 }
 
 /* Dialog data structure */
@@ -757,6 +1778,7 @@ typedef struct {
     NMDeviceWifi *wifi_dev;
     NMAccessPoint *ap;
     gchar *ssid;
+    NMRemoteConnection *saved;  /* profile whose password was rejected, or NULL */
     GtkWidget *entry;
     GtkWidget *dialog;
 } DialogData;
@@ -767,8 +1789,10 @@ static void on_connect_button_clicked(GtkButton *button, gpointer user_data) {
     DialogData *d = (DialogData*) user_data;
     if (d && d->ssid && d->entry && d->app && d->app->nm_client) {
         const gchar *psk = gtk_editable_get_text(GTK_EDITABLE(d->entry));
-        if (psk && *psk) {
-            add_and_activate_psk(d->app->nm_client, d->wifi_dev, d->ap, d->ssid, psk);
+        if (psk && *psk && d->saved) {
+            update_and_activate_psk(d->app, d->saved, d->wifi_dev, d->ap, d->ssid, psk);
+        } else if (psk && *psk) {
+            add_and_activate_psk(d->app, d->wifi_dev, d->ap, d->ssid, psk);
         }
     }
     
@@ -783,64 +1807,25 @@ static void on_password_dialog_destroy(GtkWidget *dialog, gpointer user_data) {
     if (d) {
         if (d->ap) g_object_unref(d->ap);
         if (d->wifi_dev) g_object_unref(d->wifi_dev);
+        if (d->saved) g_object_unref(d->saved);
         g_free(d->ssid);
         g_free(d);
     }
 }
 
-/* When user clicks connect on a row */
-static void on_wifi_connect_clicked(GtkButton *button, gpointer user_data) {
+/* Prompt for a PSK; used for new secured networks and after NM rejected a
+   password. saved, when given, is the existing profile to update. */
+static void show_password_dialog(WelcomeApp *app, NMDeviceWifi *wifi_dev, NMAccessPoint *ap, const gchar *ssid,
+                                 NMRemoteConnection *saved) {
     const Translations* tr = get_translations();
-    
-    WelcomeApp *app = (WelcomeApp*) user_data;
-    if (!app || !app->nm_client) return;
-
-    NMDeviceWifi *wifi_dev = reinterpret_cast<NMDeviceWifi*>(g_object_get_data(G_OBJECT(button), "wifi-dev"));
-    NMAccessPoint *ap      = reinterpret_cast<NMAccessPoint*>(g_object_get_data(G_OBJECT(button), "ap"));
-    const gchar   *ssid    = reinterpret_cast<const gchar*>(g_object_get_data(G_OBJECT(button), "ssid"));
-
-    if (!wifi_dev || !ap || !ssid) return;
-
-    /* If saved connection exists — activate it */
-    NMRemoteConnection *saved = find_saved_connection_for_ssid(app->nm_client, ssid);
-    if (saved) {
-        activate_saved_connection(app->nm_client, saved, NM_DEVICE(wifi_dev));
-        g_object_unref(saved);
-        return;
-    }
-
-    /* If open network — add & activate immediately (no password) */
-    if (!ap_is_secured(ap)) {
-        NMConnection *c = nm_simple_connection_new();
-
-        NMSettingConnection *s_con = NM_SETTING_CONNECTION(nm_setting_connection_new());
-        g_object_set(G_OBJECT(s_con),
-                     NM_SETTING_CONNECTION_ID, ssid,
-                     NM_SETTING_CONNECTION_TYPE, NM_SETTING_WIRELESS_SETTING_NAME,
-                     NM_SETTING_CONNECTION_AUTOCONNECT, TRUE,
-                     NULL);
-        nm_connection_add_setting(c, NM_SETTING(s_con));
-
-        NMSettingWireless *s_wifi = NM_SETTING_WIRELESS(nm_setting_wireless_new());
-        GBytes *ssid_bytes = g_bytes_new(ssid, strlen(ssid));
-        g_object_set(G_OBJECT(s_wifi),
-                     NM_SETTING_WIRELESS_SSID, ssid_bytes,
-                     NM_SETTING_WIRELESS_MODE, "infrastructure",
-                     NULL);
-        g_bytes_unref(ssid_bytes);
-        nm_connection_add_setting(c, NM_SETTING(s_wifi));
-
-        const char *ap_path = nm_object_get_path(NM_OBJECT(ap));
-        nm_client_add_and_activate_connection_async(app->nm_client, c, NM_DEVICE(wifi_dev), ap_path, NULL, NULL, NULL);
-        return;
-    }
 
-    /* Otherwise secured & not saved: prompt for PSK */
     GtkWidget *dialog = gtk_window_new();
+    census_track(dialog);
     gtk_window_set_title(GTK_WINDOW(dialog), tr->password_dialog_title);
-    gtk_window_set_transient_for(GTK_WINDOW(dialog), GTK_WINDOW(gtk_widget_get_root(GTK_WIDGET(button))));
+    gtk_window_set_transient_for(GTK_WINDOW(dialog), GTK_WINDOW(app->window));
     gtk_window_set_modal(GTK_WINDOW(dialog), TRUE);
     gtk_window_set_default_size(GTK_WINDOW(dialog), 400, 200);
+    if (app->is_dark_theme) gtk_widget_add_css_class(dialog, THEME_DARK_WINDOW_CLASS);
 
     GtkWidget *main_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 15);
     gtk_widget_set_margin_top(main_box, 20);
@@ -878,6 +1863,7 @@ static void on_wifi_connect_clicked(GtkButton *button, gpointer user_data) {
     d->wifi_dev = NM_DEVICE_WIFI(g_object_ref(wifi_dev));
     d->ap = NM_ACCESS_POINT(g_object_ref(ap));
     d->ssid = g_strdup(ssid);
+    d->saved = saved ? NM_REMOTE_CONNECTION(g_object_ref(saved)) : NULL;
     d->entry = entry;
     d->dialog = dialog;
 
@@ -889,12 +1875,47 @@ static void on_wifi_connect_clicked(GtkButton *button, gpointer user_data) {
     gtk_window_present(GTK_WINDOW(dialog));
 }
 
+/* Connect to ap the way a click on its row does. psk, when given, stands
+   in for the password prompt of a new secured network (--script). */
+static void wifi_connect_ap(WelcomeApp *app, NMDeviceWifi *wifi_dev, NMAccessPoint *ap, const gchar *ssid, const gchar *psk) {
+    /* If saved connection exists — activate it */
+    NMRemoteConnection *saved = find_saved_connection_for_ssid(app->nm_client, ssid);
+    if (saved) {
+        activate_saved_connection(app, saved, wifi_dev, ap, ssid);
+        g_object_unref(saved);
+        return;
+    }
+
+    /* If open network — add & activate immediately (no password) */
+    if (!ap_is_secured(ap)) {
+        add_and_activate_open(app, wifi_dev, ap, ssid);
+        return;
+    }
+
+    /* Otherwise secured & not saved: prompt for PSK */
+    if (psk) add_and_activate_psk(app, wifi_dev, ap, ssid, psk);
+    else     show_password_dialog(app, wifi_dev, ap, ssid, NULL);
+}
+
+/* When user clicks connect on a row */
+static void on_wifi_connect_clicked(GtkButton *button, gpointer user_data) {
+    WelcomeApp *app = (WelcomeApp*) user_data;
+    if (!app || !app->nm_client) return;
+
+    NMDeviceWifi *wifi_dev = reinterpret_cast<NMDeviceWifi*>(g_object_get_data(G_OBJECT(button), "wifi-dev"));
+    NMAccessPoint *ap      = reinterpret_cast<NMAccessPoint*>(g_object_get_data(G_OBJECT(button), "ap"));
+    const gchar   *ssid    = reinterpret_cast<const gchar*>(g_object_get_data(G_OBJECT(button), "ssid"));
+
+    if (!wifi_dev || !ap || !ssid) return;
+    wifi_connect_ap(app, wifi_dev, ap, ssid, NULL);
+}
+
 /* ---------- External link handler ---------- */
 static void open_url(const gchar *url) {
     gchar *command = g_strdup_printf("xdg-open '%s'", url);
     GError *error = NULL;
     if (!g_spawn_command_line_async(command, &error)) {
-        g_warning("Failed to open URL %s: %s", url, error->message);
+        log_warning(LOG_UI, "Failed to open URL %s: %s", url, error->message);
         g_error_free(error);
     }
     g_free(command);
@@ -946,10 +1967,22 @@ static GtkWidget* create_welcome_page(WelcomeApp *app) {
     return box;
 }
 
+static void on_theme_script_done(GObject *source, GAsyncResult *result, gpointer user_data) {
+    gchar *theme_script = (gchar*) user_data;
+    GError *error = NULL;
+    if (!g_subprocess_wait_check_finish(G_SUBPROCESS(source), result, &error) &&
+        !g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+        log_warning(LOG_THEME, "Theme script %s failed: %s", theme_script, error->message);
+    }
+    g_clear_error(&error);
+    g_free(theme_script);
+}
+
 static void on_theme_selected(GtkButton *button, WelcomeApp *app) {
     const gchar *theme_script = (const gchar*) g_object_get_data(G_OBJECT(button), "theme-script");
     const gchar *theme_name = (const gchar*) g_object_get_data(G_OBJECT(button), "theme-name");
     if (!theme_script) return;
+    latency_mark("theme-card");
 
     // Find the parent container and update selection styling
     GtkWidget *parent = gtk_widget_get_parent(GTK_WIDGET(button));
@@ -970,16 +2003,20 @@ static void on_theme_selected(GtkButton *button, WelcomeApp *app) {
     
     update_theme_css(app);
 
-    /* Execute the theme script */
-    gchar *command = g_strdup_printf("bash %s", theme_script);
+    /* Execute the theme script; the wait is scoped to the window, the
+       script itself is left to finish applying the theme */
+    const gchar *argv[] = { "bash", theme_script, NULL };
     GError *error = NULL;
-    if (!g_spawn_command_line_async(command, &error)) {
-        g_warning("Failed to execute theme script %s: %s", theme_script, error->message);
+    GSubprocess *proc = g_subprocess_newv(argv, G_SUBPROCESS_FLAGS_NONE, &error);
+    if (!proc) {
+        log_warning(LOG_THEME, "Failed to execute theme script %s: %s", theme_script, error->message);
         g_error_free(error);
+        return;
     }
-    g_free(command);
+    g_subprocess_wait_check_async(proc, app->cancellable, on_theme_script_done, g_strdup(theme_script));
+    g_object_unref(proc);
 
-    g_print("Applied theme script: %s\n", theme_script);
+    log_info(LOG_THEME, "Applied theme script: %s", theme_script);
 }
 
 static GtkWidget* create_theme_page(WelcomeApp *app) {
@@ -1078,6 +2115,20 @@ static GtkWidget* create_network_page(WelcomeApp *app) {
 
     gtk_box_append(GTK_BOX(main_box), wifi_header);
 
+    app->wifi_search_entry = gtk_search_entry_new();
+    gtk_search_entry_set_placeholder_text(GTK_SEARCH_ENTRY(app->wifi_search_entry), tr->search_networks_placeholder);
+    gtk_widget_set_size_request(app->wifi_search_entry, 600, -1);
+    gtk_widget_set_halign(app->wifi_search_entry, GTK_ALIGN_CENTER);
+    g_signal_connect(app->wifi_search_entry, "search-changed", G_CALLBACK(on_wifi_search_changed), app);
+    gtk_box_append(GTK_BOX(main_box), app->wifi_search_entry);
+
+    /* Startup auto-connect progress */
+    app->network_status_label = gtk_label_new(NULL);
+    gtk_widget_add_css_class(app->network_status_label, "dim-label");
+    gtk_widget_set_halign(app->network_status_label, GTK_ALIGN_CENTER);
+    gtk_widget_set_visible(app->network_status_label, FALSE);
+    gtk_box_append(GTK_BOX(main_box), app->network_status_label);
+
     GtkWidget *scrolled = gtk_scrolled_window_new();
     gtk_widget_set_size_request(scrolled, 600, 320);
     gtk_widget_set_halign(scrolled, GTK_ALIGN_CENTER);
@@ -1087,54 +2138,52 @@ static GtkWidget* create_network_page(WelcomeApp *app) {
 
     app->wifi_list_box = gtk_list_box_new();
     gtk_widget_add_css_class(app->wifi_list_box, "wifi-list");
+
+    /* Scan results live in a store of NMAccessPoints; the list box only
+       creates rows for what survives the search filter, strongest first */
+    app->wifi_store = g_list_store_new(NM_TYPE_ACCESS_POINT);
+    app->wifi_filter = GTK_FILTER(gtk_custom_filter_new(wifi_filter_func, app, NULL));
+    GtkFilterListModel *filtered = gtk_filter_list_model_new(G_LIST_MODEL(g_object_ref(app->wifi_store)),
+                                                             GTK_FILTER(g_object_ref(app->wifi_filter)));
+    app->wifi_sorter = GTK_SORTER(gtk_custom_sorter_new(wifi_sort_func, NULL, NULL));
+    GtkSortListModel *sorted = gtk_sort_list_model_new(G_LIST_MODEL(filtered),
+                                                       GTK_SORTER(g_object_ref(app->wifi_sorter)));
+    gtk_list_box_bind_model(GTK_LIST_BOX(app->wifi_list_box), G_LIST_MODEL(sorted), create_ap_row, app, NULL);
+    g_object_unref(sorted);
     gtk_scrolled_window_set_child(GTK_SCROLLED_WINDOW(scrolled), app->wifi_list_box);
     gtk_box_append(GTK_BOX(main_box), scrolled);
 
-    app->nm_client = nm_client_new(NULL, NULL);
+    g_signal_connect(app->wifi_switch, "state-set", G_CALLBACK(on_wifi_switch_state_set), app);
+
+    return main_box;
+}
+
+/* Hand the network page its NMClient (NULL if NetworkManager is not
+   reachable); until then the page shows no networks and its controls
+   do nothing */
+static void network_page_set_client(WelcomeApp *app, NMClient *client) {
+    const Translations* tr = get_translations();
+
+    app->nm_client = client;
     if (app->nm_client) {
-        g_print("NetworkManager client initialized successfully\n");
+        log_info(LOG_NETWORK, "NetworkManager client initialized successfully");
         
         /* Initialize network state */
         app->networking_enabled = check_networking_enabled(app->nm_client);
         app->has_ethernet_connection = check_ethernet_connection(app->nm_client);
         app->update_timeout_id = 0;
         
-        g_print("Initial network state: networking=%s, ethernet=%s\n", 
+        log_info(LOG_NETWORK, "Initial network state: networking=%s, ethernet=%s", 
                 app->networking_enabled ? "enabled" : "disabled",
                 app->has_ethernet_connection ? "connected" : "disconnected");
         
-        /* Connect to NetworkManager state change signals */
-        g_signal_connect(app->nm_client, "notify::wireless-enabled", 
-                        G_CALLBACK(on_nm_notify_wireless_enabled), app);
-        g_signal_connect(app->nm_client, "notify::wireless-hardware-enabled", 
-                        G_CALLBACK(on_nm_notify_wireless_enabled), app);
-        g_signal_connect(app->nm_client, "notify::networking-enabled", 
-                        G_CALLBACK(on_nm_client_changed), app);
-        g_signal_connect(app->nm_client, "changed", 
-                        G_CALLBACK(on_nm_client_changed), app);
-
-        /* Connect to all device signals for state changes */
-        const GPtrArray *devices = nm_client_get_devices(app->nm_client);
-        if (devices) {
-            for (guint i = 0; i < devices->len; ++i) {
-                NMDevice *dev = reinterpret_cast<NMDevice*>(g_ptr_array_index(devices, i));
-                if (dev) {
-                    g_signal_connect(dev, "notify::state", 
-                                   G_CALLBACK(on_wifi_device_props_changed), app);
-                }
-            }
-        }
-
-        /* Connect to Wi-Fi device signals */
+        /* NM signal handlers are attached by attach_network_subscriptions()
+           while this page is visible */
         NMDeviceWifi *wifi = get_primary_wifi_device(app->nm_client);
         if (wifi) {
-            g_print("Found Wi-Fi device: %s\n", nm_device_get_iface(NM_DEVICE(wifi)));
-            g_signal_connect(wifi, "notify::active-access-point", 
-                           G_CALLBACK(on_wifi_device_props_changed), app);
-            g_signal_connect(wifi, "notify::access-points", 
-                           G_CALLBACK(on_wifi_device_props_changed), app);
+            log_info(LOG_NETWORK, "Found Wi-Fi device: %s", nm_device_get_iface(NM_DEVICE(wifi)));
         } else {
-            g_print("No Wi-Fi device found\n");
+            log_info(LOG_NETWORK, "No Wi-Fi device found");
         }
 
         /* Initial state setup */
@@ -1143,7 +2192,7 @@ static GtkWidget* create_network_page(WelcomeApp *app) {
         
         /* Auto-enable networking if disabled */
         if (!app->networking_enabled) {
-            g_print("Networking is disabled, auto-enabling...\n");
+            log_info(LOG_NETWORK, "Networking is disabled, auto-enabling...");
             enable_networking(app);
         }
         
@@ -1154,67 +2203,242 @@ static GtkWidget* create_network_page(WelcomeApp *app) {
             scan_wifi_networks(app);
         }
     } else {
-        g_print("Failed to initialize NetworkManager client\n");
+        log_warning(LOG_NETWORK, "Failed to initialize NetworkManager client");
         
         /* Show error in the list */
-        GtkWidget *row = gtk_list_box_row_new();
-        GtkWidget *lbl = gtk_label_new(tr->nm_not_available_message);
-        gtk_widget_add_css_class(lbl, "error-label");
-        gtk_list_box_row_set_child(GTK_LIST_BOX_ROW(row), lbl);
-        gtk_list_box_append(GTK_LIST_BOX(app->wifi_list_box), row);
+        set_wifi_list_message(app, tr->nm_not_available_message, "error-label");
         
         /* Disable Wi-Fi controls */
         gtk_widget_set_sensitive(app->wifi_switch, FALSE);
         gtk_widget_set_sensitive(app->wifi_refresh_btn, FALSE);
+        gtk_widget_set_sensitive(app->wifi_search_entry, FALSE);
     }
 
-    g_signal_connect(app->wifi_switch, "state-set", G_CALLBACK(on_wifi_switch_state_set), app);
+    /* the user may already be looking at the page */
+    if (app->nm_client && app->network_page_visible) {
+        attach_network_subscriptions(app);
+        reconcile_network_page(app);
+    }
+}
 
-    return main_box;
+/* ---------- Page templates ---------- */
+
+/* The static pages are GtkBuilder templates under PAGE_TEMPLATE_PATH
+   (ui/*.ui, whitespace stripped at resource compile time). Templates carry
+   layout and style classes only; translated strings, resource images and
+   signal handlers are bound here after instantiation. */
+#define PAGE_TEMPLATE_PATH "/org/elysiaos/welcome/ui/"
+
+static GtkBuilder* load_page_template(const char *name) {
+    gchar *path = g_strconcat(PAGE_TEMPLATE_PATH, name, ".ui", NULL);
+    PerfSpan span = perf_span_begin("load_page_template");
+    GtkBuilder *builder = gtk_builder_new_from_resource(path);
+    perf_span_end_with(&span, "instantiating %s", path);
+    g_free(path);
+    return builder;
 }
 
-static GtkWidget* create_keybinds_page(void) {
-    const Translations* tr = get_translations();
-    
-    GtkWidget *main_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 20);
-    gtk_widget_set_margin_top(main_box, 20);
-    gtk_widget_set_margin_bottom(main_box, 20);
-    gtk_widget_set_margin_start(main_box, 40);
-    gtk_widget_set_margin_end(main_box, 40);
+static GtkWidget* template_widget(GtkBuilder *builder, const char *id) {
+    return GTK_WIDGET(gtk_builder_get_object(builder, id));
+}
 
-    GtkWidget *title_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 10);
-    gtk_widget_set_halign(title_box, GTK_ALIGN_CENTER);
+static void template_set_label(GtkBuilder *builder, const char *id, const char *text) {
+    gtk_label_set_label(GTK_LABEL(template_widget(builder, id)), text);
+}
 
-    GtkWidget *title = gtk_label_new(tr->keybinds_title);
-    gtk_widget_add_css_class(title, "display-2");
-    gtk_box_append(GTK_BOX(title_box), title);
+/* Take the "page" widget and drop the builder. The builder held the only
+   reference; the page is handed back floating, like gtk_box_new() would,
+   so callers can add it to a container as before. */
+static GtkWidget* template_take_page(GtkBuilder *builder) {
+    GtkWidget *page = GTK_WIDGET(g_object_ref(gtk_builder_get_object(builder, "page")));
+    g_object_unref(builder);
+    g_object_force_floating(G_OBJECT(page));
+    return page;
+}
 
-    GtkWidget *subtitle = gtk_label_new(tr->keybinds_subtitle);
-    gtk_widget_add_css_class(subtitle, "title-3");
-    gtk_widget_add_css_class(subtitle, "dim-label");
-    gtk_box_append(GTK_BOX(title_box), subtitle);
+/* What a Hyprland bind does, in the user's language where we recognise it.
+   exec commands are matched on the program they run: the basename of the
+   first word once launch wrappers (uwsm app --, setsid, sh -c, env VAR=..)
+   are skipped, with $variables and .sh/.py suffixes stripped so "$terminal"
+   and "wallpaper.sh" count too. An alternative of the form "program arg"
+   also needs arg as a whole word among the program's arguments. First match
+   wins, so the specific rules come first. Volume and brightness keys are
+   told apart by direction in exec_level_description. */
+typedef struct {
+    const char *programs;  // '|'-separated program names, optionally "program arg"
+    size_t      field;     // offsetof(Translations, keybind_*)
+} ExecDescription;
+
+#define KEYBIND_FIELD(name) offsetof(Translations, keybind_##name)
+
+static const ExecDescription exec_descriptions[] = {
+    { "wallpaper|wallpapers|wallpaper-menu|wallpaper-selector|waypaper", KEYBIND_FIELD(wallpapers_menu) },
+    { "hyprlock|swaylock|gtklock|loginctl lock-session",   KEYBIND_FIELD(lock_screen) },
+    { "wlogout|powermenu|power-menu",                      KEYBIND_FIELD(powermenu) },
+    { "swaync-client|dunstctl|makoctl|notifications",      KEYBIND_FIELD(notification) },
+    { "hyprctl switchxkblayout|keyboard-layout|kb-layout", KEYBIND_FIELD(change_language) },
+    { "overview|hyprexpo|workspaces|hyprctl hyprexpo:expo", KEYBIND_FIELD(workspaces_viewer) },
+    { "slurp|grim -g|grimblast area|hyprshot region|hyprshot window|screenshot region|screenshot area|flameshot gui",
+                                                           KEYBIND_FIELD(region_screenshot) },
+    { "grim|grimblast|hyprshot|screenshot|flameshot",      KEYBIND_FIELD(full_screenshot) },
+    { "fastfetch|neofetch|sysinfo|system-info|btop|htop",  KEYBIND_FIELD(system_info) },
+    { "rofi|wofi|fuzzel|anyrun|walker|tofi|launcher|menu", KEYBIND_FIELD(app_manager) },
+    { "kitty|alacritty|foot|wezterm|ghostty|terminal|xdg-terminal-exec", KEYBIND_FIELD(terminal) },
+    { "nautilus|thunar|dolphin|nemo|pcmanfm|pcmanfm-qt|yazi|filemanager|file-manager", KEYBIND_FIELD(launch_file_manager) },
+    { "firefox|chromium|google-chrome-stable|brave|zen-browser|zen|librewolf|browser", KEYBIND_FIELD(launch_browser) },
+    { "code|codium|nvim|vim|gedit|gnome-text-editor|kate|zed|zeditor|editor", KEYBIND_FIELD(launch_editor) },
+};
+
+static const char* translation_field(const Translations *tr, size_t field) {
+    return *(const char* const*) ((const char*) tr + field);
+}
 
-    gtk_box_append(GTK_BOX(main_box), title_box);
+static const char *const exec_wrappers[] = { "uwsm", "app", "--", "setsid", "nohup", "env", "exec", "sh", "bash", "-c" };
 
-    GtkWidget *scrolled = gtk_scrolled_window_new();
-    gtk_widget_set_size_request(scrolled, 600, 350);
-    gtk_widget_set_halign(scrolled, GTK_ALIGN_CENTER);
-    gtk_widget_set_vexpand(scrolled, TRUE);
-    gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(scrolled),
-                                   GTK_POLICY_NEVER, GTK_POLICY_AUTOMATIC);
-    gtk_widget_add_css_class(scrolled, "scrolled-window");
-
-    GtkWidget *keybinds_grid = gtk_grid_new();
-    gtk_grid_set_row_spacing(GTK_GRID(keybinds_grid), 4);
-    gtk_grid_set_column_spacing(GTK_GRID(keybinds_grid), 12);
-    gtk_widget_set_halign(keybinds_grid, GTK_ALIGN_CENTER);
-    gtk_widget_add_css_class(keybinds_grid, "keybinds-grid");
-
-    // Keybind data with translated descriptions
-    const struct {
-        const char *shortcut;
-        const char *description_key; // Key to look up translation
-    } keybinds[] = {
+static gboolean is_exec_wrapper(const char *word) {
+    for (guint i = 0; i < G_N_ELEMENTS(exec_wrappers); i++) {
+        if (strcmp(word, exec_wrappers[i]) == 0) return TRUE;
+    }
+    return FALSE;
+}
+
+/* Splits a lower-cased exec command into its words with shell quotes
+   trimmed, and returns the index of the program word, or -1 */
+static gint exec_command_words(const char *command, gchar ***words_out) {
+    gchar **words = g_strsplit_set(command, " \t", -1);
+    gint program = -1;
+    gboolean after_wrapper = FALSE;
+    for (gint i = 0; words[i]; i++) {
+        g_strstrip(g_strdelimit(words[i], "\"'", ' '));
+        if (program >= 0 || !words[i][0]) continue;
+        if (is_exec_wrapper(words[i]) || (after_wrapper && words[i][0] == '-') || strchr(words[i], '=')) {
+            after_wrapper = TRUE;
+            continue;
+        }
+        program = i;
+    }
+    *words_out = words;
+    return program;
+}
+
+/* "~/.config/hypr/scripts/wallpaper.sh" -> "wallpaper", "$terminal" -> "terminal" */
+static gchar* exec_program_name(const char *word) {
+    gchar *name = g_path_get_basename(word);
+    if (name[0] == '$') memmove(name, name + 1, strlen(name));
+    if (g_str_has_suffix(name, ".sh") || g_str_has_suffix(name, ".py")) name[strlen(name) - 3] = '\0';
+    return name;
+}
+
+static gboolean command_matches(const char *program, gchar **arguments, const char *programs) {
+    gchar **alternatives = g_strsplit(programs, "|", -1);
+    gboolean found = FALSE;
+    for (gchar **alternative = alternatives; *alternative && !found; alternative++) {
+        const char *space = strchr(*alternative, ' ');
+        if (!space) {
+            found = strcmp(program, *alternative) == 0;
+            continue;
+        }
+        if (strncmp(program, *alternative, space - *alternative) != 0 || program[space - *alternative]) continue;
+        for (gchar **argument = arguments; *argument && !found; argument++) found = strcmp(*argument, space + 1) == 0;
+    }
+    g_strfreev(alternatives);
+    return found;
+}
+
+static gboolean is_workspace_digit(const HyprBind *bind) {
+    return strlen(bind->key) == 1 && g_ascii_isdigit(bind->key[0]) &&
+           bind->params[0] && strspn(bind->params, "0123456789") == strlen(bind->params);
+}
+
+/* Mute, volume and brightness commands: wpctl, pactl, pamixer, amixer,
+   brightnessctl, light */
+static const char* exec_level_description(const Translations *tr, const char *command) {
+    gboolean mute = strstr(command, "mute") != NULL;
+    gboolean down = strstr(command, "%-") || strstr(command, " -d ") || strstr(command, " -u ") ||
+                    strstr(command, "down") || strstr(command, "lower") || strstr(command, "decrease");
+    if (mute && (strstr(command, "source") || strstr(command, "mic"))) return tr->keybind_mute_microphone;
+    if (mute) return tr->keybind_mute_volume;
+    if (strstr(command, "brightness") || g_str_has_prefix(command, "light ")) {
+        return down ? tr->keybind_lower_brightness : tr->keybind_higher_brightness;
+    }
+    if (strstr(command, "volume") || strstr(command, "wpctl") || strstr(command, "pactl") ||
+        strstr(command, "pamixer") || strstr(command, "amixer")) {
+        return down ? tr->keybind_lower_volume : tr->keybind_higher_volume;
+    }
+    return NULL;
+}
+
+/* Returns a newly allocated description */
+static gchar* describe_hypr_bind(const Translations *tr, const HyprBind *bind) {
+    if (bind->description[0]) return g_strdup(bind->description);
+
+    const char *dispatcher = bind->dispatcher;
+    if (strcmp(dispatcher, "killactive") == 0) return g_strdup(tr->keybind_close_window);
+    if (strcmp(dispatcher, "togglefloating") == 0) return g_strdup(tr->keybind_toggle_float);
+    if (strcmp(dispatcher, "exit") == 0) return g_strdup(tr->keybind_exit_hyprland);
+    if (strcmp(dispatcher, "hyprexpo:expo") == 0) return g_strdup(tr->keybind_workspaces_viewer);
+    if (strcmp(dispatcher, "workspace") == 0) {
+        if (is_workspace_digit(bind)) return g_strdup(tr->keybind_switch_workspaces);
+        if (g_str_has_prefix(bind->params, "e") || g_str_has_prefix(bind->params, "m") ||
+            g_str_has_prefix(bind->params, "r") || strcmp(bind->params, "previous") == 0) {
+            return g_strdup(tr->keybind_workspace_switcher);
+        }
+    }
+    if (strcmp(dispatcher, "exec") == 0 || strcmp(dispatcher, "execr") == 0) {
+        gchar *command = g_ascii_strdown(bind->params, -1);
+        const char *text = exec_level_description(tr, command);
+        gchar **words = NULL;
+        gint program_word = exec_command_words(command, &words);
+        if (program_word >= 0 && !text) {
+            gchar *program = exec_program_name(words[program_word]);
+            for (guint i = 0; i < G_N_ELEMENTS(exec_descriptions) && !text; i++) {
+                if (command_matches(program, words + program_word + 1, exec_descriptions[i].programs)) {
+                    text = translation_field(tr, exec_descriptions[i].field);
+                }
+            }
+            g_free(program);
+        }
+        g_strfreev(words);
+        g_free(command);
+        if (text) return g_strdup(text);
+    }
+    return bind->params[0] ? g_strdup_printf("%s %s", dispatcher, bind->params) : g_strdup(dispatcher);
+}
+
+/* Rows for the user's Hyprland binds; the row strings are kept alive in
+   owned. "workspace, 1" .. "workspace, 0" on digit keys fold into one
+   "MODS + [0-9]" row per modifier set and dispatcher. */
+static void collect_hypr_keybinds(const Translations *tr, GArray *binds, GArray *rows, GPtrArray *owned) {
+    GHashTable *folded = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    for (guint i = 0; i < binds->len; i++) {
+        const HyprBind *bind = &g_array_index(binds, HyprBind, i);
+        const char *key = bind->key;
+        if (is_workspace_digit(bind)) {
+            if (!g_hash_table_add(folded, g_strdup_printf("%s|%s", bind->mods, bind->dispatcher))) continue;
+            key = "[0-9]";
+        }
+        KeybindEntry row = {
+            bind->mods[0] ? g_strdup_printf("%s + %s", bind->mods, key) : g_strdup(key),
+            describe_hypr_bind(tr, bind),
+        };
+        g_ptr_array_add(owned, (gpointer) row.shortcut);
+        g_ptr_array_add(owned, (gpointer) row.description);
+        g_array_append_val(rows, row);
+    }
+    g_hash_table_unref(folded);
+}
+
+static GtkWidget* create_keybinds_page(WelcomeApp *app) {
+    const Translations* tr = get_translations();
+    g_type_ensure(ELYSIA_TYPE_KEYBINDS_VIEW);
+    GtkBuilder *builder = load_page_template("keybinds-page");
+    template_set_label(builder, "title", tr->keybinds_title);
+    template_set_label(builder, "subtitle", tr->keybinds_subtitle);
+    app->keybinds_view = template_widget(builder, "keybinds");
+    ElysiaKeybindsView *view = ELYSIA_KEYBINDS_VIEW(app->keybinds_view);
+
+    // The ElysiaOS defaults, shown when there is no Hyprland config or it has no binds
+    const KeybindEntry keybinds[] = {
         {"SUPER + Q", tr->keybind_close_window},
         {"SUPER + SPACE", tr->keybind_app_manager},
         {"SUPER + T", tr->keybind_terminal},
@@ -1240,228 +2464,111 @@ static GtkWidget* create_keybinds_page(void) {
         {"Fn + F2", tr->keybind_lower_volume},
         {"Fn + F3", tr->keybind_higher_volume},
         {"Fn + F4", tr->keybind_mute_microphone},
-        {NULL, NULL}
     };
 
-    // Add keybinds to grid
-    for (int i = 0; keybinds[i].shortcut != NULL; i++) {
-        GtkWidget *shortcut_label = gtk_label_new(keybinds[i].shortcut);
-        gtk_widget_add_css_class(shortcut_label, "keybind-shortcut");
-        gtk_widget_set_halign(shortcut_label, GTK_ALIGN_END);
-        
-        GtkWidget *description_label = gtk_label_new(keybinds[i].description_key);
-        gtk_widget_add_css_class(description_label, "keybind-description");
-        gtk_widget_set_halign(description_label, GTK_ALIGN_START);
-        
-        gtk_grid_attach(GTK_GRID(keybinds_grid), shortcut_label, 0, i, 1, 1);
-        gtk_grid_attach(GTK_GRID(keybinds_grid), description_label, 1, i, 1, 1);
+    PerfSpan span = perf_span_begin("hypr_keybinds_load");
+    GArray *rows = g_array_new(FALSE, FALSE, sizeof(KeybindEntry));
+    GPtrArray *owned = g_ptr_array_new_with_free_func(g_free);
+    GArray *hypr_binds = hypr_keybinds_load();
+    if (hypr_binds) {
+        collect_hypr_keybinds(tr, hypr_binds, rows, owned);
+        g_array_unref(hypr_binds);
     }
+    perf_span_end_with(&span, "%u rows from config", rows->len);
 
-    gtk_scrolled_window_set_child(GTK_SCROLLED_WINDOW(scrolled), keybinds_grid);
-    gtk_box_append(GTK_BOX(main_box), scrolled);
+    if (rows->len > 0) {
+        elysia_keybinds_view_set_keybinds(view, (const KeybindEntry*) rows->data, rows->len);
+    } else {
+        elysia_keybinds_view_set_keybinds(view, keybinds, G_N_ELEMENTS(keybinds));
+    }
+    g_array_unref(rows);
+    g_ptr_array_unref(owned);
+    elysia_keybinds_view_set_dark(view, app->is_dark_theme);
 
-    return main_box;
+    return template_take_page(builder);
 }
 
-static GtkWidget* create_updater_page(void) {
-    const Translations* tr = get_translations();
-    
-    GtkWidget *main_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 20);
-    gtk_widget_set_margin_top(main_box, 20);
-    gtk_widget_set_margin_bottom(main_box, 20);
-    gtk_widget_set_margin_start(main_box, 40);
-    gtk_widget_set_margin_end(main_box, 40);
-
-    GtkWidget *title_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 10);
-    gtk_widget_set_halign(title_box, GTK_ALIGN_CENTER);
+/* Updater, settings and store share one layout */
+static GtkWidget* create_feature_page(const char *title, const char *description, const char *image_path) {
+    GtkBuilder *builder = load_page_template("feature-page");
+    template_set_label(builder, "title", title);
+    template_set_label(builder, "description", description);
 
-    GtkWidget *title = gtk_label_new(tr->updater_title);
-    gtk_widget_add_css_class(title, "display-2");
-    gtk_box_append(GTK_BOX(title_box), title);
-
-    gtk_box_append(GTK_BOX(main_box), title_box);
-
-    // Add updater image
-    GtkWidget *image = gtk_picture_new_for_resource("/org/elysiaos/welcome/updater.png");
+    GtkWidget *image = make_resource_picture(image_path);
     gtk_widget_set_size_request(image, 300, 200);
     gtk_widget_set_halign(image, GTK_ALIGN_CENTER);
-    gtk_box_append(GTK_BOX(main_box), image);
+    gtk_box_insert_child_after(GTK_BOX(template_widget(builder, "page")), image, template_widget(builder, "title_box"));
 
-    // Add description text
-    GtkWidget *description = gtk_label_new(tr->updater_subtitle);
-    gtk_widget_add_css_class(description, "title-3");
-    gtk_widget_add_css_class(description, "dim-label");
-    gtk_widget_set_halign(description, GTK_ALIGN_CENTER);
-    gtk_box_append(GTK_BOX(main_box), description);
+    return template_take_page(builder);
+}
 
-    return main_box;
+static GtkWidget* create_updater_page(void) {
+    const Translations* tr = get_translations();
+    return create_feature_page(tr->updater_title, tr->updater_subtitle, "/org/elysiaos/welcome/updater.png");
 }
 
 static GtkWidget* create_settings_page(void) {
     const Translations* tr = get_translations();
-    
-    GtkWidget *main_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 20);
-    gtk_widget_set_margin_top(main_box, 20);
-    gtk_widget_set_margin_bottom(main_box, 20);
-    gtk_widget_set_margin_start(main_box, 40);
-    gtk_widget_set_margin_end(main_box, 40);
-
-    GtkWidget *title_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 10);
-    gtk_widget_set_halign(title_box, GTK_ALIGN_CENTER);
-
-    GtkWidget *title = gtk_label_new(tr->settings_title);
-    gtk_widget_add_css_class(title, "display-2");
-    gtk_box_append(GTK_BOX(title_box), title);
-
-    gtk_box_append(GTK_BOX(main_box), title_box);
-
-    // Add settings image
-    GtkWidget *image = gtk_picture_new_for_resource("/org/elysiaos/welcome/settings.png");
-    gtk_widget_set_size_request(image, 300, 200);
-    gtk_widget_set_halign(image, GTK_ALIGN_CENTER);
-    gtk_box_append(GTK_BOX(main_box), image);
-
-    // Add description text
-    GtkWidget *description = gtk_label_new(tr->settings_subtitle);
-    gtk_widget_add_css_class(description, "title-3");
-    gtk_widget_add_css_class(description, "dim-label");
-    gtk_widget_set_halign(description, GTK_ALIGN_CENTER);
-    gtk_box_append(GTK_BOX(main_box), description);
-
-    return main_box;
+    return create_feature_page(tr->settings_title, tr->settings_subtitle, "/org/elysiaos/welcome/settings.png");
 }
 
 static GtkWidget* create_store_page(void) {
     const Translations* tr = get_translations();
-    
-    GtkWidget *main_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 20);
-    gtk_widget_set_margin_top(main_box, 20);
-    gtk_widget_set_margin_bottom(main_box, 20);
-    gtk_widget_set_margin_start(main_box, 40);
-    gtk_widget_set_margin_end(main_box, 40);
-
-    GtkWidget *title_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 10);
-    gtk_widget_set_halign(title_box, GTK_ALIGN_CENTER);
-
-    GtkWidget *title = gtk_label_new(tr->store_title);
-    gtk_widget_add_css_class(title, "display-2");
-    gtk_box_append(GTK_BOX(title_box), title);
-
-    gtk_box_append(GTK_BOX(main_box), title_box);
-
-    // Add store image
-    GtkWidget *image = gtk_picture_new_for_resource("/org/elysiaos/welcome/store.png");
-    gtk_widget_set_size_request(image, 300, 200);
-    gtk_widget_set_halign(image, GTK_ALIGN_CENTER);
-    gtk_box_append(GTK_BOX(main_box), image);
-
-    // Add description text
-    GtkWidget *description = gtk_label_new(tr->store_subtitle);
-    gtk_widget_add_css_class(description, "title-3");
-    gtk_widget_add_css_class(description, "dim-label");
-    gtk_widget_set_halign(description, GTK_ALIGN_CENTER);
-    gtk_box_append(GTK_BOX(main_box), description);
-
-    return main_box;
+    return create_feature_page(tr->store_title, tr->store_subtitle, "/org/elysiaos/welcome/store.png");
 }
 
 static GtkWidget* create_complete_page(WelcomeApp *app) {
     const Translations* tr = get_translations();
-    
-    GtkWidget *main_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 40);
-    gtk_widget_set_halign(main_box, GTK_ALIGN_CENTER);
-    gtk_widget_set_valign(main_box, GTK_ALIGN_CENTER);
-    gtk_widget_set_hexpand(main_box, TRUE);
-    gtk_widget_set_vexpand(main_box, TRUE);
-
-    /* Top section with logo and text */
-    GtkWidget *top_section = gtk_box_new(GTK_ORIENTATION_VERTICAL, 40);
-    gtk_widget_set_halign(top_section, GTK_ALIGN_CENTER);
-    gtk_widget_set_valign(top_section, GTK_ALIGN_CENTER);
+    GtkBuilder *builder = load_page_template("complete-page");
+    template_set_label(builder, "complete_label", tr->complete_title);
 
     const char *logo_path = app->is_dark_theme ? 
         "/org/elysiaos/welcome/elyoslogo1.png" : 
         "/org/elysiaos/welcome/elyoslogo2.png";
-    GtkWidget *logo = make_resource_image(logo_path, 200);
-    gtk_widget_set_halign(logo, GTK_ALIGN_CENTER);
-    gtk_widget_set_valign(logo, GTK_ALIGN_CENTER);
-    gtk_box_append(GTK_BOX(top_section), logo);
-
-    GtkWidget *complete_label = gtk_label_new(tr->complete_title);
-    gtk_widget_add_css_class(complete_label, "display-1");
-    gtk_widget_add_css_class(complete_label, "accent");
-    gtk_widget_set_halign(complete_label, GTK_ALIGN_CENTER);
-    gtk_box_append(GTK_BOX(top_section), complete_label);
-
-    gtk_box_append(GTK_BOX(main_box), top_section);
-
-    /* Buttons section */
-    GtkWidget *buttons_section = gtk_box_new(GTK_ORIENTATION_VERTICAL, 20);
-    gtk_widget_set_halign(buttons_section, GTK_ALIGN_CENTER);
-    gtk_widget_set_valign(buttons_section, GTK_ALIGN_CENTER);
-
-    /* Support button */
-    GtkWidget *support_btn = gtk_button_new_with_label(tr->support_button);
-    gtk_widget_set_size_request(support_btn, 120, 40);
-    gtk_widget_add_css_class(support_btn, "glass-button");
-    gtk_widget_set_halign(support_btn, GTK_ALIGN_CENTER);
-    g_signal_connect(support_btn, "clicked", G_CALLBACK(on_support_clicked), NULL);
-    gtk_box_append(GTK_BOX(buttons_section), support_btn);
-
-    /* Discord button */
-    GtkWidget *discord_btn = gtk_button_new_with_label(tr->discord_button);
-    gtk_widget_set_size_request(discord_btn, 120, 40);
-    gtk_widget_add_css_class(discord_btn, "glass-button");
-    gtk_widget_set_halign(discord_btn, GTK_ALIGN_CENTER);
-    g_signal_connect(discord_btn, "clicked", G_CALLBACK(on_discord_clicked), NULL);
-    gtk_box_append(GTK_BOX(buttons_section), discord_btn);
-
-    /* Website button */
-    GtkWidget *website_btn = gtk_button_new_with_label(tr->website_button);
-    gtk_widget_set_size_request(website_btn, 120, 40);
-    gtk_widget_add_css_class(website_btn, "glass-button");
-    gtk_widget_set_halign(website_btn, GTK_ALIGN_CENTER);
-    g_signal_connect(website_btn, "clicked", G_CALLBACK(on_website_clicked), NULL);
-    gtk_box_append(GTK_BOX(buttons_section), website_btn);
-
-    gtk_box_append(GTK_BOX(main_box), buttons_section);
-
-    /* Close button at the bottom */
-    GtkWidget *close_section = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 0);
-    gtk_widget_set_halign(close_section, GTK_ALIGN_CENTER);
-
-    GtkWidget *close_btn = gtk_button_new_with_label(tr->close_button);
-    gtk_widget_set_size_request(close_btn, 120, 40);
-    gtk_widget_add_css_class(close_btn, "close-button");
-    gtk_widget_set_halign(close_btn, GTK_ALIGN_CENTER);
-    g_signal_connect(close_btn, "clicked", G_CALLBACK(on_finish_clicked), NULL);
-    gtk_box_append(GTK_BOX(close_section), close_btn);
-
-    gtk_box_append(GTK_BOX(main_box), close_section);
+    /* kept for update_logo_images(); the page owns it */
+    app->complete_logo = template_widget(builder, "logo");
+    if (!defer_prefetched_texture(app->complete_logo, logo_path)) set_resource_texture(app->complete_logo, logo_path);
+
+    static const struct {
+        const char *id;
+        GCallback   handler;
+    } buttons[] = {
+        { "support_button", G_CALLBACK(on_support_clicked) },
+        { "discord_button", G_CALLBACK(on_discord_clicked) },
+        { "website_button", G_CALLBACK(on_website_clicked) },
+        { "close_button",   G_CALLBACK(on_finish_clicked) },
+    };
+    const char *labels[] = { tr->support_button, tr->discord_button, tr->website_button, tr->close_button };
+    for (guint i = 0; i < G_N_ELEMENTS(buttons); i++) {
+        GtkWidget *button = template_widget(builder, buttons[i].id);
+        gtk_button_set_label(GTK_BUTTON(button), labels[i]);
+        g_signal_connect(button, "clicked", buttons[i].handler, app);
+    }
 
-    return main_box;
+    return template_take_page(builder);
 }
 
 /* ---------- Navigation and CSS ---------- */
 
 static void update_logo_images(WelcomeApp *app) {
-    g_print("Updating logo images, dark theme: %s\n", app->is_dark_theme ? "true" : "false");
+    PerfSpan span = perf_span_begin("update_logo_images");
+    log_debug(LOG_THEME, "Updating logo images, dark theme: %s", app->is_dark_theme ? "true" : "false");
     
     // Update welcome page logo
     GtkWidget *welcome_page = gtk_stack_get_child_by_name(GTK_STACK(app->content_stack), "welcome");
     if (welcome_page) {
-        g_print("Found welcome page\n");
+        log_debug(LOG_THEME, "Found welcome page");
         GtkWidget *welcome_box = gtk_widget_get_first_child(welcome_page);
         if (welcome_box) {
-            g_print("Found welcome box\n");
+            log_debug(LOG_THEME, "Found welcome box");
             GtkWidget *welcome_logo = gtk_widget_get_next_sibling(gtk_widget_get_first_child(welcome_box));
             if (welcome_logo) {
-                g_print("Found welcome logo\n");
+                log_debug(LOG_THEME, "Found welcome logo");
                 const char *logo_path = app->is_dark_theme ? 
                     "/org/elysiaos/welcome/elyoslogo1.png" : 
                     "/org/elysiaos/welcome/elyoslogo2.png";
                 
-                g_print("Setting welcome logo to: %s\n", logo_path);
+                log_debug(LOG_THEME, "Setting welcome logo to: %s", logo_path);
                 
                 // Remove the old image and add a new one
                 gtk_box_remove(GTK_BOX(welcome_box), welcome_logo);
@@ -1469,177 +2576,154 @@ static void update_logo_images(WelcomeApp *app) {
                 GtkWidget *new_logo = make_resource_image(logo_path, 200);
                 gtk_box_insert_child_after(GTK_BOX(welcome_box), new_logo, gtk_widget_get_first_child(welcome_box));
             } else {
-                g_print("Did not find welcome logo\n");
+                log_debug(LOG_THEME, "Did not find welcome logo");
             }
         } else {
-            g_print("Did not find welcome box\n");
+            log_debug(LOG_THEME, "Did not find welcome box");
         }
     } else {
-        g_print("Did not find welcome page\n");
+        log_debug(LOG_THEME, "Did not find welcome page");
     }
     
-    // Update complete page logo
-    GtkWidget *complete_page = gtk_stack_get_child_by_name(GTK_STACK(app->content_stack), "complete");
-    if (complete_page) {
-        g_print("Found complete page\n");
-        GtkWidget *complete_box = gtk_widget_get_first_child(complete_page);
-        if (complete_box) {
-            g_print("Found complete box\n");
-            GtkWidget *complete_top_section = gtk_widget_get_first_child(complete_box);
-            if (complete_top_section) {
-                g_print("Found complete top section\n");
-                GtkWidget *complete_logo = gtk_widget_get_first_child(complete_top_section);
-                if (complete_logo) {
-                    g_print("Found complete logo\n");
-                    const char *logo_path = app->is_dark_theme ? 
-                        "/org/elysiaos/welcome/elyoslogo1.png" : 
-                        "/org/elysiaos/welcome/elyoslogo2.png";
-                    
-                    g_print("Setting complete logo to: %s\n", logo_path);
-                    
-                    // Remove the old image and add a new one
-                    gtk_box_remove(GTK_BOX(complete_top_section), complete_logo);
-                    
-                    GtkWidget *new_logo = make_resource_image(logo_path, 200);
-                    gtk_box_append(GTK_BOX(complete_top_section), new_logo);
-                } else {
-                    g_print("Did not find complete logo\n");
-                }
-            } else {
-                g_print("Did not find complete top section\n");
-            }
-        } else {
-            g_print("Did not find complete box\n");
+    // Update complete page logo, bound from its template
+    if (app->complete_logo) {
+        const char *logo_path = app->is_dark_theme ? 
+            "/org/elysiaos/welcome/elyoslogo1.png" : 
+            "/org/elysiaos/welcome/elyoslogo2.png";
+        log_debug(LOG_THEME, "Setting complete logo to: %s", logo_path);
+        if (!defer_prefetched_texture(app->complete_logo, logo_path)) set_resource_texture(app->complete_logo, logo_path);
+    }
+    perf_span_end(&span);
+}
+
+/* ---------- Scoped theme ---------- */
+
+/* A theme switch restyles what is on screen right away: the window, the
+   page indicators and the visible page all switch in the same frame.
+   Hidden pages keep their old scope class until they are shown
+   (on_visible_page_changed), so their selectors are not rematched before
+   then (see theme_css.h).
+
+   Each restyle is timed on the frame clock, from the end of the update
+   phase to the end of the layout phase of the frame it lands in. GTK
+   validates styles and reallocates during that span. The time is logged,
+   and it is kept per page for the memory report when the frame restyled
+   one page. */
+typedef struct {
+    gint64 last_us;
+    gint64 total_us;
+    guint  count;
+} RestyleStats;
+
+typedef struct RestyleTiming {
+    GdkFrameClock *clock;
+    gulong         update_id;
+    gulong         layout_id;
+    gint64         update_end_us;
+    GPtrArray     *scopes;   // switched since the last frame
+} RestyleTiming;
+
+static void restyle_timing_free(WelcomeApp *app) {
+    RestyleTiming *t = app->restyle;
+    if (!t) return;
+    g_signal_handler_disconnect(t->clock, t->update_id);
+    g_signal_handler_disconnect(t->clock, t->layout_id);
+    g_object_unref(t->clock);
+    g_ptr_array_unref(t->scopes);
+    g_clear_pointer(&app->restyle, g_free);
+}
+
+static void on_restyle_update(GdkFrameClock *clock, gpointer user_data) {
+    (void)clock;
+    ((WelcomeApp*) user_data)->restyle->update_end_us = g_get_monotonic_time();
+}
+
+static void on_restyle_layout(GdkFrameClock *clock, gpointer user_data) {
+    (void)clock;
+    WelcomeApp *app = (WelcomeApp*) user_data;
+    RestyleTiming *t = app->restyle;
+    /* hooked up halfway through a frame: no clean sample */
+    if (t->update_end_us == 0) {
+        restyle_timing_free(app);
+        return;
+    }
+
+    gint64 cost_us = g_get_monotonic_time() - t->update_end_us;
+    GString *names = g_string_new(NULL);
+    GtkWidget *page = NULL;
+    guint pages = 0;
+    for (guint i = 0; i < t->scopes->len; i++) {
+        GtkWidget *scope = GTK_WIDGET(g_ptr_array_index(t->scopes, i));
+        g_string_append_printf(names, "%s%s", i > 0 ? " + " : "",
+                               (const char*) g_object_get_data(G_OBJECT(scope), "welcome-scope-name"));
+        if (gtk_widget_get_parent(scope) == app->content_stack) {
+            page = scope;
+            pages++;
         }
-    } else {
-        g_print("Did not find complete page\n");
     }
+    if (pages == 1) {
+        RestyleStats *stats = (RestyleStats*) g_object_get_data(G_OBJECT(page), "welcome-restyle");
+        if (!stats) {
+            stats = g_new0(RestyleStats, 1);
+            g_object_set_data_full(G_OBJECT(page), "welcome-restyle", stats, g_free);
+        }
+        stats->last_us = cost_us;
+        stats->total_us += cost_us;
+        stats->count++;
+    }
+    log_debug(LOG_PERF, "Restyle %s: %.2f ms style + layout", names->str, cost_us / 1000.0);
+    g_string_free(names, TRUE);
+    restyle_timing_free(app);
+}
+
+static void restyle_timing_add(WelcomeApp *app, GtkWidget *scope) {
+    /* before the first frame there is nothing to restyle yet */
+    GdkFrameClock *clock = gtk_widget_get_frame_clock(app->window);
+    if (!clock) return;
+    if (!app->restyle) {
+        RestyleTiming *t = g_new0(RestyleTiming, 1);
+        t->clock = GDK_FRAME_CLOCK(g_object_ref(clock));
+        t->scopes = g_ptr_array_new_with_free_func(g_object_unref);
+        t->update_id = g_signal_connect(clock, "update", G_CALLBACK(on_restyle_update), app);
+        t->layout_id = g_signal_connect(clock, "layout", G_CALLBACK(on_restyle_layout), app);
+        app->restyle = t;
+    }
+    g_ptr_array_add(app->restyle->scopes, g_object_ref(scope));
+    gdk_frame_clock_request_phase(clock, GDK_FRAME_CLOCK_PHASE_UPDATE);
+}
+
+/* Mark a freshly built scope root; it is styled with the current theme
+   from its first frame */
+static void init_theme_scope(WelcomeApp *app, GtkWidget *scope, const char *dark_class, const char *name) {
+    g_object_set_data(G_OBJECT(scope), "welcome-scope-name", (gpointer) name);
+    if (g_strcmp0(dark_class, THEME_DARK_CLASS) == 0) gtk_widget_add_css_class(scope, THEME_SCOPE_CLASS);
+    if (app->is_dark_theme) gtk_widget_add_css_class(scope, dark_class);
+}
+
+/* Switch scope to the app's theme; FALSE if it already had it */
+static gboolean apply_theme_scope(WelcomeApp *app, GtkWidget *scope, const char *dark_class) {
+    if (gtk_widget_has_css_class(scope, dark_class) == app->is_dark_theme) return FALSE;
+    if (app->is_dark_theme) gtk_widget_add_css_class(scope, dark_class);
+    else gtk_widget_remove_css_class(scope, dark_class);
+    restyle_timing_add(app, scope);
+    return TRUE;
 }
 
 static void update_theme_css(WelcomeApp *app) {
-    if (!app->theme_provider) return;
-    
-    const char *css;
-    if (app->is_dark_theme) {
-        css = "window { background-color: #333; color: #ffffff;}"
-              "window {font-family: ElysiaOSNew12;} "
-              ".display-1 {font-size: 34px; }"
-              ".display-2 {font-size: 28px; font-weight: bold; }"
-              ".page-indicators { margin: 20px; }"
-              ".page-dot { min-width:12px; min-height:12px; border-radius:6px; margin:0 4px; }"
-              ".active-dot { background-color: #fc77d9; }"
-              ".inactive-dot { background-color: #666; }"
-              ".theme-card { border-radius:16px; border:2px solid #555; background:#444; padding:8px; color: #ffffff; background-size: cover; background-position: center; width: 180px; height: 120px; }"  // Fixed size
-              ".theme-card:hover { border-color:#fc77d9; }"
-              ".theme-selected { border-color:#fc77d9 !important; background:#555 !important; }"
-              ".theme-card image { -gtk-icon-style: regular; }"
-              ".theme-label { background: rgba(0, 0, 0, 0.7); color: white; padding: 4px 8px; border-radius: 6px; font-size: 14px; }"
-              ".theme-card picture { min-width: 160px; min-height: 80px; max-width: 160px; max-height: 80px; }"
-              "#light-theme-button { background-image: url('/org/elysiaos/welcome/light.png'); }"
-              "#dark-theme-button { background-image: url('/org/elysiaos/welcome/dark.png'); }"
-              ".keybind-shortcut {"
-              "  font-family: ElysiaOSNew12;"
-              "  font-size: 11px;"
-              "  color: #ffffff;"
-              "  margin: 2px 8px 2px 0px;"
-              "  font-weight: 600;"
-              "  background: linear-gradient(to right, rgba(112, 119, 189, 0.2) 0%, rgba(177, 201, 236, 0.3) 100%);"
-              "  border: 1px solid rgba(112, 119, 189, 0.4);"
-              "  border-radius: 4px;"
-              "  padding: 4px 8px;"
-              "}"
-              ".keybind-description {"
-              "  font-family: ElysiaOSNew12;"
-              "  font-size: 11px;"
-              "  color: #cccccc;"
-              "  margin: 2px 0px 2px 8px;"
-              "  font-weight: 400;"
-              "}"
-              ".scrolled-window {"
-              "  background: transparent;"
-              "  border: none;"
-              "}"
-              ".scrolled-window scrollbar {"
-              "  background: transparent;"
-              "}"
-              ".scrolled-window scrollbar slider {"
-              "  background: rgba(255, 255, 255, 0.3);"
-              "  border-radius: 6px;"
-              "  min-width: 8px;"
-              "}"
-              ".scrolled-window scrollbar slider:hover {"
-              "  background: rgba(255, 255, 255, 0.5);"
-              "}"
-              ".tip-label {"
-              "  font-family: ElysiaOSNew12;"
-              "  font-size: 10px;"
-              "  color: #8e8e93;"
-              "  margin: 8px 0px;"
-              "  font-style: italic;"
-              "}";
-    } else {
-        css = "window { background-color: #ffedfa; color: #333;}"
-              "window {font-family: ElysiaOSNew12;} "
-              ".display-1 {font-size: 34px; }"
-              ".display-2 {font-size: 28px; font-weight: bold; }"
-              ".page-indicators { margin: 20px; }"
-              ".page-dot { min-width:12px; min-height:12px; border-radius:6px; margin:0 4px; }"
-              ".active-dot { background-color: #fc77d9; }"
-              ".inactive-dot { background-color: #c0c0c0; }"
-              ".theme-card { border-radius:16px; border:2px solid #e0e0e0; background:#fafafa; padding:8px; color: #333; background-size: cover; background-position: center; width: 180px; height: 120px; }"  // Fixed size
-              ".theme-card:hover { border-color:#fc77d9; }"
-              ".theme-selected { border-color:#fc77d9 !important; background:#f0f7ff !important; }"
-              ".theme-card image { -gtk-icon-style: regular; }"
-              ".theme-label { background: rgba(255, 255, 255, 0.7); color: black; padding: 4px 8px; border-radius: 6px; font-size: 14px; }"
-              ".theme-card picture { min-width: 160px; min-height: 80px; max-width: 160px; max-height: 80px; }"
-              "#light-theme-button { background-image: url('/org/elysiaos/welcome/light.png'); }"
-              "#dark-theme-button { background-image: url('/org/elysiaos/welcome/dark.png'); }"
-              ".keybind-shortcut {"
-              "  font-family: ElysiaOSNew12;"
-              "  font-size: 11px;"
-              "  color: #1d1d1f;"
-              "  margin: 2px 8px 2px 0px;"
-              "  font-weight: 600;"
-              "  background: linear-gradient(to right, rgba(229, 167, 198, 0.2) 0%, rgba(237, 206, 227, 0.3) 100%);"
-              "  border: 1px solid rgba(229, 167, 198, 0.4);"
-              "  border-radius: 4px;"
-              "  padding: 4px 8px;"
-              "}"
-              ".keybind-description {"
-              "  font-family: ElysiaOSNew12;"
-              "  font-size: 11px;"
-              "  color: #6d6d70;"
-              "  margin: 2px 0px 2px 8px;"
-              "  font-weight: 400;"
-              "}"
-              ".scrolled-window {"
-              "  background: transparent;"
-              "  border: none;"
-              "}"
-              ".scrolled-window scrollbar {"
-              "  background: transparent;"
-              "}"
-              ".scrolled-window scrollbar slider {"
-              "  background: rgba(0, 0, 0, 0.3);"
-              "  border-radius: 6px;"
-              "  min-width: 8px;"
-              "}"
-              ".scrolled-window scrollbar slider:hover {"
-              "  background: rgba(0, 0, 0, 0.5);"
-              "}"
-              ".tip-label {"
-              "  font-family: ElysiaOSNew12;"
-              "  font-size: 10px;"
-              "  color: #8e8e93;"
-              "  margin: 8px 0px;"
-              "  font-style: italic;"
-              "}";
+    PerfSpan span = perf_span_begin("update_theme_css");
+    guint switched = 0;
+    /* before activate() has built the window, scopes pick the theme up as they are created */
+    if (app->content_stack) {
+        switched += apply_theme_scope(app, app->window, THEME_DARK_WINDOW_CLASS);
+        switched += apply_theme_scope(app, app->page_indicators, THEME_DARK_CLASS);
+        GtkWidget *visible = gtk_stack_get_visible_child(GTK_STACK(app->content_stack));
+        if (visible) switched += apply_theme_scope(app, visible, THEME_DARK_CLASS);
     }
-    
-    gtk_css_provider_load_from_string(app->theme_provider, css);
+    perf_span_end_with(&span, "%s theme, %u scopes switched", app->is_dark_theme ? "dark" : "light", switched);
     
     // Update logo images based on theme
     update_logo_images(app);
+    if (app->keybinds_view) elysia_keybinds_view_set_dark(ELYSIA_KEYBINDS_VIEW(app->keybinds_view), app->is_dark_theme);
 }
 
 static void update_page_indicators(WelcomeApp *app) {
@@ -1704,6 +2788,7 @@ static void update_navigation(WelcomeApp *app) {
 static void on_back_clicked(GtkButton *button, WelcomeApp *app) {
     (void)button;
     if (app->current_page > 0) {
+        latency_mark("back");
         app->current_page--;
         const char* page_names[] = {"welcome", "theme", "network", "keybinds", "updater", "settings", "store", "complete"};
         gtk_stack_set_visible_child_name(GTK_STACK(app->content_stack), page_names[app->current_page]);
@@ -1714,6 +2799,7 @@ static void on_back_clicked(GtkButton *button, WelcomeApp *app) {
 static void on_next_clicked(GtkButton *button, WelcomeApp *app) {
     (void)button;
     if (app->current_page < 7) {
+        latency_mark("next");
         app->current_page++;
         const char* page_names[] = {"welcome", "theme", "network", "keybinds", "updater", "settings", "store", "complete"};
         gtk_stack_set_visible_child_name(GTK_STACK(app->content_stack), page_names[app->current_page]);
@@ -1723,13 +2809,13 @@ static void on_next_clicked(GtkButton *button, WelcomeApp *app) {
 
 static void on_skip_clicked(GtkButton *button, WelcomeApp *app) {
     (void)button;
-    g_print("Setup completed (skipped)\n");
+    log_info(LOG_UI, "Setup completed (skipped)");
     gtk_window_destroy(GTK_WINDOW(app->window));
 }
 
 static void on_finish_clicked(GtkButton *button, WelcomeApp *app) {
     (void)button;
-    g_print("Setup completed\n");
+    log_info(LOG_UI, "Setup completed");
     gtk_window_destroy(GTK_WINDOW(app->window));
 }
 
@@ -1737,93 +2823,1264 @@ static void setup_css(WelcomeApp *app) {
     app->theme_provider = gtk_css_provider_new();
     app->is_dark_theme = FALSE; // Start with light theme
     
-    const char *css =
-        "window { background-color: #ffedfa; color: #333;}"
-        "window {font-family: ElysiaOSNew12;} "
-        ".display-1 {font-size: 34px; }"
-        ".display-2 {font-size: 28px; font-weight: bold; }"
-        ".page-indicators { margin: 20px; }"
-        ".page-dot { min-width:12px; min-height:12px; border-radius:6px; margin:0 4px; }"
-        ".active-dot { background-color: #fc77d9; }"
-        ".inactive-dot { background-color: #c0c0c0; }"
-        ".theme-card { border-radius:16px; border:2px solid #e0e0e0; background:#fafafa; padding:8px; color: #333; background-size: cover; background-position: center; width: 180px; height: 120px; }"  // Fixed size
-        ".theme-card:hover { border-color:#fc77d9; }"
-        ".theme-selected { border-color:#fc77d9 !important; background:#f0f7ff !important; }"
-        ".theme-card image { -gtk-icon-style: regular; }"
-        ".theme-label { background: rgba(255, 255, 255, 0.7); color: black; padding: 4px 8px; border-radius: 6px; font-size: 14px; }"
-        ".theme-card picture { min-width: 160px; min-height: 80px; max-width: 160px; max-height: 80px; }"
-        "#light-theme-button { background-image: url('/org/elysiaos/welcome/light.png'); }"
-        "#dark-theme-button { background-image: url('/org/elysiaos/welcome/dark.png'); }"
-        ".keybind-shortcut {"
-        "  font-family: ElysiaOSNew12;"
+    PerfSpan span = perf_span_begin("setup_css");
+    gtk_css_provider_load_from_string(app->theme_provider, theme_css);
+    perf_span_end(&span);
+    gtk_style_context_add_provider_for_display(gdk_display_get_default(), GTK_STYLE_PROVIDER(app->theme_provider), GTK_STYLE_PROVIDER_PRIORITY_APPLICATION);
+}
+
+/* ---------- Profiling HUD ---------- */
+
+/* WELCOME_HUD=1 overlays frame timings on the content: last frame interval
+   and paint cost, frames dropped during the last stack transition, the
+   current page, widget count and decoded texture memory. Timings come
+   from the window's frame clock; the label itself refreshes at 4 Hz. */
+typedef struct FrameHud {
+    GtkWidget     *label;
+    GdkFrameClock *clock;
+    gulong         paint_id;
+    gint64         last_paint_us;
+    gint64         last_frame;
+    gint64         interval_us;
+    gint64         cost_us;
+    gint64         worst_interval_us;
+    gboolean       in_transition;
+    guint          transition_frames;
+    guint          transition_dropped;
+    guint          last_transition_frames;
+    guint          last_transition_dropped;
+} FrameHud;
+
+static guint count_widgets(GtkWidget *widget) {
+    guint n = 1;
+    for (GtkWidget *child = gtk_widget_get_first_child(widget); child; child = gtk_widget_get_next_sibling(child)) {
+        n += count_widgets(child);
+    }
+    return n;
+}
+
+static void on_hud_after_paint(GdkFrameClock *clock, gpointer user_data) {
+    WelcomeApp *app = (WelcomeApp*) user_data;
+    FrameHud *hud = app->hud;
+    gint64 now = g_get_monotonic_time();
+    gint64 frame = gdk_frame_clock_get_frame_counter(clock);
+    hud->cost_us = now - gdk_frame_clock_get_frame_time(clock);
+
+    gint64 refresh_us = 0;
+    gdk_frame_clock_get_refresh_info(clock, 0, &refresh_us, NULL);
+    if (refresh_us <= 0) refresh_us = 16667;
+
+    /* Only back-to-back frames say anything about smoothness; a gap after
+       the clock went idle is not a drop */
+    gboolean consecutive = hud->last_frame + 1 == frame;
+    if (consecutive) {
+        hud->interval_us = now - hud->last_paint_us;
+        hud->worst_interval_us = MAX(hud->worst_interval_us, hud->interval_us);
+    }
+    hud->last_paint_us = now;
+    hud->last_frame = frame;
+
+    gboolean running = gtk_stack_get_transition_running(GTK_STACK(app->content_stack));
+    if (running && !hud->in_transition) {
+        hud->transition_frames = 0;
+        hud->transition_dropped = 0;
+    }
+    if (running) {
+        hud->transition_frames++;
+        if (consecutive) {
+            gint64 missed = (hud->interval_us + refresh_us / 2) / refresh_us - 1;
+            if (missed > 0) hud->transition_dropped += (guint) missed;
+        }
+    } else if (hud->in_transition) {
+        hud->last_transition_frames = hud->transition_frames;
+        hud->last_transition_dropped = hud->transition_dropped;
+        log_debug(LOG_PERF, "Stack transition: %u frames, %u dropped",
+                  hud->transition_frames, hud->transition_dropped);
+    }
+    hud->in_transition = running;
+}
+
+static gboolean hud_update_timeout(gpointer user_data) {
+    WelcomeApp *app = (WelcomeApp*) user_data;
+    FrameHud *hud = app->hud;
+
+    gchar *text = g_strdup_printf("frame %5.1f ms  paint %5.1f ms  worst %5.1f ms\n"
+                                  "last transition: %u frames, %u dropped\n"
+                                  "quality %s\n"
+                                  "page %s  widgets %u  textures %.1f MiB",
+                                  hud->interval_us / 1000.0, hud->cost_us / 1000.0,
+                                  hud->worst_interval_us / 1000.0,
+                                  hud->last_transition_frames, hud->last_transition_dropped,
+                                  render_quality_describe(),
+                                  gtk_stack_get_visible_child_name(GTK_STACK(app->content_stack)),
+                                  count_widgets(app->window),
+                                  texture_bytes_total / (1024.0 * 1024.0));
+    gtk_label_set_text(GTK_LABEL(hud->label), text);
+    g_free(text);
+    hud->worst_interval_us = 0;
+    return G_SOURCE_CONTINUE;
+}
+
+static void hud_attach(WelcomeApp *app, GtkWidget *overlay) {
+    const gchar *env = g_getenv("WELCOME_HUD");
+    if (!env || !*env || g_strcmp0(env, "0") == 0) return;
+
+    app->hud = g_new0(FrameHud, 1);
+    app->hud->label = gtk_label_new(NULL);
+    gtk_widget_add_css_class(app->hud->label, "perf-hud");
+    gtk_widget_set_halign(app->hud->label, GTK_ALIGN_START);
+    gtk_widget_set_valign(app->hud->label, GTK_ALIGN_START);
+    gtk_widget_set_can_target(app->hud->label, FALSE);
+    gtk_overlay_add_overlay(GTK_OVERLAY(overlay), app->hud->label);
+
+    /* Separate provider, so the HUD rules stay out of the theme sheet */
+    GtkCssProvider *provider = gtk_css_provider_new();
+    gtk_css_provider_load_from_string(provider,
+        ".perf-hud {"
+        "  font-family: monospace;"
         "  font-size: 11px;"
-        "  color: #1d1d1f;"
-        "  margin: 2px 8px 2px 0px;"
-        "  font-weight: 600;"
-        "  background: linear-gradient(to right, rgba(229, 167, 198, 0.2) 0%, rgba(237, 206, 227, 0.3) 100%);"
-        "  border: 1px solid rgba(229, 167, 198, 0.4);"
-        "  border-radius: 4px;"
+        "  color: #00ff88;"
+        "  background-color: rgba(0, 0, 0, 0.7);"
         "  padding: 4px 8px;"
-        "}"
-        ".keybind-description {"
-        "  font-family: ElysiaOSNew12;"
-        "  font-size: 11px;"
-        "  color: #6d6d70;"
-        "  margin: 2px 0px 2px 8px;"
-        "  font-weight: 400;"
-        "}"
-        ".scrolled-window {"
-        "  background: transparent;"
-        "  border: none;"
-        "}"
-        ".scrolled-window scrollbar {"
-        "  background: transparent;"
-        "}"
-        ".scrolled-window scrollbar slider {"
-        "  background: rgba(0, 0, 0, 0.3);"
-        "  border-radius: 6px;"
-        "  min-width: 8px;"
-        "}"
-        ".scrolled-window scrollbar slider:hover {"
-        "  background: rgba(0, 0, 0, 0.5);"
-        "}"
-        ".tip-label {"
-        "  font-family: ElysiaOSNew12;"
-        "  font-size: 10px;"
-        "  color: #8e8e93;"
-        "  margin: 8px 0px;"
-        "  font-style: italic;"
-        "}"
-        ".title-3 {"
-        "  font-size: 18px;"
-        "  font-weight: normal;"
-        "}"
-        ".dim-label {"
-        "  color: #666;"
-        "}";
-        
-    gtk_css_provider_load_from_string(app->theme_provider, css);
-    gtk_style_context_add_provider_for_display(gdk_display_get_default(), GTK_STYLE_PROVIDER(app->theme_provider), GTK_STYLE_PROVIDER_PRIORITY_APPLICATION);
+        "  margin: 6px;"
+        "  border-radius: 4px;"
+        "}");
+    gtk_style_context_add_provider_for_display(gdk_display_get_default(), GTK_STYLE_PROVIDER(provider),
+                                               GTK_STYLE_PROVIDER_PRIORITY_APPLICATION + 1);
+    g_object_unref(provider);
+
+    app_timeout_add(app, 250, hud_update_timeout);
 }
 
-/* ---------- Lifecycle ---------- */
+/* The frame clock only exists once the window is realized */
+static void hud_watch_frame_clock(WelcomeApp *app) {
+    if (!app->hud || app->hud->clock) return;
+    GdkFrameClock *clock = gtk_widget_get_frame_clock(app->window);
+    if (!clock) return;
+    app->hud->clock = GDK_FRAME_CLOCK(g_object_ref(clock));
+    app->hud->paint_id = g_signal_connect(clock, "after-paint", G_CALLBACK(on_hud_after_paint), app);
+}
 
-static void on_window_destroy(GtkWidget *w, gpointer user_data) {
+static void hud_free(WelcomeApp *app) {
+    if (!app->hud) return;
+    if (app->hud->clock) {
+        g_signal_handler_disconnect(app->hud->clock, app->hud->paint_id);
+        g_object_unref(app->hud->clock);
+    }
+    g_clear_pointer(&app->hud, g_free);
+}
+
+/* ---------- Memory report ---------- */
+
+/* Resident memory, decoded textures per resource, widgets and style
+   classes per stack page, and the NMClient object cache. Printed by
+   --memory-report once the window is up, and on SIGUSR1 at any time
+   (followed by the input latency percentiles, see latency.h).
+
+   GTK doesn't expose the CSS node tree, so each widget is counted as one
+   node; internal nodes (sliders, selections, ...) come on top of that.
+   The style class count shows how much selector matching a page costs. */
+static void read_proc_memory(gsize *rss_kb, gsize *peak_kb, gsize *anon_kb, gsize *file_kb) {
+    *rss_kb = *peak_kb = *anon_kb = *file_kb = 0;
+    gchar *status = NULL;
+    if (!g_file_get_contents("/proc/self/status", &status, NULL, NULL)) return;
+
+    gchar **lines = g_strsplit(status, "\n", -1);
+    for (gchar **l = lines; *l; l++) {
+        gsize *field = NULL;
+        if (g_str_has_prefix(*l, "VmRSS:")) field = rss_kb;
+        else if (g_str_has_prefix(*l, "VmHWM:")) field = peak_kb;
+        else if (g_str_has_prefix(*l, "RssAnon:")) field = anon_kb;
+        else if (g_str_has_prefix(*l, "RssFile:")) field = file_kb;
+        if (field) *field = g_ascii_strtoull(strchr(*l, ':') + 1, NULL, 10);
+    }
+    g_strfreev(lines);
+    g_free(status);
+}
+
+static void count_widget_tree(GtkWidget *widget, guint *widgets, guint *classes) {
+    (*widgets)++;
+    gchar **css_classes = gtk_widget_get_css_classes(widget);
+    *classes += g_strv_length(css_classes);
+    g_strfreev(css_classes);
+    for (GtkWidget *child = gtk_widget_get_first_child(widget); child; child = gtk_widget_get_next_sibling(child)) {
+        count_widget_tree(child, widgets, classes);
+    }
+}
+
+static gint compare_texture_usage(gconstpointer a, gconstpointer b, gpointer user_data) {
+    const TextureUsage *x = (const TextureUsage*) g_hash_table_lookup((GHashTable*) user_data, a);
+    const TextureUsage *y = (const TextureUsage*) g_hash_table_lookup((GHashTable*) user_data, b);
+    return (y->bytes > x->bytes) - (y->bytes < x->bytes);
+}
+
+static void print_memory_report(WelcomeApp *app) {
+    gsize rss_kb, peak_kb, anon_kb, file_kb;
+    read_proc_memory(&rss_kb, &peak_kb, &anon_kb, &file_kb);
+    g_print("Memory report\n");
+    g_print("  resident   %6.1f MiB (peak %.1f MiB; anon %.1f MiB, file %.1f MiB)\n",
+            rss_kb / 1024.0, peak_kb / 1024.0, anon_kb / 1024.0, file_kb / 1024.0);
+
+    g_print("  render     %s\n", render_quality_describe());
+    g_print("  textures   %6.1f MiB decoded\n", texture_bytes_total / (1024.0 * 1024.0));
+    if (texture_usage) {
+        GList *paths = g_list_sort_with_data(g_hash_table_get_keys(texture_usage), compare_texture_usage, texture_usage);
+        for (GList *l = paths; l; l = l->next) {
+            const TextureUsage *usage = (const TextureUsage*) g_hash_table_lookup(texture_usage, l->data);
+            g_print("    %8.1f KiB  x%u  %s\n", usage->bytes / 1024.0, usage->live, (const gchar*) l->data);
+        }
+        g_list_free(paths);
+    }
+
+    g_print("  pages      widgets  style classes  last restyle\n");
+    guint total_widgets = 0, total_classes = 0;
+    count_widget_tree(app->window, &total_widgets, &total_classes);
+    for (GtkWidget *child = gtk_widget_get_first_child(app->content_stack); child; child = gtk_widget_get_next_sibling(child)) {
+        guint widgets = 0, classes = 0;
+        count_widget_tree(child, &widgets, &classes);
+        GtkStackPage *page = gtk_stack_get_page(GTK_STACK(app->content_stack), child);
+        const RestyleStats *restyle = (const RestyleStats*) g_object_get_data(G_OBJECT(child), "welcome-restyle");
+        gchar *restyled = restyle ? g_strdup_printf("%6.2f ms (x%u)", restyle->last_us / 1000.0, restyle->count)
+                                  : g_strdup("     -");
+        g_print("    %-10s %7u  %13u  %s\n", page ? gtk_stack_page_get_name(page) : "?", widgets, classes, restyled);
+        g_free(restyled);
+    }
+    g_print("    %-10s %7u  %13u\n", "(window)", total_widgets, total_classes);
+
+    if (app->nm_client) {
+        const GPtrArray *devices = nm_client_get_all_devices(app->nm_client);
+        const GPtrArray *connections = nm_client_get_connections(app->nm_client);
+        const GPtrArray *active = nm_client_get_active_connections(app->nm_client);
+        guint aps = 0;
+        for (guint i = 0; devices && i < devices->len; i++) {
+            NMDevice *dev = NM_DEVICE(g_ptr_array_index(devices, i));
+            if (NM_IS_DEVICE_WIFI(dev)) aps += nm_device_wifi_get_access_points(NM_DEVICE_WIFI(dev))->len;
+        }
+        g_print("  NMClient   %u devices, %u access points, %u connections, %u active\n",
+                devices ? devices->len : 0, aps,
+                connections ? connections->len : 0, active ? active->len : 0);
+    }
+}
+
+static gboolean on_memory_report_signal(gpointer user_data) {
     WelcomeApp *app = (WelcomeApp*) user_data;
-    if (!app) return;
-    
-    /* Clean up timeouts if active */
-    if (app->update_timeout_id > 0) {
-        g_source_remove(app->update_timeout_id);
-        app->update_timeout_id = 0;
+    print_memory_report(app);
+    if (latency_attached_to(app->window)) latency_report();
+    return G_SOURCE_CONTINUE;
+}
+
+/* --memory-report: give NM and the first frames a moment, report, quit */
+static gboolean memory_report_timeout(gpointer user_data) {
+    WelcomeApp *app = (WelcomeApp*) user_data;
+    print_memory_report(app);
+    gtk_window_destroy(GTK_WINDOW(app->window));
+    return G_SOURCE_REMOVE;
+}
+
+/* ---------- Object census ---------- */
+
+/* --census-rescans N: throw the Wi-Fi list away and rebuild it N times,
+   the way every scan used to, then compare live object counts with the
+   counts after the first rebuild. Any tracked type that grew fails the
+   run with exit status 1. */
+static gboolean census_rescan_step(gpointer user_data) {
+    WelcomeApp *app = (WelcomeApp*) user_data;
+
+    if (app->census_rescans_left == 0) {
+        guint grown = census_diff(app->census_baseline, "after rescans", G_LOG_LEVEL_MESSAGE);
+        log_message(LOG_PERF, "census: %u simulated rescans, %u types accumulated objects",
+                    (guint) opt_census_rescans, grown);
+        if (grown > 0) census_exit_status = 1;
+        gtk_window_destroy(GTK_WINDOW(app->window));
+        return G_SOURCE_REMOVE;
     }
-    
+
+    wifi_store_clear(app);
+    populate_wifi_list_now(app);
+
+    /* the first rebuild only warms up caches and lazily created objects */
+    if (!app->census_baseline) app->census_baseline = census_snapshot();
+    app->census_rescans_left--;
+    return G_SOURCE_CONTINUE;
+}
+
+static gboolean census_rescans_start(gpointer user_data) {
+    WelcomeApp *app = (WelcomeApp*) user_data;
+    app->census_rescans_left = opt_census_rescans + 1;
+    app_timeout_add(app, 0, census_rescan_step);
+    return G_SOURCE_REMOVE;
+}
+
+/* ---------- Render benchmark ---------- */
+
+/* --render-bench walks every stack page in both themes and prints what
+   each one costs to lay out, snapshot and render, then replays the
+   next-button transitions and prints per-frame layout and paint times.
+   tools/render-bench.sh runs it headless with GSK_RENDERER=cairo so the
+   numbers are comparable between CI runs; --render-bench-png DIR also
+   writes every rendered page to DIR/<theme>-<page>.png for image diffs.
+
+   The static pass drives layout and snapshot by hand, so it can time
+   them separately. Transition frames come from the window's frame clock,
+   where snapshot and render share the paint phase. */
+#define RENDER_BENCH_REPEATS 5
+
+typedef struct {
+    gint64 layout_us;
+    gint64 snapshot_us;
+    gint64 render_us;
+} PageTiming;
+
+typedef struct {
+    gint64 update_end_us;   // 0 until this frame's update phase is over
+    gint64 layout_end_us;
+    gint64 layout_max_us;
+    gint64 layout_total_us;
+    gint64 paint_max_us;
+    gint64 paint_total_us;
+    gint64 last_paint_us;
+    gint64 interval_max_us;
+    guint  frames;
+} TransitionTiming;
+
+typedef struct RenderBench {
+    gboolean          dark;
+    GdkFrameClock    *clock;
+    gulong            clock_ids[3];
+    gulong            transition_id;
+    TransitionTiming  transition;
+    const char       *transition_from;
+} RenderBench;
+
+static gint compare_page_timing(gconstpointer a, gconstpointer b) {
+    const PageTiming *x = (const PageTiming*) a, *y = (const PageTiming*) b;
+    gint64 tx = x->layout_us + x->snapshot_us + x->render_us;
+    gint64 ty = y->layout_us + y->snapshot_us + y->render_us;
+    return (tx > ty) - (tx < ty);
+}
+
+static void render_bench_set_theme(WelcomeApp *app, gboolean dark) {
+    app->is_dark_theme = dark;
+    PerfSpan span = perf_span_begin("update_theme_css");
+    gint64 start = g_get_monotonic_time();
+    update_theme_css(app);
+    /* pages are rendered directly, hidden or not: switch them all now */
+    for (GtkWidget *page = gtk_widget_get_first_child(app->content_stack); page; page = gtk_widget_get_next_sibling(page)) {
+        apply_theme_scope(app, page, THEME_DARK_CLASS);
+    }
+    g_print("  %s theme css      %7.2f ms\n", dark ? "dark " : "light", (g_get_monotonic_time() - start) / 1000.0);
+    perf_span_end(&span);
+}
+
+/* One layout + snapshot + render of page at the stack's size; returns
+   the texture when the caller wants to save it */
+static PageTiming render_bench_page(WelcomeApp *app, GtkWidget *page, GdkTexture **texture_out) {
+    PageTiming t = { 0, 0, 0 };
+    int width = gtk_widget_get_width(app->content_stack);
+    int height = gtk_widget_get_height(app->content_stack);
+
+    gint64 start = g_get_monotonic_time();
+    gtk_widget_queue_resize(page);
+    int min, nat;
+    gtk_widget_measure(page, GTK_ORIENTATION_HORIZONTAL, -1, &min, &nat, NULL, NULL);
+    gtk_widget_measure(page, GTK_ORIENTATION_VERTICAL, width, &min, &nat, NULL, NULL);
+    gtk_widget_allocate(page, width, height, -1, NULL);
+    gint64 laid_out = g_get_monotonic_time();
+
+    GdkPaintable *paintable = gtk_widget_paintable_new(page);
+    GtkSnapshot *snapshot = gtk_snapshot_new();
+    gdk_paintable_snapshot(paintable, GDK_SNAPSHOT(snapshot), width, height);
+    GskRenderNode *node = gtk_snapshot_free_to_node(snapshot);
+    gint64 snapshotted = g_get_monotonic_time();
+
+    GdkTexture *texture = NULL;
+    if (node) {
+        graphene_rect_t bounds = GRAPHENE_RECT_INIT(0, 0, (float) width, (float) height);
+        texture = gsk_renderer_render_texture(gtk_native_get_renderer(GTK_NATIVE(app->window)), node, &bounds);
+        gsk_render_node_unref(node);
+    }
+    gint64 rendered = g_get_monotonic_time();
+    g_object_unref(paintable);
+
+    t.layout_us = laid_out - start;
+    t.snapshot_us = snapshotted - laid_out;
+    t.render_us = rendered - snapshotted;
+    if (texture_out) *texture_out = texture;
+    else g_clear_object(&texture);
+    return t;
+}
+
+/* First (cold) pass plus the median of RENDER_BENCH_REPEATS warm passes */
+static void render_bench_pages(WelcomeApp *app, gboolean dark) {
+    GtkStack *stack = GTK_STACK(app->content_stack);
+    const char *theme = dark ? "dark" : "light";
+    g_print("  %-10s %9s  %17s  %17s  %17s\n", "page", "build", "layout cold/warm",
+            "snapshot cold/warm", "render cold/warm");
+
+    for (GtkWidget *page = gtk_widget_get_first_child(app->content_stack); page; page = gtk_widget_get_next_sibling(page)) {
+        const char *name = gtk_stack_page_get_name(gtk_stack_get_page(stack, page));
+        gtk_stack_set_visible_child(stack, page);
+
+        GdkTexture *texture = NULL;
+        PageTiming cold = render_bench_page(app, page, opt_render_bench_png ? &texture : NULL);
+        if (texture) {
+            gchar *file = g_strdup_printf("%s-%s.png", theme, name);
+            gchar *path = g_build_filename(opt_render_bench_png, file, NULL);
+            if (!gdk_texture_save_to_png(texture, path)) log_warning(LOG_PERF, "Could not write %s", path);
+            g_free(path);
+            g_free(file);
+            g_object_unref(texture);
+        }
+
+        PageTiming warm[RENDER_BENCH_REPEATS];
+        for (guint i = 0; i < RENDER_BENCH_REPEATS; i++) warm[i] = render_bench_page(app, page, NULL);
+        qsort(warm, RENDER_BENCH_REPEATS, sizeof(PageTiming), compare_page_timing);
+        const PageTiming *median = &warm[RENDER_BENCH_REPEATS / 2];
+
+        gint64 build_us = (gint64) GPOINTER_TO_SIZE(g_object_get_data(G_OBJECT(page), "welcome-build-us"));
+        g_print("  %-10s %6.2f ms  %7.2f / %5.2f ms  %7.2f / %5.2f ms  %7.2f / %5.2f ms\n",
+                name, build_us / 1000.0,
+                cold.layout_us / 1000.0, median->layout_us / 1000.0,
+                cold.snapshot_us / 1000.0, median->snapshot_us / 1000.0,
+                cold.render_us / 1000.0, median->render_us / 1000.0);
+    }
+}
+
+/* Frame clock phase handlers run after GTK's own, so each timestamp marks
+   the end of that phase */
+static void on_bench_update(GdkFrameClock *clock, gpointer user_data) {
+    (void)clock;
+    ((WelcomeApp*) user_data)->bench->transition.update_end_us = g_get_monotonic_time();
+}
+
+static void on_bench_layout(GdkFrameClock *clock, gpointer user_data) {
+    (void)clock;
+    ((WelcomeApp*) user_data)->bench->transition.layout_end_us = g_get_monotonic_time();
+}
+
+static void on_bench_paint(GdkFrameClock *clock, gpointer user_data) {
+    (void)clock;
+    WelcomeApp *app = (WelcomeApp*) user_data;
+    TransitionTiming *t = &app->bench->transition;
+    gboolean counted = gtk_stack_get_transition_running(GTK_STACK(app->content_stack)) &&
+                       t->update_end_us != 0 && t->layout_end_us != 0;
+    if (!counted) {
+        t->update_end_us = t->layout_end_us = 0;
+        return;
+    }
+
+    gint64 now = g_get_monotonic_time();
+    gint64 layout_us = t->layout_end_us - t->update_end_us;
+    t->layout_total_us += layout_us;
+    t->layout_max_us = MAX(t->layout_max_us, layout_us);
+    gint64 paint_us = now - t->layout_end_us;
+    t->paint_total_us += paint_us;
+    t->paint_max_us = MAX(t->paint_max_us, paint_us);
+    if (t->last_paint_us) t->interval_max_us = MAX(t->interval_max_us, now - t->last_paint_us);
+    t->last_paint_us = now;
+    t->frames++;
+    t->update_end_us = t->layout_end_us = 0;
+}
+
+static gboolean render_bench_next_transition(gpointer user_data);
+static void render_bench_finish(WelcomeApp *app);
+
+static void render_bench_report_transition(WelcomeApp *app) {
+    const TransitionTiming *t = &app->bench->transition;
+    guint frames = MAX(t->frames, 1);
+    g_print("  %-8s -> %-8s %3u frames  layout %5.2f / %5.2f ms  paint %5.2f / %5.2f ms  worst interval %5.1f ms\n",
+            app->bench->transition_from,
+            gtk_stack_get_visible_child_name(GTK_STACK(app->content_stack)),
+            t->frames,
+            t->layout_total_us / 1000.0 / frames, t->layout_max_us / 1000.0,
+            t->paint_total_us / 1000.0 / frames, t->paint_max_us / 1000.0,
+            t->interval_max_us / 1000.0);
+}
+
+static void on_bench_transition_running(GObject *object, GParamSpec *pspec, gpointer user_data) {
+    (void)object; (void)pspec;
+    WelcomeApp *app = (WelcomeApp*) user_data;
+    if (gtk_stack_get_transition_running(GTK_STACK(app->content_stack))) return;
+    render_bench_report_transition(app);
+    app_timeout_add(app, 0, render_bench_next_transition);
+}
+
+/* Step through the wizard with the next button's handler, one
+   transition at a time, then do the same in the other theme */
+static gboolean render_bench_next_transition(gpointer user_data) {
+    WelcomeApp *app = (WelcomeApp*) user_data;
+    RenderBench *bench = app->bench;
+
+    if (app->current_page >= 7) {
+        if (bench->dark) {
+            render_bench_finish(app);
+            return G_SOURCE_REMOVE;
+        }
+        bench->dark = TRUE;
+        render_bench_set_theme(app, TRUE);
+        app->current_page = 0;
+        gtk_stack_set_transition_type(GTK_STACK(app->content_stack), GTK_STACK_TRANSITION_TYPE_NONE);
+        gtk_stack_set_visible_child_name(GTK_STACK(app->content_stack), "welcome");
+        render_quality_apply_transition(GTK_STACK(app->content_stack));
+        update_navigation(app);
+        g_print("Transitions, dark theme (avg / max per frame)\n");
+        /* let the restyle land before timing the first slide */
+        app_timeout_add(app, 200, render_bench_next_transition);
+        return G_SOURCE_REMOVE;
+    }
+
+    memset(&bench->transition, 0, sizeof(bench->transition));
+    bench->transition_from = gtk_stack_get_visible_child_name(GTK_STACK(app->content_stack));
+    on_next_clicked(NULL, app);
+    /* no animation means no notify; report the empty transition and move on */
+    if (!gtk_stack_get_transition_running(GTK_STACK(app->content_stack))) {
+        render_bench_report_transition(app);
+        return G_SOURCE_CONTINUE;
+    }
+    return G_SOURCE_REMOVE;
+}
+
+static void render_bench_free(WelcomeApp *app) {
+    RenderBench *bench = app->bench;
+    if (!bench) return;
+    if (bench->clock) {
+        for (guint i = 0; i < G_N_ELEMENTS(bench->clock_ids); i++) g_signal_handler_disconnect(bench->clock, bench->clock_ids[i]);
+        g_object_unref(bench->clock);
+    }
+    if (bench->transition_id) g_signal_handler_disconnect(app->content_stack, bench->transition_id);
+    g_clear_pointer(&app->bench, g_free);
+}
+
+static void render_bench_finish(WelcomeApp *app) {
+    render_bench_free(app);
+    gtk_window_destroy(GTK_WINDOW(app->window));
+}
+
+static gboolean render_bench_start(gpointer user_data) {
+    WelcomeApp *app = (WelcomeApp*) user_data;
+    GdkFrameClock *clock = gtk_widget_get_frame_clock(app->window);
+    if (!clock) {
+        log_warning(LOG_PERF, "Render benchmark needs a mapped window");
+        gtk_window_destroy(GTK_WINDOW(app->window));
+        return G_SOURCE_REMOVE;
+    }
+
+    /* The benchmark picks the theme; don't let the poll switch it back */
     if (app->theme_check_id > 0) {
         g_source_remove(app->theme_check_id);
         app->theme_check_id = 0;
     }
+    if (opt_render_bench_png) g_mkdir_with_parents(opt_render_bench_png, 0755);
+    /* headless sessions may turn animations off, which skips transitions */
+    g_object_set(gtk_settings_get_default(), "gtk-enable-animations", TRUE, NULL);
+    /* time the same transitions every run, unless a level was asked for */
+    if (!render_quality_pinned) render_quality_pin(RENDER_QUALITY_FULL, "render benchmark");
+
+    GskRenderer *renderer = gtk_native_get_renderer(GTK_NATIVE(app->window));
+    g_print("Render benchmark: %s, %s, %dx%d, quality %s\n",
+            G_OBJECT_TYPE_NAME(gdk_display_get_default()), renderer ? G_OBJECT_TYPE_NAME(renderer) : "no renderer",
+            gtk_widget_get_width(app->content_stack), gtk_widget_get_height(app->content_stack),
+            render_quality_describe());
+
+    GtkStack *stack = GTK_STACK(app->content_stack);
+    gtk_stack_set_transition_type(stack, GTK_STACK_TRANSITION_TYPE_NONE);
+    for (int dark = 0; dark <= 1; dark++) {
+        g_print("Pages, %s theme (build is the create_*_page call at startup)\n", dark ? "dark" : "light");
+        render_bench_set_theme(app, dark);
+        render_bench_pages(app, dark);
+    }
+
+    /* back to the start, light theme, for the transition pass */
+    render_bench_set_theme(app, FALSE);
+    gtk_stack_set_visible_child_name(stack, "welcome");
+    render_quality_apply_transition(stack);
+    app->current_page = 0;
+    update_navigation(app);
+
+    app->bench = g_new0(RenderBench, 1);
+    app->bench->clock = GDK_FRAME_CLOCK(g_object_ref(clock));
+    app->bench->clock_ids[0] = g_signal_connect(clock, "update", G_CALLBACK(on_bench_update), app);
+    app->bench->clock_ids[1] = g_signal_connect(clock, "layout", G_CALLBACK(on_bench_layout), app);
+    app->bench->clock_ids[2] = g_signal_connect(clock, "paint", G_CALLBACK(on_bench_paint), app);
+    app->bench->transition_id = g_signal_connect(stack, "notify::transition-running",
+                                                 G_CALLBACK(on_bench_transition_running), app);
+
+    g_print("Transitions, light theme (avg / max per frame)\n");
+    app_timeout_add(app, 200, render_bench_next_transition);
+    return G_SOURCE_REMOVE;
+}
+
+/* ---------- Scripted walkthrough ---------- */
+
+/* --script FILE drives the wizard from a command file, one per line:
+
+     next | back                   the navigation arrows
+     select-theme light|dark       a theme card
+     wifi-refresh                  the refresh button
+     connect SSID [PASSWORD]       a network row; the password answers the
+                                   prompt a new secured network would show
+                                   (quote SSIDs with spaces, as in a shell).
+                                   Lasts until the attempt is online or
+                                   has failed
+     wait-idle [TIMEOUT_MS]        until no connection attempt or list
+                                   update is pending and the loop is idle
+     snapshot [FILE.png]           render the window to a PNG
+     quit
+
+   Each command goes through the same handler as the widget it stands
+   for. A step lasts until its effect is on screen: at least one frame
+   painted and no stack transition running. One line per step goes to
+   --script-results (stdout by default):
+   line, command, milliseconds, ok|failed|timeout; a connect whose
+   attempt failed reports failed.
+   Any step that doesn't end in ok makes the exit status 1. */
+#define SCRIPT_WAIT_IDLE_DEFAULT_MS 30000
+
+typedef struct ScriptRun {
+    gchar  **lines;
+    guint    next_line;
+    FILE    *results;
+    gchar   *step;            // current command, for the results
+    guint    step_line;
+    gint64   step_start_us;
+    gint64   total_us;
+    guint    tick_id;
+    guint    idle_id;
+    guint    frames;
+    gboolean wait_idle;
+    gint64   wait_deadline_us;
+    gchar   *connect_ssid;        // the attempt a connect step waits for
+    guint    snapshots;
+    guint    failures;
+} ScriptRun;
+
+static gboolean script_next_step(gpointer user_data);
+
+static void script_free(WelcomeApp *app) {
+    ScriptRun *run = app->script;
+    if (!run) return;
+    if (run->tick_id) gtk_widget_remove_tick_callback(app->window, run->tick_id);
+    if (run->idle_id) g_source_remove(run->idle_id);
+    if (run->results && run->results != stdout) fclose(run->results);
+    g_strfreev(run->lines);
+    g_free(run->step);
+    g_free(run->connect_ssid);
+    g_clear_pointer(&app->script, g_free);
+}
+
+static void script_step_done(WelcomeApp *app, const char *status) {
+    ScriptRun *run = app->script;
+    gint64 elapsed_us = g_get_monotonic_time() - run->step_start_us;
+    run->total_us += elapsed_us;
+    if (g_strcmp0(status, "ok") != 0) run->failures++;
+    fprintf(run->results, "%u\t%s\t%.2f\t%s\n", run->step_line, run->step, elapsed_us / 1000.0, status);
+    fflush(run->results);
+    app_timeout_add(app, 0, script_next_step);
+}
+
+/* A connection attempt, a network UI update or the list refresh after a
+   scan is still pending */
+static gboolean script_network_busy(WelcomeApp *app) {
+    if (app->update_timeout_id > 0 || app->populate_timeout_id > 0) return TRUE;
+    GHashTableIter iter;
+    gpointer value;
+    g_hash_table_iter_init(&iter, app->activations);
+    while (g_hash_table_iter_next(&iter, NULL, &value)) {
+        WifiActivationState state = ((WifiActivation*) value)->state;
+        if (state == WIFI_ACTIVATION_STARTING || state == WIFI_ACTIVATION_CONNECTING) return TRUE;
+    }
+    return FALSE;
+}
+
+/* Runs once nothing with a higher priority is pending */
+static gboolean script_on_idle(gpointer user_data) {
+    WelcomeApp *app = (WelcomeApp*) user_data;
+    app->script->idle_id = 0;
+    script_step_done(app, "ok");
+    return G_SOURCE_REMOVE;
+}
+
+static gboolean script_tick(GtkWidget *widget, GdkFrameClock *clock, gpointer user_data) {
+    (void)widget; (void)clock;
+    WelcomeApp *app = (WelcomeApp*) user_data;
+    ScriptRun *run = app->script;
+
+    /* the first tick precedes the frame that shows the step */
+    if (++run->frames < 2 || gtk_stack_get_transition_running(GTK_STACK(app->content_stack))) {
+        return G_SOURCE_CONTINUE;
+    }
+    if (run->connect_ssid) {
+        /* An attempt always ends, at the latest by its own timeout; a
+           successful one is dropped from app->activations */
+        WifiActivation *act = reinterpret_cast<WifiActivation*>(g_hash_table_lookup(app->activations, run->connect_ssid));
+        if (act && (act->state == WIFI_ACTIVATION_STARTING || act->state == WIFI_ACTIVATION_CONNECTING)) {
+            return G_SOURCE_CONTINUE;
+        }
+        run->tick_id = 0;
+        script_step_done(app, act && act->state == WIFI_ACTIVATION_FAILED ? "failed" : "ok");
+        return G_SOURCE_REMOVE;
+    }
+    if (run->wait_idle) {
+        gboolean busy = script_network_busy(app);
+        if (busy && g_get_monotonic_time() < run->wait_deadline_us) return G_SOURCE_CONTINUE;
+        run->tick_id = 0;
+        if (busy) {
+            script_step_done(app, "timeout");
+        } else {
+            run->idle_id = g_idle_add_full(G_PRIORITY_LOW, script_on_idle, app, NULL);
+        }
+        return G_SOURCE_REMOVE;
+    }
+    run->tick_id = 0;
+    script_step_done(app, "ok");
+    return G_SOURCE_REMOVE;
+}
+
+static GtkWidget* find_theme_button(GtkWidget *widget, const char *theme_name) {
+    if (GTK_IS_BUTTON(widget) && g_strcmp0((const char*) g_object_get_data(G_OBJECT(widget), "theme-name"), theme_name) == 0) {
+        return widget;
+    }
+    for (GtkWidget *child = gtk_widget_get_first_child(widget); child; child = gtk_widget_get_next_sibling(child)) {
+        GtkWidget *found = find_theme_button(child, theme_name);
+        if (found) return found;
+    }
+    return NULL;
+}
+
+static NMAccessPoint* find_listed_ap(WelcomeApp *app, const gchar *ssid) {
+    guint n = g_list_model_get_n_items(G_LIST_MODEL(app->wifi_store));
+    for (guint i = 0; i < n; i++) {
+        NMAccessPoint *ap = NM_ACCESS_POINT(g_list_model_get_item(G_LIST_MODEL(app->wifi_store), i));
+        gchar *ap_ssid = ssid_from_bytes(nm_access_point_get_ssid(ap));
+        gboolean match = ssid_equal(ap_ssid, ssid);
+        g_free(ap_ssid);
+        if (match) return ap;
+        g_object_unref(ap);
+    }
+    return NULL;
+}
+
+static gboolean script_save_snapshot(WelcomeApp *app, const char *path) {
+    int width = gtk_widget_get_width(app->window);
+    int height = gtk_widget_get_height(app->window);
+    GdkPaintable *paintable = gtk_widget_paintable_new(app->window);
+    GtkSnapshot *snapshot = gtk_snapshot_new();
+    gdk_paintable_snapshot(paintable, GDK_SNAPSHOT(snapshot), width, height);
+    GskRenderNode *node = gtk_snapshot_free_to_node(snapshot);
+    g_object_unref(paintable);
+    if (!node) return FALSE;
+
+    graphene_rect_t bounds = GRAPHENE_RECT_INIT(0, 0, (float) width, (float) height);
+    GdkTexture *texture = gsk_renderer_render_texture(gtk_native_get_renderer(GTK_NATIVE(app->window)), node, &bounds);
+    gsk_render_node_unref(node);
+    gboolean saved = gdk_texture_save_to_png(texture, path);
+    g_object_unref(texture);
+    return saved;
+}
+
+/* Run one command; returns FALSE when it failed outright */
+static gboolean script_run_command(WelcomeApp *app, gchar **argv) {
+    ScriptRun *run = app->script;
+    const char *cmd = argv[0];
+    const char *arg = argv[1];
+
+    if (g_strcmp0(cmd, "next") == 0) {
+        on_next_clicked(NULL, app);
+    } else if (g_strcmp0(cmd, "back") == 0) {
+        on_back_clicked(NULL, app);
+    } else if (g_strcmp0(cmd, "select-theme") == 0) {
+        GtkWidget *page = gtk_stack_get_child_by_name(GTK_STACK(app->content_stack), "theme");
+        GtkWidget *button = page && arg ? find_theme_button(page, arg) : NULL;
+        if (!button) return FALSE;
+        on_theme_selected(GTK_BUTTON(button), app);
+    } else if (g_strcmp0(cmd, "wifi-refresh") == 0) {
+        on_wifi_refresh_clicked(NULL, app);
+    } else if (g_strcmp0(cmd, "connect") == 0) {
+        NMDeviceWifi *wifi_dev = app->nm_client ? get_primary_wifi_device(app->nm_client) : NULL;
+        NMAccessPoint *ap = wifi_dev && arg ? find_listed_ap(app, arg) : NULL;
+        if (!ap) return FALSE;
+        wifi_connect_ap(app, wifi_dev, ap, arg, argv[2]);  // argv[2] is NULL without a password
+        g_object_unref(ap);
+        /* No attempt without a password for a new secured network: the
+           prompt is on screen and that is the step's effect */
+        if (g_hash_table_contains(app->activations, arg)) run->connect_ssid = g_strdup(arg);
+    } else if (g_strcmp0(cmd, "wait-idle") == 0) {
+        gint64 timeout_ms = arg ? g_ascii_strtoll(arg, NULL, 10) : SCRIPT_WAIT_IDLE_DEFAULT_MS;
+        run->wait_idle = TRUE;
+        run->wait_deadline_us = g_get_monotonic_time() + timeout_ms * 1000;
+    } else if (g_strcmp0(cmd, "snapshot") == 0) {
+        gchar *path = arg ? g_strdup(arg) : g_strdup_printf("script-snapshot-%u.png", ++run->snapshots);
+        gboolean saved = script_save_snapshot(app, path);
+        g_free(path);
+        if (!saved) return FALSE;
+    } else {
+        return FALSE;
+    }
+    return TRUE;
+}
+
+static void script_finish(WelcomeApp *app) {
+    ScriptRun *run = app->script;
+    fprintf(run->results, "#\ttotal\t%.2f\t%u failed\n", run->total_us / 1000.0, run->failures);
+    if (run->failures > 0) script_exit_status = 1;
+    script_free(app);
+    gtk_window_destroy(GTK_WINDOW(app->window));
+}
+
+static gboolean script_next_step(gpointer user_data) {
+    WelcomeApp *app = (WelcomeApp*) user_data;
+    ScriptRun *run = app->script;
+
+    /* skip blank lines and comments */
+    gchar *line = NULL;
+    while (run->lines[run->next_line]) {
+        line = g_strstrip(run->lines[run->next_line++]);
+        if (*line && *line != '#') break;
+        line = NULL;
+    }
+    if (!line || g_strcmp0(line, "quit") == 0) {
+        script_finish(app);
+        return G_SOURCE_REMOVE;
+    }
+
+    g_free(run->step);
+    run->step = g_strdup(line);
+    run->step_line = run->next_line;
+    run->step_start_us = g_get_monotonic_time();
+    run->frames = 0;
+    run->wait_idle = FALSE;
+    g_clear_pointer(&run->connect_ssid, g_free);
+
+    gchar **argv = NULL;
+    gboolean ok = g_shell_parse_argv(line, NULL, &argv, NULL) && script_run_command(app, argv);
+    g_strfreev(argv);
+
+    if (!ok) {
+        log_warning(LOG_UI, "Script line %u failed: %s", run->step_line, run->step);
+        script_step_done(app, "failed");
+        return G_SOURCE_REMOVE;
+    }
+    run->tick_id = gtk_widget_add_tick_callback(app->window, script_tick, app, NULL);
+    return G_SOURCE_REMOVE;
+}
+
+static gboolean script_start(gpointer user_data) {
+    WelcomeApp *app = (WelcomeApp*) user_data;
+    gchar *contents = NULL;
+    GError *error = NULL;
+    if (!g_file_get_contents(opt_script, &contents, NULL, &error)) {
+        log_warning(LOG_UI, "Cannot read script: %s", error->message);
+        g_error_free(error);
+        script_exit_status = 2;
+        gtk_window_destroy(GTK_WINDOW(app->window));
+        return G_SOURCE_REMOVE;
+    }
+
+    FILE *results = stdout;
+    if (opt_script_results && !(results = fopen(opt_script_results, "w"))) {
+        log_warning(LOG_UI, "Cannot write %s: %s", opt_script_results, g_strerror(errno));
+        results = stdout;
+    }
+
+    app->script = g_new0(ScriptRun, 1);
+    app->script->lines = g_strsplit(contents, "\n", -1);
+    app->script->results = results;
+    g_free(contents);
+
+    fprintf(results, "# line\tcommand\tms\tstatus\n");
+    script_next_step(app);
+    return G_SOURCE_REMOVE;
+}
+
+/* ---------- Startup tasks ---------- */
+
+/* Work activate() used to do in sequence, as a task graph started from
+   GApplication::startup:
+
+     theme      main    read gtk-theme-name
+     textures   thread  decode the page images, themed logo   <- theme
+     fonts      thread  match and load the faces the CSS uses
+     nm-client  async   nm_client_new_async()
+     pages      (milestone, completed at the end of activate)
+     network    main    fill the network page                 <- nm-client, pages
+     adopt-fonts main   make the warmed font map the default  <- fonts, pages
+
+   Image decoding, font loading and the NM handshake overlap with widget
+   construction, and activate() never waits for any of them. Pictures
+   built before "textures" is done start empty and get their texture from
+   the "texture-swap" task. If "fonts" is done by the end of activate the
+   window is presented with the warm font map, otherwise it switches over
+   when the worker is done. The
+   graph holds the "interactive" startup milestone until the
+   network page is populated, and is released once every task is done. */
+
+static TaskGraph *startup_graph = NULL;
+
+static const char *startup_texture_paths[] = {
+    "/org/elysiaos/welcome/light.png",
+    "/org/elysiaos/welcome/dark.png",
+    "/org/elysiaos/welcome/updater.png",
+    "/org/elysiaos/welcome/settings.png",
+    "/org/elysiaos/welcome/store.png",
+};
+
+/* The graph is only for the first window; later activations and a graph
+   cancelled by an early close fall back to doing the work inline */
+static gboolean startup_graph_usable(void) {
+    return startup_graph && !g_cancellable_is_cancelled(startup_graph->cancellable);
+}
+
+static gpointer startup_detect_theme(TaskNode *task, gpointer user_data) {
+    (void)task; (void)user_data;
+    gchar *theme = get_current_gtk_theme();
+    gboolean dark = g_strcmp0(theme, "ElysiaOS-HoC") == 0;
+    g_free(theme);
+    return GINT_TO_POINTER(dark);
+}
+
+static void startup_decode_texture(GHashTable *decoded, const char *resource_path, gboolean reduce) {
+    /* gdk_texture_new_from_bytes() is documented as threadsafe */
+    GBytes *bytes = g_resources_lookup_data(resource_path, G_RESOURCE_LOOKUP_FLAGS_NONE, NULL);
+    if (!bytes) return;
+    GdkTexture *texture = gdk_texture_new_from_bytes(bytes, NULL);
+    g_bytes_unref(bytes);
+    if (texture && reduce) {
+        GdkTexture *reduced = render_quality_reduce_texture(texture);
+        g_object_unref(texture);
+        texture = reduced;
+    }
+    if (texture) g_hash_table_insert(decoded, (gpointer) resource_path, texture);
+}
+
+/* Worker thread: returns resource path -> GdkTexture. user_data says
+   whether WELCOME_RENDER_QUALITY asked for reduced textures from the start. */
+static gpointer startup_decode_textures(TaskNode *task, gpointer user_data) {
+    gboolean reduce = GPOINTER_TO_INT(user_data);
+    gboolean dark = GPOINTER_TO_INT(task->inputs[0]);
+    GHashTable *decoded = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, g_object_unref);
+    startup_decode_texture(decoded, dark ? "/org/elysiaos/welcome/elyoslogo1.png" : "/org/elysiaos/welcome/elyoslogo2.png", reduce);
+    for (guint i = 0; i < G_N_ELEMENTS(startup_texture_paths); i++) {
+        startup_decode_texture(decoded, startup_texture_paths[i], reduce);
+    }
+    return decoded;
+}
+
+/* Every face the CSS asks for: ElysiaOSNew12 at each size, bold, semibold
+   and italic */
+static const char *startup_font_faces[] = {
+    "ElysiaOSNew12 10px", "ElysiaOSNew12 11px", "ElysiaOSNew12 14px",
+    "ElysiaOSNew12 18px", "ElysiaOSNew12 28px", "ElysiaOSNew12 34px",
+    "ElysiaOSNew12 Bold 28px", "ElysiaOSNew12 Semi-Bold 14px", "ElysiaOSNew12 Italic 14px",
+};
+
+/* Worker thread: a font map of its own, warmed up by laying out every
+   string of the current translation in each face. That runs fontconfig
+   initialisation, matching, fallback discovery for ja/zh and font file
+   loading here instead of in the first frame. A font map may move between
+   threads as long as only one uses it at a time; the main thread adopts
+   this one in startup_adopt_fonts(). */
+static gpointer startup_warm_fonts(TaskNode *task, gpointer user_data) {
+    (void)task;
+    const Translations *tr = (const Translations*) user_data;
+    PangoFontMap *font_map = pango_cairo_font_map_new();
+    PangoContext *context = pango_font_map_create_context(font_map);
+    PangoLayout *layout = pango_layout_new(context);
+
+    /* printable ASCII for SSIDs, then every translated string (Translations
+       is nothing but const char* fields) */
+    GString *text = g_string_new(NULL);
+    for (char c = ' '; c <= '~'; c++) g_string_append_c(text, c);
+    const char * const *strings = (const char * const *) tr;
+    for (gsize i = 0; i < sizeof(Translations) / sizeof(const char*); i++) {
+        g_string_append_c(text, '\n');
+        g_string_append(text, strings[i]);
+    }
+    pango_layout_set_text(layout, text->str, (int) text->len);
+
+    for (guint i = 0; i < G_N_ELEMENTS(startup_font_faces); i++) {
+        PangoFontDescription *desc = pango_font_description_from_string(startup_font_faces[i]);
+        pango_layout_set_font_description(layout, desc);
+        pango_layout_get_pixel_size(layout, NULL, NULL);  // itemize, pick fallbacks, shape
+        pango_font_description_free(desc);
+    }
+
+    g_string_free(text, TRUE);
+    g_object_unref(layout);
+    g_object_unref(context);
+    return font_map;
+}
+
+/* Main thread, once "fonts" and "pages" are done: make the warmed font map
+   the default for everything measured from now on; the window is pointed
+   at it too, since its pages already created Pango contexts from the cold
+   one. user_data is the window's WelcomeApp. */
+static gpointer startup_adopt_fonts(TaskNode *task, gpointer user_data) {
+    WelcomeApp *app = (WelcomeApp*) user_data;
+    PangoFontMap *font_map = (PangoFontMap*) task_graph_take(task->graph, "fonts");
+    if (!font_map) return NULL;
+    pango_cairo_font_map_set_default(PANGO_CAIRO_FONT_MAP(font_map));
+    gtk_widget_set_font_map(app->window, font_map);
+    g_object_unref(font_map);
+    return NULL;
+}
+
+/* Never waits: until "textures" is done, defer_prefetched_texture() covers it */
+static GdkTexture* take_prefetched_texture(const char *resource_path) {
+    if (!startup_graph_usable()) return NULL;
+    GHashTable *decoded = (GHashTable*) task_graph_result(startup_graph, "textures");
+    GdkTexture *texture = decoded ? (GdkTexture*) g_hash_table_lookup(decoded, resource_path) : NULL;
+    return texture ? (GdkTexture*) g_object_ref(texture) : NULL;
+}
+
+/* Widgets waiting for "textures", each with its resource path under
+   "welcome-pending-texture" */
+static GPtrArray *startup_texture_waiters = NULL;
+
+static gpointer startup_swap_textures(TaskNode *task, gpointer user_data) {
+    (void)task; (void)user_data;
+    PerfSpan span = perf_span_begin("startup_swap_textures");
+    guint n = startup_texture_waiters ? startup_texture_waiters->len : 0;
+    for (guint i = 0; i < n; i++) {
+        GtkWidget *widget = GTK_WIDGET(g_ptr_array_index(startup_texture_waiters, i));
+        set_resource_texture(widget, (const char*) g_object_get_data(G_OBJECT(widget), "welcome-pending-texture"));
+        g_object_set_data(G_OBJECT(widget), "welcome-pending-texture", NULL);
+    }
+    g_clear_pointer(&startup_texture_waiters, g_ptr_array_unref);
+    perf_span_end_with(&span, "%u widgets", n);
+    return NULL;
+}
+
+/* If the startup worker is still decoding, leave widget empty and give it
+   the texture for resource_path once "textures" is done */
+static gboolean defer_prefetched_texture(GtkWidget *widget, const char *resource_path) {
+    if (!startup_graph_usable()) return FALSE;
+    TaskNode *task = task_graph_find(startup_graph, "textures");
+    if (!task || task->state == TASK_DONE) return FALSE;
+
+    if (!startup_texture_waiters) startup_texture_waiters = g_ptr_array_new_with_free_func(g_object_unref);
+    g_object_set_data_full(G_OBJECT(widget), "welcome-pending-texture", g_strdup(resource_path), g_free);
+    g_ptr_array_add(startup_texture_waiters, g_object_ref(widget));
+    if (!task_graph_find(startup_graph, "texture-swap")) {
+        task_graph_add(startup_graph, "texture-swap", TASK_ON_MAIN, startup_swap_textures, NULL, NULL, "textures", NULL);
+    }
+    return TRUE;
+}
+
+static void on_startup_nm_client_ready(GObject *source, GAsyncResult *result, gpointer user_data) {
+    (void)source;
+    TaskGraph *graph = (TaskGraph*) user_data;
+    GError *error = NULL;
+    NMClient *client = nm_client_new_finish(result, &error);
+    if (!client && !g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+        log_warning(LOG_NETWORK, "NetworkManager client: %s", error->message);
+    }
+    g_clear_error(&error);
+    task_graph_complete(graph, "nm-client", client);
+    task_graph_unref(graph);
+}
+
+static gpointer startup_nm_client(TaskNode *task, gpointer user_data) {
+    (void)user_data;
+    nm_client_new_async(task->graph->cancellable, on_startup_nm_client_ready, task_graph_ref(task->graph));
+    return NULL;
+}
+
+static gpointer startup_network(TaskNode *task, gpointer user_data) {
+    network_page_set_client((WelcomeApp*) user_data, (NMClient*) task_graph_take(task->graph, "nm-client"));
+    return NULL;
+}
+
+static gboolean release_startup_graph(gpointer user_data) {
+    (void)user_data;
+    g_clear_pointer(&startup_graph, task_graph_unref);
+    return G_SOURCE_REMOVE;
+}
+
+static void on_startup_graph_finished(TaskGraph *graph, gpointer user_data) {
+    (void)graph; (void)user_data;
+    startup_release();
+    /* a cancelled graph never ran "texture-swap" */
+    g_clear_pointer(&startup_texture_waiters, g_ptr_array_unref);
+    /* leftover results (textures nobody used) go with the graph */
+    g_idle_add(release_startup_graph, NULL);
+}
+
+static void on_startup(GApplication *application, gpointer user_data) {
+    (void)application; (void)user_data;
+    register_bundled_icons();
+    render_quality_init();
+    startup_hold();
+    startup_graph = task_graph_new(on_startup_graph_finished, NULL);
+    task_graph_add(startup_graph, "theme", TASK_ON_MAIN, startup_detect_theme, NULL, NULL, NULL);
+    task_graph_add(startup_graph, "textures", TASK_ON_THREAD, startup_decode_textures,
+                   GINT_TO_POINTER(render_quality_reduced_textures()),
+                   (GDestroyNotify) g_hash_table_unref, "theme", NULL);
+    task_graph_add(startup_graph, "fonts", TASK_ON_THREAD, startup_warm_fonts, (gpointer) get_translations(),
+                   g_object_unref, NULL);
+    task_graph_add(startup_graph, "nm-client", TASK_ASYNC, startup_nm_client, NULL, g_object_unref, NULL);
+    task_graph_add(startup_graph, "pages", TASK_ASYNC, NULL, NULL, NULL, NULL);
+    task_graph_start(startup_graph);
+}
+
+/* Called by activate() once the pages exist */
+static void startup_pages_ready(WelcomeApp *app) {
+    if (startup_graph_usable() && !task_graph_find(startup_graph, "network")) {
+        task_graph_add(startup_graph, "network", TASK_ON_MAIN, startup_network, app, NULL, "nm-client", "pages", NULL);
+        task_graph_add(startup_graph, "adopt-fonts", TASK_ON_MAIN, startup_adopt_fonts, app, NULL, "fonts", "pages", NULL);
+        task_graph_complete(startup_graph, "pages", NULL);
+        return;
+    }
+    PerfSpan span = perf_span_begin("nm_client_new");
+    NMClient *client = nm_client_new(NULL, NULL);
+    perf_span_end(&span);
+    network_page_set_client(app, client);
+}
+
+/* Drop startup work still aimed at a window that is going away */
+static void startup_window_closed(WelcomeApp *app) {
+    TaskNode *network = startup_graph ? task_graph_find(startup_graph, "network") : NULL;
+    if (network && network->user_data == app) task_graph_cancel(startup_graph);
+}
+
+/* ---------- Lifecycle ---------- */
+
+/* Nobody is looking at the window: not focused, minimised, or suspended by
+   the compositor (e.g. left on another Hyprland workspace) */
+static gboolean window_is_backgrounded(WelcomeApp *app) {
+    if (!gtk_widget_get_mapped(app->window)) return TRUE;
+    if (!gtk_window_is_active(GTK_WINDOW(app->window))) return TRUE;
+    if (gtk_window_is_suspended(GTK_WINDOW(app->window))) return TRUE;
+
+    GdkSurface *surface = gtk_native_get_surface(GTK_NATIVE(app->window));
+    if (surface && GDK_IS_TOPLEVEL(surface)) {
+        GdkToplevelState state = gdk_toplevel_get_state(GDK_TOPLEVEL(surface));
+        if (state & (GDK_TOPLEVEL_STATE_MINIMIZED | GDK_TOPLEVEL_STATE_SUSPENDED)) return TRUE;
+    }
+    return FALSE;
+}
+
+static void update_background_activity(WelcomeApp *app) {
+    gboolean paused = window_is_backgrounded(app);
+    if (paused == app->background_paused) return;
+    app->background_paused = paused;
+
+    if (paused) {
+        log_info(LOG_UI, "Window backgrounded, pausing theme poll and list updates");
+        if (app->theme_check_id > 0) {
+            g_source_remove(app->theme_check_id);
+            app->theme_check_id = 0;
+        }
+        return;
+    }
+
+    /* Replay only the final state of whatever happened meanwhile */
+    log_info(LOG_UI, "Window foregrounded, resuming background work");
+    detect_and_apply_theme(app);
+    if (app->theme_check_id == 0) {
+        app->theme_check_id = app_timeout_add(app, 2000, theme_check_timeout);
+    }
+    if (app->pending_network_refresh && app->network_page_visible) {
+        reconcile_network_page(app);
+    }
+}
+
+static void on_visible_page_changed(GObject *object, GParamSpec *pspec, gpointer user_data) {
+    (void)object; (void)pspec;
+    WelcomeApp *app = (WelcomeApp*) user_data;
+    const gchar *name = gtk_stack_get_visible_child_name(GTK_STACK(app->content_stack));
+    /* a page hidden during a theme switch catches up as it comes in */
+    GtkWidget *visible_page = gtk_stack_get_visible_child(GTK_STACK(app->content_stack));
+    if (visible_page) apply_theme_scope(app, visible_page, THEME_DARK_CLASS);
+    if (census_enabled) {
+        gchar *label = g_strdup_printf("page %s", name);
+        census_checkpoint(label);
+        g_free(label);
+    }
+    gboolean visible = g_strcmp0(name, "network") == 0;
+    if (visible == app->network_page_visible) return;
+    app->network_page_visible = visible;
+
+    if (visible) {
+        attach_network_subscriptions(app);
+        reconcile_network_page(app);
+    } else {
+        detach_network_subscriptions(app);
+    }
+}
+
+static void on_window_activity_changed(GObject *object, GParamSpec *pspec, gpointer user_data) {
+    (void)object; (void)pspec;
+    update_background_activity((WelcomeApp*) user_data);
+}
+
+static void on_window_realize(GtkWidget *window, gpointer user_data) {
+    GdkSurface *surface = gtk_native_get_surface(GTK_NATIVE(window));
+    if (surface && GDK_IS_TOPLEVEL(surface)) {
+        g_signal_connect(surface, "notify::state", G_CALLBACK(on_window_activity_changed), user_data);
+    }
+    hud_watch_frame_clock((WelcomeApp*) user_data);
+}
+
+static gint compare_gint64(gconstpointer a, gconstpointer b) {
+    gint64 x = *(const gint64*)a, y = *(const gint64*)b;
+    return (x > y) - (x < y);
+}
+
+static void on_window_destroy(GtkWidget *w, gpointer user_data) {
+    WelcomeApp *app = (WelcomeApp*) user_data;
+    if (!app) return;
     
-    if (app->nm_client) g_object_unref(app->nm_client);
+    /* Stop following connection attempts before the client goes away;
+       first, so they remove their own timers */
+    if (app->activations) {
+        g_hash_table_destroy(app->activations);
+        app->activations = NULL;
+    }
+
+    /* Cancel NM requests, subprocess waits and timers in one go */
+    app_cancel_operations(app);
+    startup_window_closed(app);
+
+    GdkSurface *surface = gtk_native_get_surface(GTK_NATIVE(app->window));
+    if (surface) g_signal_handlers_disconnect_by_data(surface, app);
+    if (app->activation_times_ms) {
+        guint n = app->activation_times_ms->len;
+        if (n > 0 || app->activation_failures > 0) {
+            g_array_sort(app->activation_times_ms, compare_gint64);
+            log_info(LOG_PERF, "Wi-Fi activations: %u online, %u failed, median time-to-IP %" G_GINT64_FORMAT " ms",
+                    n, app->activation_failures,
+                    n > 0 ? g_array_index(app->activation_times_ms, gint64, n / 2) : (gint64)0);
+        }
+        g_array_unref(app->activation_times_ms);
+    }
+    latency_detach(app->window);
+    render_quality_detach();
+    render_bench_free(app);
+    script_free(app);
+
+    /* Widgets outlive this handler: don't let them call back into a freed app */
+    g_signal_handlers_disconnect_by_data(app->content_stack, app);
+    g_signal_handlers_disconnect_by_data(app->window, app);
+
+    if (app->nm_client) {
+        /* NM keeps its own references to the client and devices */
+        detach_network_subscriptions(app);
+        autoconnect_stop_watching(app);
+        g_object_unref(app->nm_client);
+    }
+    g_clear_pointer(&app->subscribed_devices, g_ptr_array_unref);
+    hud_free(app);
+    restyle_timing_free(app);
+    g_clear_pointer(&app->census_baseline, g_hash_table_unref);
+    if (app->memory_report_signal_id) g_source_remove(app->memory_report_signal_id);
+    g_clear_object(&app->cancellable);
+    g_clear_pointer(&app->timers, g_hash_table_unref);
+    wifi_store_clear(app);
+    g_clear_object(&app->wifi_store);
+    g_clear_object(&app->wifi_filter);
+    g_clear_object(&app->wifi_sorter);
+    g_clear_pointer(&app->wifi_query, g_free);
+    g_clear_pointer(&app->autoconnect_ssid, g_free);
     if (app->page_dots) g_ptr_array_unref(app->page_dots);
     if (app->theme_provider) g_object_unref(app->theme_provider);
     g_clear_pointer(&app->selected_theme, g_free);
@@ -1832,11 +4089,22 @@ static void on_window_destroy(GtkWidget *w, gpointer user_data) {
     (void)w;
 }
 
+/* Add a page and remember how long it took to build since *build_start,
+   for --render-bench; *build_start moves on to the next page */
+static void add_stack_page(WelcomeApp *app, GtkWidget *page, const char *name, gint64 *build_start) {
+    gint64 now = g_get_monotonic_time();
+    g_object_set_data(G_OBJECT(page), "welcome-build-us", GSIZE_TO_POINTER((gsize) (now - *build_start)));
+    init_theme_scope(app, page, THEME_DARK_CLASS, name);
+    gtk_stack_add_named(GTK_STACK(app->content_stack), page, name);
+    *build_start = g_get_monotonic_time();
+}
+
 static void activate(GtkApplication *app_gtk, gpointer user_data) {
     const Translations* tr = get_translations();
     
     (void)user_data;
 
+    PerfSpan span = perf_span_begin("activate");
     WelcomeApp *app = g_new0(WelcomeApp, 1);
     app->current_page = 0;
     app->page_dots = g_ptr_array_new();
@@ -1847,6 +4115,11 @@ static void activate(GtkApplication *app_gtk, gpointer user_data) {
     app->networking_enabled = FALSE;
     app->has_ethernet_connection = FALSE;
     app->update_timeout_id = 0;
+    app->activations = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, wifi_activation_release);
+    app->activation_times_ms = g_array_new(FALSE, FALSE, sizeof(gint64));
+    app->cancellable = g_cancellable_new();
+    app->timers = g_hash_table_new(NULL, NULL);
+    app->subscribed_devices = g_ptr_array_new_with_free_func(g_object_unref);
 
     setup_css(app);
 
@@ -1854,12 +4127,15 @@ static void activate(GtkApplication *app_gtk, gpointer user_data) {
     detect_and_apply_theme(app);
     
     /* Start theme monitoring */
-    app->theme_check_id = g_timeout_add(2000, theme_check_timeout, app);
+    app->theme_check_id = app_timeout_add(app, 2000, theme_check_timeout);
 
     app->window = gtk_application_window_new(app_gtk);
     gtk_window_set_title(GTK_WINDOW(app->window), tr->welcome_subtitle);
     gtk_window_set_default_size(GTK_WINDOW(app->window), 900, 700);
     gtk_window_set_resizable(GTK_WINDOW(app->window), FALSE);
+    init_theme_scope(app, app->window, THEME_DARK_WINDOW_CLASS, "window");
+    latency_attach(app->window);
+    startup_attach(app->window);
 
     app->main_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 0);
     gtk_window_set_child(GTK_WINDOW(app->window), app->main_box);
@@ -1868,6 +4144,7 @@ static void activate(GtkApplication *app_gtk, gpointer user_data) {
     app->page_indicators = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 0);
     gtk_widget_set_halign(app->page_indicators, GTK_ALIGN_CENTER);
     gtk_widget_add_css_class(app->page_indicators, "page-indicators");
+    init_theme_scope(app, app->page_indicators, THEME_DARK_CLASS, "page-indicators");
 
     for (int i = 0; i < 8; ++i) {
         GtkWidget *dot = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 0);
@@ -1886,21 +4163,22 @@ static void activate(GtkApplication *app_gtk, gpointer user_data) {
 
     /* Content stack */
     app->content_stack = gtk_stack_new();
-    gtk_stack_set_transition_type(GTK_STACK(app->content_stack), GTK_STACK_TRANSITION_TYPE_SLIDE_LEFT_RIGHT);
-    gtk_stack_set_transition_duration(GTK_STACK(app->content_stack), 200);
+    render_quality_attach(GTK_STACK(app->content_stack), on_render_quality_changed, app);
     gtk_widget_set_hexpand(app->content_stack, TRUE);
     gtk_widget_set_vexpand(app->content_stack, TRUE);
 
-    gtk_stack_add_named(GTK_STACK(app->content_stack), create_welcome_page(app), "welcome");
-    gtk_stack_add_named(GTK_STACK(app->content_stack), create_theme_page(app), "theme");
-    gtk_stack_add_named(GTK_STACK(app->content_stack), create_network_page(app), "network");
-    gtk_stack_add_named(GTK_STACK(app->content_stack), create_keybinds_page(), "keybinds");
-    gtk_stack_add_named(GTK_STACK(app->content_stack), create_updater_page(), "updater");
-    gtk_stack_add_named(GTK_STACK(app->content_stack), create_settings_page(), "settings");
-    gtk_stack_add_named(GTK_STACK(app->content_stack), create_store_page(), "store");
-    gtk_stack_add_named(GTK_STACK(app->content_stack), create_complete_page(app), "complete");
+    gint64 build_start = g_get_monotonic_time();
+    add_stack_page(app, create_welcome_page(app), "welcome", &build_start);
+    add_stack_page(app, create_theme_page(app), "theme", &build_start);
+    add_stack_page(app, create_network_page(app), "network", &build_start);
+    add_stack_page(app, create_keybinds_page(app), "keybinds", &build_start);
+    add_stack_page(app, create_updater_page(), "updater", &build_start);
+    add_stack_page(app, create_settings_page(), "settings", &build_start);
+    add_stack_page(app, create_store_page(), "store", &build_start);
+    add_stack_page(app, create_complete_page(app), "complete", &build_start);
 
     gtk_overlay_set_child(GTK_OVERLAY(overlay), app->content_stack);
+    hud_attach(app, overlay);
 
     /* Back arrow on the left */
     app->back_arrow = make_icon_button("go-previous-symbolic", 16);
@@ -1938,21 +4216,71 @@ static void activate(GtkApplication *app_gtk, gpointer user_data) {
     gtk_stack_set_visible_child_name(GTK_STACK(app->content_stack), "welcome");
     update_navigation(app);
 
+    /* NMClient arrives through the startup graph, or inline on later windows */
+    startup_pages_ready(app);
+
+    /* Attach NM subscriptions only while the network page is shown */
+    g_signal_connect(app->content_stack, "notify::visible-child-name", G_CALLBACK(on_visible_page_changed), app);
+
     g_signal_connect(app->window, "destroy", G_CALLBACK(on_window_destroy), app);
 
+    /* Power-aware mode: follow focus, minimise and compositor suspension */
+    g_signal_connect(app->window, "notify::is-active", G_CALLBACK(on_window_activity_changed), app);
+    g_signal_connect(app->window, "notify::suspended", G_CALLBACK(on_window_activity_changed), app);
+    g_signal_connect(app->window, "realize", G_CALLBACK(on_window_realize), app);
+
+    app->memory_report_signal_id = g_unix_signal_add(SIGUSR1, on_memory_report_signal, app);
+    if (opt_memory_report) app_timeout_add(app, 1500, memory_report_timeout);
+    /* let the first scan results arrive before churning the list */
+    if (opt_census_rescans > 0) app_timeout_add(app, 2500, census_rescans_start);
+    /* after the first frames, so fonts and icons are already loaded */
+    if (opt_render_bench) app_timeout_add(app, 1000, render_bench_start);
+    if (opt_script) app_timeout_add(app, 1000, script_start);
+
     gtk_window_present(GTK_WINDOW(app->window));
+    perf_span_end(&span);
 }
 
 /* ---------- main ---------- */
 
+static gint on_handle_local_options(GApplication *application, GVariantDict *options, gpointer user_data) {
+    (void)application; (void)user_data;
+    opt_memory_report = g_variant_dict_contains(options, "memory-report");
+    g_variant_dict_lookup(options, "census-rescans", "i", &opt_census_rescans);
+    census_init(opt_census_rescans > 0);
+    g_variant_dict_lookup(options, "render-bench-png", "^ay", &opt_render_bench_png);
+    opt_render_bench = g_variant_dict_contains(options, "render-bench") || opt_render_bench_png != NULL;
+    g_variant_dict_lookup(options, "script", "^ay", &opt_script);
+    g_variant_dict_lookup(options, "script-results", "^ay", &opt_script_results);
+    return -1;  // carry on with the default activation
+}
+
 int main(int argc, char *argv[]) {
+    log_init();
+    perf_init();
+
     // Register resources
     GResource *resource = resources_get_resource();
     g_resources_register(resource);
     
     GtkApplication *app = gtk_application_new("org.elysiaos.welcome", G_APPLICATION_DEFAULT_FLAGS);
+    g_application_add_main_option(G_APPLICATION(app), "memory-report", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_NONE,
+                                  "Print a memory breakdown once the window is up, then exit", NULL);
+    g_application_add_main_option(G_APPLICATION(app), "census-rescans", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_INT,
+                                  "Rebuild the Wi-Fi list N times and fail if objects accumulate", "N");
+    g_application_add_main_option(G_APPLICATION(app), "render-bench", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_NONE,
+                                  "Time layout, snapshot and render of every page and transition, then exit", NULL);
+    g_application_add_main_option(G_APPLICATION(app), "render-bench-png", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_FILENAME,
+                                  "With --render-bench, also save every page as PNG into DIR", "DIR");
+    g_application_add_main_option(G_APPLICATION(app), "script", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_FILENAME,
+                                  "Replay a walkthrough from FILE and time each step", "FILE");
+    g_application_add_main_option(G_APPLICATION(app), "script-results", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_FILENAME,
+                                  "Write --script step timings to FILE instead of stdout", "FILE");
+    g_signal_connect(app, "handle-local-options", G_CALLBACK(on_handle_local_options), NULL);
+    g_signal_connect(app, "startup", G_CALLBACK(on_startup), NULL);
     g_signal_connect(app, "activate", G_CALLBACK(activate), NULL);
     int status = g_application_run(G_APPLICATION(app), argc, argv);
     g_object_unref(app);
-    return status;
+    if (status != 0) return status;
+    return census_exit_status != 0 ? census_exit_status : script_exit_status;
 }
\ No newline at end of file
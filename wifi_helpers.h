@@ -0,0 +1,70 @@
+#ifndef WIFI_HELPERS_H
+#define WIFI_HELPERS_H
+
+#include <NetworkManager.h>
+
+// NetworkManager helpers that run per access point or per NM event.
+// They don't touch any UI state, so bench/microbench.cpp links them too.
+
+static inline gchar* ssid_from_bytes(GBytes *ssid_bytes) {
+    if (!ssid_bytes) return NULL;
+    gsize len = 0;
+    const guint8 *data = reinterpret_cast<const guint8*>(g_bytes_get_data(ssid_bytes, &len));
+    if (!data || len == 0) return NULL;
+    return g_strndup(reinterpret_cast<const char*>(data), len);
+}
+
+static inline gboolean ap_is_secured(NMAccessPoint *ap) {
+    if (!ap) return FALSE;
+    return (nm_access_point_get_flags(ap)     != NM_802_11_AP_FLAGS_NONE) ||
+           (nm_access_point_get_wpa_flags(ap) != NM_802_11_AP_SEC_NONE)   ||
+           (nm_access_point_get_rsn_flags(ap) != NM_802_11_AP_SEC_NONE);
+}
+
+static inline gboolean ssid_equal(const gchar *a, const gchar *b) {
+    if (!a || !b) return FALSE;
+    return g_strcmp0(a, b) == 0;
+}
+
+// First Wi-Fi profile in connections (NMConnection*) for ssid, not referenced
+static inline NMConnection* find_connection_for_ssid(const GPtrArray *connections, const gchar *ssid) {
+    if (!connections || !ssid) return NULL;
+
+    for (guint i = 0; i < connections->len; ++i) {
+        NMConnection *c = reinterpret_cast<NMConnection*>(g_ptr_array_index(connections, i));
+        if (!c) continue;
+        NMSettingWireless *s_wifi = nm_connection_get_setting_wireless(c);
+        if (!s_wifi) continue;
+        GBytes *bytes = nm_setting_wireless_get_ssid(s_wifi);
+        gchar *conn_ssid = ssid_from_bytes(bytes);
+        gboolean match = ssid_equal(conn_ssid, ssid);
+        g_free(conn_ssid);
+        if (match) return c;
+    }
+    return NULL;
+}
+
+// Search saved remote (system) connections for matching SSID
+// Returns a referenced NMRemoteConnection* (or NULL). Caller must g_object_unref()
+static inline NMRemoteConnection* find_saved_connection_for_ssid(NMClient *client, const gchar *ssid) {
+    if (!client || !ssid) return NULL;
+    NMConnection *c = find_connection_for_ssid(nm_client_get_connections(client), ssid);
+    return c ? NM_REMOTE_CONNECTION(g_object_ref(c)) : NULL;
+}
+
+static inline gboolean check_ethernet_connection(NMClient *client) {
+    if (!client) return FALSE;
+
+    const GPtrArray *devices = nm_client_get_devices(client);
+    if (!devices) return FALSE;
+
+    for (guint i = 0; i < devices->len; ++i) {
+        NMDevice *dev = reinterpret_cast<NMDevice*>(g_ptr_array_index(devices, i));
+        if (NM_IS_DEVICE_ETHERNET(dev) && nm_device_get_state(dev) == NM_DEVICE_STATE_ACTIVATED) {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+#endif // WIFI_HELPERS_H